@@ -0,0 +1,114 @@
+#include <malloc.h>
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "../include/allocator/header.h"
+#include "../include/allocator/operations.h"
+
+static size_t align_up(const size_t size)
+{
+    return (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+}
+
+static int is_last_block(const vector_arena *const arena, const void *address)
+{
+    return address == arena->start_address + arena->last_block;
+}
+
+static void *arena_allocate(void *context, size_t size)
+{
+    vector_arena *arena = context;
+    size_t aligned_size = align_up(size);
+
+    if (aligned_size > arena->capacity - arena->used)
+    {
+        return NULL;
+    }
+
+    arena->last_block = arena->used;
+    arena->used += aligned_size;
+
+    return arena->start_address + arena->last_block;
+}
+
+static void *arena_reallocate(void *context, void *address, size_t old_size, size_t new_size)
+{
+    vector_arena *arena = context;
+
+    // the newest block can grow or shrink where it is
+    if (is_last_block(arena, address))
+    {
+        size_t aligned_size = align_up(new_size);
+
+        if (aligned_size > arena->capacity - arena->last_block)
+        {
+            return NULL;
+        }
+
+        arena->used = arena->last_block + aligned_size;
+        return address;
+    }
+
+    if (new_size <= old_size)
+    {
+        return address;
+    }
+
+    void *new_address = arena_allocate(arena, new_size);
+
+    if (new_address != NULL)
+    {
+        memcpy(new_address, address, old_size);
+    }
+
+    return new_address;
+}
+
+static void arena_release(void *context, void *address, size_t size)
+{
+    vector_arena *arena = context;
+    (void)size;
+
+    if (is_last_block(arena, address))
+    {
+        arena->used = arena->last_block;
+    }
+}
+
+vector_arena init_arena(const size_t capacity)
+{
+    vector_arena arena = {
+        malloc(capacity),
+        capacity,
+        0,
+        0,
+        {arena_allocate, arena_reallocate, arena_release, NULL, NULL}};
+
+    if (arena.start_address == NULL)
+    {
+        arena.capacity = 0;
+    }
+
+    return arena;
+}
+
+void reset_arena(vector_arena *const arena)
+{
+    arena->used = 0;
+    arena->last_block = 0;
+}
+
+void free_arena(vector_arena *const arena)
+{
+    free(arena->start_address);
+    arena->start_address = NULL;
+    arena->capacity = 0;
+    reset_arena(arena);
+}
+
+const vector_allocator *arena_allocator(vector_arena *const arena)
+{
+    arena->allocator.context = arena;
+    return &arena->allocator;
+}
@@ -0,0 +1,161 @@
+#define _GNU_SOURCE
+
+#include <malloc.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../include/allocator/header.h"
+#include "../include/allocator/operations.h"
+
+static size_t get_page_size(void)
+{
+    static size_t page_size = 0;
+
+    if (page_size == 0)
+    {
+        page_size = (size_t)sysconf(_SC_PAGESIZE);
+    }
+
+    return page_size;
+}
+
+static size_t round_to_pages(const size_t size)
+{
+    size_t page_size = get_page_size();
+
+    return (size + page_size - 1) & ~(page_size - 1);
+}
+
+static int is_mapped(const vector_mmap *const mapping, const size_t size)
+{
+    return size >= mapping->mmap_threshold;
+}
+
+// Applies the huge page and prefault settings to [address + from, address + to)
+static void prepare_pages(const vector_mmap *const mapping, char *address, const size_t from, const size_t to)
+{
+#ifdef MADV_HUGEPAGE
+    if (to >= mapping->huge_page_threshold)
+    {
+        madvise(address, to, MADV_HUGEPAGE);
+    }
+#endif
+
+    if (mapping->prefault)
+    {
+        // one write per page is enough to fault it in
+        for (size_t offset = from; offset < to; offset += get_page_size())
+        {
+            address[offset] = 0;
+        }
+    }
+}
+
+static void *map_pages(const vector_mmap *const mapping, const size_t size)
+{
+    size_t length = round_to_pages(size);
+    char *address = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (address == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    prepare_pages(mapping, address, 0, length);
+    return address;
+}
+
+static void *mmap_allocate(void *context, size_t size)
+{
+    vector_mmap *mapping = context;
+
+    if (!is_mapped(mapping, size))
+    {
+        return malloc(size);
+    }
+
+    return map_pages(mapping, size);
+}
+
+static void mmap_release(void *context, void *address, size_t size)
+{
+    vector_mmap *mapping = context;
+
+    if (address == NULL)
+    {
+        return;
+    }
+
+    if (!is_mapped(mapping, size))
+    {
+        free(address);
+        return;
+    }
+
+    munmap(address, round_to_pages(size));
+}
+
+static void *mmap_reallocate(void *context, void *address, size_t old_size, size_t new_size)
+{
+    vector_mmap *mapping = context;
+
+    if (!is_mapped(mapping, old_size) && !is_mapped(mapping, new_size))
+    {
+        return realloc(address, new_size);
+    }
+
+    // crossing the threshold moves the buffer between malloc and mmap
+    if (!is_mapped(mapping, old_size) || !is_mapped(mapping, new_size))
+    {
+        void *new_address = mmap_allocate(mapping, new_size);
+
+        if (new_address != NULL)
+        {
+            memcpy(new_address, address, old_size < new_size ? old_size : new_size);
+            mmap_release(mapping, address, old_size);
+        }
+
+        return new_address;
+    }
+
+    size_t old_length = round_to_pages(old_size);
+    size_t new_length = round_to_pages(new_size);
+
+    if (old_length == new_length)
+    {
+        return address;
+    }
+
+    char *new_address = mremap(address, old_length, new_length, MREMAP_MAYMOVE);
+
+    if (new_address == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    mapping->remaps++;
+
+    if (new_length > old_length)
+    {
+        prepare_pages(mapping, new_address, old_length, new_length);
+    }
+
+    return new_address;
+}
+
+vector_mmap init_mmap(const size_t mmap_threshold, const size_t huge_page_threshold, const int prefault)
+{
+    return (vector_mmap){
+        mmap_threshold,
+        huge_page_threshold,
+        prefault,
+        0,
+        {mmap_allocate, mmap_reallocate, mmap_release, NULL, NULL}};
+}
+
+const vector_allocator *mmap_allocator(vector_mmap *const mapping)
+{
+    mapping->allocator.context = mapping;
+    return &mapping->allocator;
+}
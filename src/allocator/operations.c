@@ -0,0 +1,44 @@
+#include <malloc.h>
+#include "../include/allocator/header.h"
+#include "../include/allocator/operations.h"
+
+void *allocator_allocate(const vector_allocator *const allocator, const size_t size)
+{
+    if (allocator == NULL)
+    {
+        return malloc(size);
+    }
+
+    return allocator->allocate(allocator->context, size);
+}
+
+void *allocator_reallocate(const vector_allocator *const allocator, void *address, const size_t old_size, const size_t new_size)
+{
+    if (allocator == NULL)
+    {
+        return realloc(address, new_size);
+    }
+
+    return allocator->reallocate(allocator->context, address, old_size, new_size);
+}
+
+void allocator_release(const vector_allocator *const allocator, void *address, const size_t size)
+{
+    if (allocator == NULL)
+    {
+        free(address);
+        return;
+    }
+
+    allocator->release(allocator->context, address, size);
+}
+
+int allocator_prepare_write(const vector_allocator *const allocator, void *address, const size_t offset, const size_t length)
+{
+    if (allocator == NULL || allocator->prepare_write == NULL)
+    {
+        return 0;
+    }
+
+    return allocator->prepare_write(allocator->context, address, offset, length);
+}
@@ -0,0 +1,132 @@
+#include <malloc.h>
+#include <stddef.h>
+#include <string.h>
+#include "../include/allocator/header.h"
+#include "../include/allocator/operations.h"
+
+// Returns POOL_CLASSES for sizes too large to pool
+static int get_class(const size_t size)
+{
+    int size_class = 0;
+
+    while (((size_t)1 << (size_class + MIN_POOL_CLASS_SHIFT)) < size)
+    {
+        if (++size_class == POOL_CLASSES)
+        {
+            break;
+        }
+    }
+
+    return size_class;
+}
+
+static size_t get_class_size(const int size_class)
+{
+    return (size_t)1 << (size_class + MIN_POOL_CLASS_SHIFT);
+}
+
+static void *pool_allocate(void *context, size_t size)
+{
+    vector_pool *pool = context;
+    int size_class = get_class(size);
+
+    if (size_class == POOL_CLASSES)
+    {
+        return malloc(size);
+    }
+
+    void *address = pool->free_lists[size_class];
+
+    if (address == NULL)
+    {
+        pool->misses++;
+        return malloc(get_class_size(size_class));
+    }
+
+    // free buffers store the next free buffer in their first bytes
+    memcpy(&pool->free_lists[size_class], address, sizeof(void *));
+    pool->cached[size_class]--;
+    pool->hits++;
+
+    return address;
+}
+
+static void pool_release(void *context, void *address, size_t size)
+{
+    vector_pool *pool = context;
+    int size_class = get_class(size);
+
+    if (address == NULL)
+    {
+        return;
+    }
+
+    if (size_class == POOL_CLASSES || pool->cached[size_class] >= pool->max_cached_per_class)
+    {
+        free(address);
+        return;
+    }
+
+    memcpy(address, &pool->free_lists[size_class], sizeof(void *));
+    pool->free_lists[size_class] = address;
+    pool->cached[size_class]++;
+}
+
+static void *pool_reallocate(void *context, void *address, size_t old_size, size_t new_size)
+{
+    int old_class = get_class(old_size);
+    int new_class = get_class(new_size);
+
+    if (old_class == POOL_CLASSES && new_class == POOL_CLASSES)
+    {
+        return realloc(address, new_size);
+    }
+
+    if (old_class == new_class)
+    {
+        return address;
+    }
+
+    void *new_address = pool_allocate(context, new_size);
+
+    if (new_address == NULL)
+    {
+        return NULL;
+    }
+
+    memcpy(new_address, address, old_size < new_size ? old_size : new_size);
+    pool_release(context, address, old_size);
+
+    return new_address;
+}
+
+vector_pool init_pool(const int max_cached_per_class)
+{
+    vector_pool pool = {0};
+
+    pool.max_cached_per_class = max_cached_per_class;
+    pool.allocator = (vector_allocator){pool_allocate, pool_reallocate, pool_release, NULL, NULL};
+
+    return pool;
+}
+
+void free_pool(vector_pool *const pool)
+{
+    for (int i = 0; i < POOL_CLASSES; ++i)
+    {
+        while (pool->free_lists[i] != NULL)
+        {
+            void *address = pool->free_lists[i];
+            memcpy(&pool->free_lists[i], address, sizeof(void *));
+            free(address);
+        }
+
+        pool->cached[i] = 0;
+    }
+}
+
+const vector_allocator *pool_allocator(vector_pool *const pool)
+{
+    pool->allocator.context = pool;
+    return &pool->allocator;
+}
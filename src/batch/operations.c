@@ -0,0 +1,336 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/batch/header.h"
+#include "../include/batch/operations.h"
+
+#define NO_NODE -1
+
+// Implicit treap over the result: each node is a run of the original vector
+// or one literal, in position order, heap-ordered by a random priority. Every
+// edit splits at most two runs, so k edits need at most 2k + 1 nodes.
+typedef struct
+{
+    ptrdiff_t source;
+    ptrdiff_t length;
+    // elements in the subtree
+    ptrdiff_t size;
+    ptrdiff_t left;
+    ptrdiff_t right;
+    uint64_t priority;
+    int is_literal;
+} piece_node;
+
+typedef struct
+{
+    piece_node *nodes;
+    ptrdiff_t node_count;
+    long *literals;
+    ptrdiff_t literal_count;
+    uint64_t random_state;
+} piece_tree;
+
+static uint64_t next_priority(piece_tree *const tree)
+{
+    // xorshift64
+    tree->random_state ^= tree->random_state << 13;
+    tree->random_state ^= tree->random_state >> 7;
+    tree->random_state ^= tree->random_state << 17;
+    return tree->random_state;
+}
+
+static ptrdiff_t subtree_size(const piece_tree *const tree, const ptrdiff_t node)
+{
+    return node == NO_NODE ? 0 : tree->nodes[node].size;
+}
+
+static void update(piece_tree *const tree, const ptrdiff_t node)
+{
+    piece_node *current = &tree->nodes[node];
+
+    current->size = subtree_size(tree, current->left) + current->length + subtree_size(tree, current->right);
+}
+
+static ptrdiff_t new_node(piece_tree *const tree, const ptrdiff_t source, const ptrdiff_t length, const int is_literal)
+{
+    ptrdiff_t node = tree->node_count++;
+
+    tree->nodes[node] = (piece_node){source, length, length, NO_NODE, NO_NODE, next_priority(tree), is_literal};
+    return node;
+}
+
+static ptrdiff_t merge(piece_tree *const tree, const ptrdiff_t left, const ptrdiff_t right)
+{
+    if (left == NO_NODE || right == NO_NODE)
+    {
+        return left == NO_NODE ? right : left;
+    }
+
+    if (tree->nodes[left].priority > tree->nodes[right].priority)
+    {
+        tree->nodes[left].right = merge(tree, tree->nodes[left].right, right);
+        update(tree, left);
+        return left;
+    }
+
+    tree->nodes[right].left = merge(tree, left, tree->nodes[right].left);
+    update(tree, right);
+    return right;
+}
+
+// Splits a subtree into its first position elements and the rest, cutting
+// the run position falls inside in two
+static void split(piece_tree *const tree, const ptrdiff_t node, const ptrdiff_t position,
+                  ptrdiff_t *const left, ptrdiff_t *const right)
+{
+    if (node == NO_NODE)
+    {
+        *left = NO_NODE;
+        *right = NO_NODE;
+        return;
+    }
+
+    piece_node *current = &tree->nodes[node];
+    ptrdiff_t left_size = subtree_size(tree, current->left);
+
+    if (position <= left_size)
+    {
+        split(tree, current->left, position, left, &current->left);
+        *right = node;
+    }
+    else if (position >= left_size + current->length)
+    {
+        split(tree, current->right, position - left_size - current->length, &current->right, right);
+        *left = node;
+    }
+    else
+    {
+        ptrdiff_t cut = position - left_size;
+        ptrdiff_t tail = new_node(tree, current->source + cut, current->length - cut, current->is_literal);
+
+        *right = merge(tree, tail, current->right);
+        current->length = cut;
+        current->right = NO_NODE;
+        *left = node;
+    }
+
+    update(tree, node);
+}
+
+static operation_result apply_edit(piece_tree *const tree, ptrdiff_t *const root, const vector_edit *const edit)
+{
+    ptrdiff_t size = subtree_size(tree, *root);
+    ptrdiff_t left, middle, right;
+
+    switch (edit->kind)
+    {
+    case EDIT_INSERT:
+        if (edit->index < 0 || edit->index > size)
+        {
+            return ERR_OUT_OF_BOUNDS;
+        }
+
+        split(tree, *root, edit->index, &left, &right);
+        tree->literals[tree->literal_count] = edit->value;
+        middle = new_node(tree, tree->literal_count++, 1, 1);
+        *root = merge(tree, merge(tree, left, middle), right);
+        return OK;
+
+    case EDIT_ERASE:
+    case EDIT_SET:
+        if (edit->index < 0 || edit->index >= size)
+        {
+            return ERR_OUT_OF_BOUNDS;
+        }
+
+        // middle is the single node holding just that element
+        split(tree, *root, edit->index, &left, &right);
+        split(tree, right, 1, &middle, &right);
+
+        if (edit->kind == EDIT_SET)
+        {
+            piece_node *element = &tree->nodes[middle];
+            if (!element->is_literal)
+            {
+                element->is_literal = 1;
+                element->source = tree->literal_count++;
+            }
+
+            tree->literals[element->source] = edit->value;
+            left = merge(tree, left, middle);
+        }
+
+        *root = merge(tree, left, right);
+        return OK;
+    }
+
+    return ERR_OUT_OF_BOUNDS;
+}
+
+// Lays the tree out in order, joining runs that continue one another and
+// copying literals into result order
+static void collect(const piece_tree *const tree, const ptrdiff_t node, batch_plan *const plan)
+{
+    if (node == NO_NODE)
+    {
+        return;
+    }
+
+    const piece_node *current = &tree->nodes[node];
+    collect(tree, current->left, plan);
+
+    ptrdiff_t source = current->source;
+    if (current->is_literal)
+    {
+        plan->literals[plan->literal_count] = tree->literals[source];
+        source = plan->literal_count++;
+    }
+
+    batch_piece *last = plan->piece_count > 0 ? &plan->pieces[plan->piece_count - 1] : NULL;
+    if (last != NULL && last->from_literals == current->is_literal && last->source + last->length == source)
+    {
+        last->length += current->length;
+    }
+    else
+    {
+        plan->pieces[plan->piece_count++] = (batch_piece){source, current->length, current->is_literal};
+    }
+
+    collect(tree, current->right, plan);
+}
+
+operation_result plan_batch(const vector_edit *const edits, const ptrdiff_t count, const ptrdiff_t size, batch_plan *const plan)
+{
+    if (plan == NULL || (edits == NULL && count > 0))
+    {
+        return ERR_NULL;
+    }
+
+    if (count < 0 || size < 0)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    if (count > (PTRDIFF_MAX / (ptrdiff_t)sizeof(piece_node) - 1) / 2)
+    {
+        return ERR_INVALID_CAPACITY;
+    }
+
+    piece_tree tree = {
+        malloc((2 * count + 1) * sizeof(piece_node)),
+        0,
+        malloc((count + 1) * sizeof(long)),
+        0,
+        0x9E3779B97F4A7C15ULL};
+
+    *plan = (batch_plan){
+        malloc((2 * count + 1) * sizeof(batch_piece)),
+        0,
+        malloc((count + 1) * sizeof(long)),
+        0,
+        size,
+        size};
+
+    operation_result result = OK;
+    if (tree.nodes == NULL || tree.literals == NULL || plan->pieces == NULL || plan->literals == NULL)
+    {
+        result = ERR_MALLOC_FAILED;
+    }
+
+    ptrdiff_t root = NO_NODE;
+    if (result == OK && size > 0)
+    {
+        root = new_node(&tree, 0, size, 0);
+    }
+
+    for (ptrdiff_t i = 0; i < count && result == OK; ++i)
+    {
+        result = apply_edit(&tree, &root, &edits[i]);
+    }
+
+    if (result == OK)
+    {
+        plan->size = subtree_size(&tree, root);
+        collect(&tree, root, plan);
+
+        // the leading runs that are still in place
+        ptrdiff_t position = 0;
+        for (ptrdiff_t i = 0; i < plan->piece_count; ++i)
+        {
+            const batch_piece *piece = &plan->pieces[i];
+            if (piece->from_literals || piece->source != position)
+            {
+                break;
+            }
+
+            position += piece->length;
+        }
+        plan->first_changed = position;
+    }
+    else
+    {
+        free_batch_plan(plan);
+    }
+
+    free(tree.nodes);
+    free(tree.literals);
+
+    return result;
+}
+
+// Runs keep their relative order, so every run moving left can go front to
+// back and every run moving right back to front without either overwriting
+// a run that hasn't moved yet. Literals go last, over whatever the runs left.
+ptrdiff_t apply_batch_plan(long *const values, const batch_plan *const plan)
+{
+    ptrdiff_t moved = 0;
+    ptrdiff_t position = 0;
+
+    for (ptrdiff_t i = 0; i < plan->piece_count; ++i)
+    {
+        const batch_piece *piece = &plan->pieces[i];
+        if (!piece->from_literals && piece->source > position)
+        {
+            memmove(values + position, values + piece->source, piece->length * sizeof(long));
+            moved += piece->length;
+        }
+
+        position += piece->length;
+    }
+
+    for (ptrdiff_t i = plan->piece_count - 1; i >= 0; --i)
+    {
+        const batch_piece *piece = &plan->pieces[i];
+        position -= piece->length;
+
+        if (!piece->from_literals && piece->source < position)
+        {
+            memmove(values + position, values + piece->source, piece->length * sizeof(long));
+            moved += piece->length;
+        }
+    }
+
+    for (ptrdiff_t i = 0; i < plan->piece_count; ++i)
+    {
+        const batch_piece *piece = &plan->pieces[i];
+        if (piece->from_literals)
+        {
+            memcpy(values + position, plan->literals + piece->source, piece->length * sizeof(long));
+        }
+
+        position += piece->length;
+    }
+
+    return moved;
+}
+
+void free_batch_plan(batch_plan *const plan)
+{
+    free(plan->pieces);
+    free(plan->literals);
+
+    plan->pieces = NULL;
+    plan->literals = NULL;
+    plan->piece_count = 0;
+    plan->literal_count = 0;
+}
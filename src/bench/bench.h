@@ -0,0 +1,66 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_TIMER_NAME "rdtsc"
+#else
+#define BENCH_TIMER_NAME "clock_gettime"
+#endif
+
+// 16 linear sub-buckets per power of two, ~6% relative error
+#define HISTOGRAM_SUB_BUCKET_BITS 4
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_BUCKETS (64 * HISTOGRAM_SUB_BUCKETS)
+
+typedef struct
+{
+    uint64_t buckets[HISTOGRAM_BUCKETS];
+    uint64_t count;
+    uint64_t total;
+    uint64_t min;
+    uint64_t max;
+} latency_histogram;
+
+void histogram_reset(latency_histogram *const histogram);
+void histogram_record(latency_histogram *const histogram, const uint64_t cycles);
+uint64_t histogram_percentile(const latency_histogram *const histogram, const double percentile);
+uint64_t histogram_bucket_lower_bound(const int bucket);
+
+uint64_t read_clock_ns(void);
+double calibrate_cycles_per_ns(void);
+// Median cost of an empty read_cycles() pair, included in every sample
+uint64_t measure_timer_overhead(void);
+
+static inline uint64_t read_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();
+    uint64_t cycles = __rdtsc();
+    _mm_lfence();
+    return cycles;
+#else
+    return read_clock_ns();
+#endif
+}
+
+// Type-erased view of a container, so every workload runs the same code
+// against every implementation. insert, erase and sum are NULL for
+// containers without them, and their workloads are skipped.
+typedef struct
+{
+    const char *name;
+    void *(*create)(void);
+    void (*destroy)(void *container);
+    int (*push_back)(void *container, long value);
+    int (*insert)(void *container, ptrdiff_t index, long value);
+    int (*erase)(void *container, ptrdiff_t index);
+    long (*get)(const void *container, ptrdiff_t index);
+    ptrdiff_t (*size)(const void *container);
+    long (*sum)(const void *container);
+} bench_container;
+
+extern const bench_container bench_containers[];
+extern const int bench_containers_count;
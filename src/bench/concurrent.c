@@ -0,0 +1,192 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "../include/vector.h"
+#include "../include/concurrent_vector.h"
+#include "../include/operation_result.h"
+
+#define DEFAULT_OPS 16000000L
+#define MAX_THREADS 64
+
+// push_back throughput for 1, 2, 4 ... 64 threads sharing one vector, with a
+// fixed total number of pushes split evenly across them
+typedef struct
+{
+    const char *name;
+    void *(*create)(void);
+    void (*destroy)(void *container);
+    void *(*worker)(void *argument);
+} concurrent_bench;
+
+typedef struct
+{
+    void *container;
+    long ops;
+    long errors;
+} worker_state;
+
+// The baseline: what a shared vector_header needs today
+typedef struct
+{
+    vector_header header;
+    pthread_mutex_t mutex;
+} locked_vector;
+
+static void *locked_create(void)
+{
+    locked_vector *container = malloc(sizeof(locked_vector));
+    if (container == NULL)
+    {
+        return NULL;
+    }
+
+    container->header = init_vector(MIN_CAPACITY);
+    pthread_mutex_init(&container->mutex, NULL);
+
+    return container;
+}
+
+static void locked_destroy(void *container)
+{
+    locked_vector *locked = container;
+
+    free_vector(&locked->header);
+    pthread_mutex_destroy(&locked->mutex);
+    free(locked);
+}
+
+static void *locked_worker(void *argument)
+{
+    worker_state *state = argument;
+    locked_vector *locked = state->container;
+
+    for (long i = 0; i < state->ops; ++i)
+    {
+        pthread_mutex_lock(&locked->mutex);
+        state->errors += push_back(&locked->header, i) != OK;
+        pthread_mutex_unlock(&locked->mutex);
+    }
+
+    return NULL;
+}
+
+static void *concurrent_create(void)
+{
+    concurrent_vector_header *header = malloc(sizeof(concurrent_vector_header));
+    if (header == NULL)
+    {
+        return NULL;
+    }
+
+    *header = init_concurrent_vector();
+    return header;
+}
+
+static void concurrent_destroy(void *container)
+{
+    free_concurrent_vector(container);
+    free(container);
+}
+
+static void *concurrent_worker(void *argument)
+{
+    worker_state *state = argument;
+
+    for (long i = 0; i < state->ops; ++i)
+    {
+        state->errors += concurrent_push_back(state->container, i) != OK;
+    }
+
+    return NULL;
+}
+
+static const concurrent_bench benches[] = {
+    {"mutex_vector", locked_create, locked_destroy, locked_worker},
+    {"concurrent_vector", concurrent_create, concurrent_destroy, concurrent_worker},
+};
+
+static void run(const concurrent_bench *const bench, const int threads, const long ops, const int csv)
+{
+    pthread_t handles[MAX_THREADS];
+    worker_state states[MAX_THREADS];
+    void *container = bench->create();
+
+    if (container == NULL)
+    {
+        fprintf(stderr, "%s: failed to create\n", bench->name);
+        return;
+    }
+
+    uint64_t start = read_clock_ns();
+
+    for (int i = 0; i < threads; ++i)
+    {
+        states[i] = (worker_state){container, ops / threads, 0};
+        pthread_create(&handles[i], NULL, bench->worker, &states[i]);
+    }
+
+    long errors = 0;
+    for (int i = 0; i < threads; ++i)
+    {
+        pthread_join(handles[i], NULL);
+        errors += states[i].errors;
+    }
+
+    double seconds = (double)(read_clock_ns() - start) / 1e9;
+    double total = (double)(ops / threads * threads);
+
+    printf(csv ? "%s,%d,%.0f,%.0f,%ld\n" : "%-24s %8d %12.0f %14.0f %8ld\n",
+           bench->name, threads, total, total / seconds, errors);
+    fflush(stdout);
+
+    bench->destroy(container);
+}
+
+int main(int argc, char **argv)
+{
+    long ops = DEFAULT_OPS;
+    int max_threads = MAX_THREADS;
+    int csv = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--csv") == 0)
+        {
+            csv = 1;
+        }
+        else if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc)
+        {
+            ops = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc)
+        {
+            max_threads = atoi(argv[++i]);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--ops N] [--max-threads N] [--csv]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (ops <= 0 || max_threads < 1 || max_threads > MAX_THREADS)
+    {
+        fprintf(stderr, "--ops must be positive and --max-threads within 1..%d\n", MAX_THREADS);
+        return 1;
+    }
+
+    printf(csv ? "container,threads,ops,ops_per_sec,errors\n" : "%-24s %8s %12s %14s %8s\n",
+           "container", "threads", "ops", "ops/sec", "errors");
+
+    for (int b = 0; b < (int)(sizeof(benches) / sizeof(benches[0])); ++b)
+    {
+        for (int threads = 1; threads <= max_threads; threads *= 2)
+        {
+            run(&benches[b], threads, ops, csv);
+        }
+    }
+
+    return 0;
+}
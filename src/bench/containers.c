@@ -0,0 +1,359 @@
+#include <stdlib.h>
+#include "bench.h"
+#include "../include/vector.h"
+#include "../include/deamortized_vector.h"
+#include "../include/tiered_vector.h"
+#include "../include/allocator.h"
+#include "../include/search.h"
+#include "../include/packed_vector.h"
+
+static void *vector_create(void)
+{
+    vector_header *header = malloc(sizeof(vector_header));
+    if (header == NULL)
+    {
+        return NULL;
+    }
+
+    *header = init_vector(MIN_CAPACITY);
+    if (!header->is_allocated)
+    {
+        free(header);
+        return NULL;
+    }
+
+    return header;
+}
+
+static void vector_destroy(void *container)
+{
+    free_vector(container);
+    free(container);
+}
+
+static int vector_push_back_adapter(void *container, long value)
+{
+    return push_back(container, value);
+}
+
+static int vector_insert_adapter(void *container, ptrdiff_t index, long value)
+{
+    return insert(container, index, value);
+}
+
+static int vector_erase_adapter(void *container, ptrdiff_t index)
+{
+    return erase(container, index);
+}
+
+static long vector_get_adapter(const void *container, ptrdiff_t index)
+{
+    return get(container, index);
+}
+
+static ptrdiff_t vector_size(const void *container)
+{
+    return ((const vector_header *)container)->size;
+}
+
+static long vector_sum_adapter(const void *container)
+{
+    long sum = 0;
+    vector_sum(container, &sum);
+    return sum;
+}
+
+// The header comes first so the vector adapters work on it unchanged
+typedef struct
+{
+    vector_header header;
+    vector_mmap mapping;
+} mapped_vector;
+
+// mmap from 1MB, huge pages from 2MB
+static void *mapped_create(void)
+{
+    mapped_vector *container = malloc(sizeof(mapped_vector));
+    if (container == NULL)
+    {
+        return NULL;
+    }
+
+    container->mapping = init_mmap(1 << 20, 1 << 21, 0);
+    container->header = init_vector_with_allocator(MIN_CAPACITY, mmap_allocator(&container->mapping));
+    if (!container->header.is_allocated)
+    {
+        free(container);
+        return NULL;
+    }
+
+    return container;
+}
+
+static void *deamortized_create(void)
+{
+    deamortized_vector_header *header = malloc(sizeof(deamortized_vector_header));
+    if (header == NULL)
+    {
+        return NULL;
+    }
+
+    *header = init_deamortized_vector(MIN_CAPACITY);
+    if (!header->current_vector.is_allocated)
+    {
+        free(header);
+        return NULL;
+    }
+
+    return header;
+}
+
+// A 4KB migration budget per operation: shorter dual-buffer windows, bigger steps
+static void *deamortized_page_rate_create(void)
+{
+    deamortized_vector_header *header = deamortized_create();
+    if (header != NULL)
+    {
+        deamortized_set_migration_bytes(header, 4096);
+    }
+
+    return header;
+}
+
+static void deamortized_destroy(void *container)
+{
+    free_deamortized_vector(container);
+    free(container);
+}
+
+static int deamortized_push_back_adapter(void *container, long value)
+{
+    return deamortized_push_back(container, value);
+}
+
+static int deamortized_insert_adapter(void *container, ptrdiff_t index, long value)
+{
+    return deamortized_insert(container, index, value);
+}
+
+static int deamortized_erase_adapter(void *container, ptrdiff_t index)
+{
+    return deamortized_erase(container, index);
+}
+
+static long deamortized_get_adapter(const void *container, ptrdiff_t index)
+{
+    return deamortized_get(container, index);
+}
+
+static ptrdiff_t deamortized_size(const void *container)
+{
+    return get_size(container);
+}
+
+static long deamortized_sum_adapter(const void *container)
+{
+    long sum = 0;
+    deamortized_sum(container, &sum);
+    return sum;
+}
+
+// The header comes first so the deamortized adapters work on it unchanged
+typedef struct
+{
+    deamortized_vector_header header;
+    vector_pool pool;
+} pooled_deamortized_vector;
+
+static void *pooled_deamortized_create(void)
+{
+    pooled_deamortized_vector *container = malloc(sizeof(pooled_deamortized_vector));
+    if (container == NULL)
+    {
+        return NULL;
+    }
+
+    container->pool = init_pool(4);
+    container->header = init_deamortized_vector_with_allocator(MIN_CAPACITY, pool_allocator(&container->pool));
+    if (!container->header.current_vector.is_allocated)
+    {
+        free_pool(&container->pool);
+        free(container);
+        return NULL;
+    }
+
+    return container;
+}
+
+static void pooled_deamortized_destroy(void *container)
+{
+    pooled_deamortized_vector *pooled = container;
+
+    free_deamortized_vector(&pooled->header);
+    free_pool(&pooled->pool);
+    free(pooled);
+}
+
+static void *tiered_create(void)
+{
+    tiered_vector_header *header = malloc(sizeof(tiered_vector_header));
+    if (header == NULL)
+    {
+        return NULL;
+    }
+
+    *header = init_tiered_vector(MIN_CAPACITY);
+    if (!header->is_allocated)
+    {
+        free(header);
+        return NULL;
+    }
+
+    return header;
+}
+
+static void tiered_destroy(void *container)
+{
+    free_tiered_vector(container);
+    free(container);
+}
+
+static int tiered_push_back_adapter(void *container, long value)
+{
+    return tiered_push_back(container, value);
+}
+
+static int tiered_insert_adapter(void *container, ptrdiff_t index, long value)
+{
+    return tiered_insert(container, index, value);
+}
+
+static int tiered_erase_adapter(void *container, ptrdiff_t index)
+{
+    return tiered_erase(container, index);
+}
+
+static long tiered_get_adapter(const void *container, ptrdiff_t index)
+{
+    return tiered_get(container, index);
+}
+
+static ptrdiff_t tiered_size(const void *container)
+{
+    return tiered_get_size(container);
+}
+
+static void *packed_create(void)
+{
+    packed_vector_header *header = malloc(sizeof(packed_vector_header));
+    if (header == NULL)
+    {
+        return NULL;
+    }
+
+    *header = init_packed_vector(MIN_CAPACITY);
+    if (!header->is_allocated)
+    {
+        free(header);
+        return NULL;
+    }
+
+    return header;
+}
+
+static void packed_destroy(void *container)
+{
+    free_packed_vector(container);
+    free(container);
+}
+
+static int packed_push_back_adapter(void *container, long value)
+{
+    return packed_push_back(container, value);
+}
+
+static long packed_get_adapter(const void *container, ptrdiff_t index)
+{
+    return packed_get(container, index);
+}
+
+static ptrdiff_t packed_size(const void *container)
+{
+    return packed_get_size(container);
+}
+
+static long packed_sum_adapter(const void *container)
+{
+    long sum = 0;
+    packed_sum(container, &sum);
+    return sum;
+}
+
+const bench_container bench_containers[] = {
+    {"vector",
+     vector_create,
+     vector_destroy,
+     vector_push_back_adapter,
+     vector_insert_adapter,
+     vector_erase_adapter,
+     vector_get_adapter,
+     vector_size,
+     vector_sum_adapter},
+    {"vector_mmap",
+     mapped_create,
+     vector_destroy,
+     vector_push_back_adapter,
+     vector_insert_adapter,
+     vector_erase_adapter,
+     vector_get_adapter,
+     vector_size,
+     vector_sum_adapter},
+    {"deamortized_vector",
+     deamortized_create,
+     deamortized_destroy,
+     deamortized_push_back_adapter,
+     deamortized_insert_adapter,
+     deamortized_erase_adapter,
+     deamortized_get_adapter,
+     deamortized_size,
+     deamortized_sum_adapter},
+    {"deamortized_vector_4k",
+     deamortized_page_rate_create,
+     deamortized_destroy,
+     deamortized_push_back_adapter,
+     deamortized_insert_adapter,
+     deamortized_erase_adapter,
+     deamortized_get_adapter,
+     deamortized_size,
+     deamortized_sum_adapter},
+    {"deamortized_vector_pool",
+     pooled_deamortized_create,
+     pooled_deamortized_destroy,
+     deamortized_push_back_adapter,
+     deamortized_insert_adapter,
+     deamortized_erase_adapter,
+     deamortized_get_adapter,
+     deamortized_size,
+     deamortized_sum_adapter},
+    {"tiered_vector",
+     tiered_create,
+     tiered_destroy,
+     tiered_push_back_adapter,
+     tiered_insert_adapter,
+     tiered_erase_adapter,
+     tiered_get_adapter,
+     tiered_size,
+     NULL},
+    // No insert or erase: the uncompressed vector is its baseline for the rest
+    {"packed_vector",
+     packed_create,
+     packed_destroy,
+     packed_push_back_adapter,
+     NULL,
+     NULL,
+     packed_get_adapter,
+     packed_size,
+     packed_sum_adapter},
+};
+
+const int bench_containers_count = sizeof(bench_containers) / sizeof(bench_containers[0]);
@@ -0,0 +1,133 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+
+static int get_bucket(const uint64_t cycles)
+{
+    if (cycles < HISTOGRAM_SUB_BUCKETS)
+    {
+        return (int)cycles;
+    }
+
+    int exponent = 63 - __builtin_clzll(cycles);
+    int sub_bucket = (int)((cycles >> (exponent - HISTOGRAM_SUB_BUCKET_BITS)) & (HISTOGRAM_SUB_BUCKETS - 1));
+
+    return (exponent - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS + sub_bucket;
+}
+
+uint64_t histogram_bucket_lower_bound(const int bucket)
+{
+    if (bucket < HISTOGRAM_SUB_BUCKETS)
+    {
+        return (uint64_t)bucket;
+    }
+
+    int exponent = bucket / HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BUCKET_BITS - 1;
+    uint64_t sub_bucket = (uint64_t)(bucket % HISTOGRAM_SUB_BUCKETS);
+
+    return (HISTOGRAM_SUB_BUCKETS + sub_bucket) << (exponent - HISTOGRAM_SUB_BUCKET_BITS);
+}
+
+void histogram_reset(latency_histogram *const histogram)
+{
+    memset(histogram, 0, sizeof(*histogram));
+    histogram->min = UINT64_MAX;
+}
+
+void histogram_record(latency_histogram *const histogram, const uint64_t cycles)
+{
+    histogram->buckets[get_bucket(cycles)]++;
+    histogram->count++;
+    histogram->total += cycles;
+
+    if (cycles < histogram->min)
+    {
+        histogram->min = cycles;
+    }
+
+    if (cycles > histogram->max)
+    {
+        histogram->max = cycles;
+    }
+}
+
+uint64_t histogram_percentile(const latency_histogram *const histogram, const double percentile)
+{
+    if (histogram->count == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)histogram->count);
+    if (rank >= histogram->count)
+    {
+        rank = histogram->count - 1;
+    }
+
+    uint64_t seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; ++i)
+    {
+        seen += histogram->buckets[i];
+        if (seen > rank)
+        {
+            // the exact extremes are known, don't report a bucket bound past them
+            uint64_t value = histogram_bucket_lower_bound(i);
+            if (value < histogram->min)
+            {
+                return histogram->min;
+            }
+            return value > histogram->max ? histogram->max : value;
+        }
+    }
+
+    return histogram->max;
+}
+
+uint64_t read_clock_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+double calibrate_cycles_per_ns(void)
+{
+    uint64_t start_ns = read_clock_ns();
+    uint64_t start_cycles = read_cycles();
+
+    // busy-wait ~50ms so the ratio is stable
+    while (read_clock_ns() - start_ns < 50000000ULL)
+    {
+    }
+
+    uint64_t elapsed_cycles = read_cycles() - start_cycles;
+    uint64_t elapsed_ns = read_clock_ns() - start_ns;
+
+    return (double)elapsed_cycles / (double)elapsed_ns;
+}
+
+uint64_t measure_timer_overhead(void)
+{
+    latency_histogram *histogram = malloc(sizeof(latency_histogram));
+    if (histogram == NULL)
+    {
+        return 0;
+    }
+
+    histogram_reset(histogram);
+    for (int i = 0; i < 100000; ++i)
+    {
+        uint64_t start = read_cycles();
+        uint64_t end = read_cycles();
+        histogram_record(histogram, end - start);
+    }
+
+    uint64_t overhead = histogram_percentile(histogram, 50.0);
+    free(histogram);
+
+    return overhead;
+}
@@ -0,0 +1,436 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "../include/operation_result.h"
+
+#define DEFAULT_MIN_SIZE 1000L
+#define DEFAULT_MAX_SIZE 100000000L
+#define DEFAULT_SEED 42ULL
+// --large: 2^28 elements (2GB) and then ~2.7 billion (20GB), past INT_MAX
+#define LARGE_MIN_SIZE (1L << 28)
+#define LARGE_MAX_SIZE (3L << 30)
+#define GET_OPS 1000000L
+// insert/erase shift O(n) elements each, so their op count is scaled down with size
+#define SHIFT_WORK_BUDGET (1L << 28)
+#define MIN_SHIFT_OPS 16L
+#define MAX_SHIFT_OPS 100000L
+// Whole-container scans timed per size
+#define SCAN_OPS 16L
+
+typedef enum
+{
+    FORMAT_TEXT,
+    FORMAT_CSV,
+    FORMAT_JSON
+} output_format;
+
+typedef struct
+{
+    long min_size;
+    long max_size;
+    uint64_t seed;
+    output_format format;
+    const char *container_filter;
+} bench_options;
+
+typedef struct
+{
+    output_format format;
+    double cycles_per_ns;
+    uint64_t timer_overhead;
+    int records;
+} bench_output;
+
+static uint64_t next_random(uint64_t *const state)
+{
+    // xorshift64*
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 2685821657736338717ULL;
+}
+
+static ptrdiff_t random_index(uint64_t *const state, const ptrdiff_t bound)
+{
+    return (ptrdiff_t)(next_random(state) % (uint64_t)bound);
+}
+
+static void print_usage(const char *program)
+{
+    fprintf(stderr,
+            "usage: %s [--min-size N] [--max-size N] [--format text|csv|json]\n"
+            "          [--seed N] [--container NAME] [--large]\n",
+            program);
+}
+
+static int parse_options(const int argc, char **argv, bench_options *const options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--large") == 0)
+        {
+            options->min_size = LARGE_MIN_SIZE;
+            options->max_size = LARGE_MAX_SIZE;
+            continue;
+        }
+
+        if (i + 1 >= argc)
+        {
+            return 0;
+        }
+
+        const char *value = argv[i + 1];
+
+        if (strcmp(argv[i], "--min-size") == 0)
+        {
+            options->min_size = atol(value);
+        }
+        else if (strcmp(argv[i], "--max-size") == 0)
+        {
+            options->max_size = atol(value);
+        }
+        else if (strcmp(argv[i], "--seed") == 0)
+        {
+            options->seed = strtoull(value, NULL, 10);
+        }
+        else if (strcmp(argv[i], "--container") == 0)
+        {
+            options->container_filter = value;
+        }
+        else if (strcmp(argv[i], "--format") == 0)
+        {
+            if (strcmp(value, "text") == 0)
+            {
+                options->format = FORMAT_TEXT;
+            }
+            else if (strcmp(value, "csv") == 0)
+            {
+                options->format = FORMAT_CSV;
+            }
+            else if (strcmp(value, "json") == 0)
+            {
+                options->format = FORMAT_JSON;
+            }
+            else
+            {
+                return 0;
+            }
+        }
+        else
+        {
+            return 0;
+        }
+
+        ++i;
+    }
+
+    // the xorshift state must never be zero
+    if (options->seed == 0)
+    {
+        options->seed = DEFAULT_SEED;
+    }
+
+    return options->min_size > 0 && options->max_size >= options->min_size && options->max_size <= LARGE_MAX_SIZE;
+}
+
+static void print_header(const bench_output *const output)
+{
+    switch (output->format)
+    {
+    case FORMAT_TEXT:
+        printf("timer: %s, %.3f cycles/ns, overhead %llu cycles\n",
+               BENCH_TIMER_NAME, output->cycles_per_ns, (unsigned long long)output->timer_overhead);
+        printf("%-24s %-10s %10s %9s %14s %10s %10s %10s %12s %8s\n",
+               "container", "operation", "size", "ops", "ops/sec",
+               "p50 ns", "p99 ns", "p99.9 ns", "max ns", "errors");
+        break;
+    case FORMAT_CSV:
+        printf("container,operation,size,ops,errors,ops_per_sec,"
+               "min_cycles,mean_cycles,p50_cycles,p99_cycles,p999_cycles,max_cycles,cycles_per_ns\n");
+        break;
+    case FORMAT_JSON:
+        printf("{\n  \"timer\": \"%s\",\n  \"cycles_per_ns\": %.6f,\n  \"timer_overhead_cycles\": %llu,\n  \"results\": [",
+               BENCH_TIMER_NAME, output->cycles_per_ns, (unsigned long long)output->timer_overhead);
+        break;
+    }
+}
+
+static void print_footer(const bench_output *const output)
+{
+    if (output->format == FORMAT_JSON)
+    {
+        printf("\n  ]\n}\n");
+    }
+}
+
+static void print_result(bench_output *const output,
+                         const char *container,
+                         const char *operation,
+                         const long size,
+                         const long errors,
+                         const latency_histogram *const histogram)
+{
+    double cycles_per_ns = output->cycles_per_ns;
+    double seconds = (double)histogram->total / cycles_per_ns / 1e9;
+    double ops_per_sec = seconds > 0 ? (double)histogram->count / seconds : 0;
+    double mean = histogram->count > 0 ? (double)histogram->total / (double)histogram->count : 0;
+    uint64_t p50 = histogram_percentile(histogram, 50.0);
+    uint64_t p99 = histogram_percentile(histogram, 99.0);
+    uint64_t p999 = histogram_percentile(histogram, 99.9);
+    uint64_t min = histogram->count > 0 ? histogram->min : 0;
+
+    switch (output->format)
+    {
+    case FORMAT_TEXT:
+        printf("%-24s %-10s %10ld %9llu %14.0f %10.1f %10.1f %10.1f %12.1f %8ld\n",
+               container, operation, size, (unsigned long long)histogram->count, ops_per_sec,
+               (double)p50 / cycles_per_ns, (double)p99 / cycles_per_ns,
+               (double)p999 / cycles_per_ns, (double)histogram->max / cycles_per_ns, errors);
+        break;
+    case FORMAT_CSV:
+        printf("%s,%s,%ld,%llu,%ld,%.0f,%llu,%.1f,%llu,%llu,%llu,%llu,%.6f\n",
+               container, operation, size, (unsigned long long)histogram->count, errors, ops_per_sec,
+               (unsigned long long)min, mean, (unsigned long long)p50, (unsigned long long)p99,
+               (unsigned long long)p999, (unsigned long long)histogram->max, cycles_per_ns);
+        break;
+    case FORMAT_JSON:
+        printf("%s\n    {\"container\": \"%s\", \"operation\": \"%s\", \"size\": %ld, \"ops\": %llu, "
+               "\"errors\": %ld, \"ops_per_sec\": %.0f, \"min_cycles\": %llu, \"mean_cycles\": %.1f, "
+               "\"p50_cycles\": %llu, \"p99_cycles\": %llu, \"p999_cycles\": %llu, \"max_cycles\": %llu, "
+               "\"histogram\": [",
+               output->records > 0 ? "," : "",
+               container, operation, size, (unsigned long long)histogram->count, errors, ops_per_sec,
+               (unsigned long long)min, mean, (unsigned long long)p50, (unsigned long long)p99,
+               (unsigned long long)p999, (unsigned long long)histogram->max);
+
+        int first = 1;
+        for (int i = 0; i < HISTOGRAM_BUCKETS; ++i)
+        {
+            if (histogram->buckets[i] == 0)
+            {
+                continue;
+            }
+
+            printf("%s[%llu, %llu]", first ? "" : ", ",
+                   (unsigned long long)histogram_bucket_lower_bound(i),
+                   (unsigned long long)histogram->buckets[i]);
+            first = 0;
+        }
+        printf("]}");
+        break;
+    }
+
+    output->records++;
+    fflush(stdout);
+}
+
+// Fills a fresh container up to size, timing every push_back, so growth spikes
+// land in the tail of the histogram.
+static void *bench_push_back(const bench_container *const container,
+                             const long size,
+                             latency_histogram *const histogram,
+                             long *const errors)
+{
+    void *instance = container->create();
+    if (instance == NULL)
+    {
+        return NULL;
+    }
+
+    histogram_reset(histogram);
+    *errors = 0;
+
+    for (long i = 0; i < size; ++i)
+    {
+        uint64_t start = read_cycles();
+        int result = container->push_back(instance, i);
+        uint64_t end = read_cycles();
+
+        histogram_record(histogram, end - start);
+
+        if (result != OK)
+        {
+            ++*errors;
+            break;
+        }
+    }
+
+    return instance;
+}
+
+static void bench_get(const bench_container *const container,
+                      void *const instance,
+                      uint64_t *const random_state,
+                      latency_histogram *const histogram)
+{
+    ptrdiff_t size = container->size(instance);
+    long ops = size < GET_OPS ? size : GET_OPS;
+    volatile long sink = 0;
+
+    histogram_reset(histogram);
+
+    for (long i = 0; i < ops; ++i)
+    {
+        ptrdiff_t index = random_index(random_state, size);
+
+        uint64_t start = read_cycles();
+        sink += container->get(instance, index);
+        uint64_t end = read_cycles();
+
+        histogram_record(histogram, end - start);
+    }
+
+    (void)sink;
+}
+
+static void bench_sum(const bench_container *const container,
+                      void *const instance,
+                      latency_histogram *const histogram)
+{
+    volatile long sink = 0;
+
+    histogram_reset(histogram);
+
+    for (long i = 0; i < SCAN_OPS; ++i)
+    {
+        uint64_t start = read_cycles();
+        sink += container->sum(instance);
+        uint64_t end = read_cycles();
+
+        histogram_record(histogram, end - start);
+    }
+
+    (void)sink;
+}
+
+// Alternates random-position inserts and erases so the size stays put.
+static void bench_insert_erase(const bench_container *const container,
+                               void *const instance,
+                               uint64_t *const random_state,
+                               latency_histogram *const insert_histogram,
+                               latency_histogram *const erase_histogram,
+                               long *const insert_errors,
+                               long *const erase_errors)
+{
+    long size = container->size(instance);
+    long ops = SHIFT_WORK_BUDGET / (size > 0 ? size : 1);
+    ops = ops < MIN_SHIFT_OPS ? MIN_SHIFT_OPS : ops;
+    ops = ops > MAX_SHIFT_OPS ? MAX_SHIFT_OPS : ops;
+
+    histogram_reset(insert_histogram);
+    histogram_reset(erase_histogram);
+    *insert_errors = 0;
+    *erase_errors = 0;
+
+    for (long i = 0; i < ops; ++i)
+    {
+        ptrdiff_t index = random_index(random_state, container->size(instance) + 1);
+
+        uint64_t start = read_cycles();
+        int result = container->insert(instance, index, i);
+        uint64_t end = read_cycles();
+
+        histogram_record(insert_histogram, end - start);
+        *insert_errors += result != OK;
+
+        index = random_index(random_state, container->size(instance));
+
+        start = read_cycles();
+        result = container->erase(instance, index);
+        end = read_cycles();
+
+        histogram_record(erase_histogram, end - start);
+        *erase_errors += result != OK;
+    }
+}
+
+static void run_container(const bench_container *const container,
+                          const bench_options *const options,
+                          bench_output *const output,
+                          latency_histogram *const histograms)
+{
+    uint64_t random_state = options->seed;
+
+    for (long size = options->min_size; size <= options->max_size; size *= 10)
+    {
+        long errors = 0;
+        long erase_errors = 0;
+
+        void *instance = bench_push_back(container, size, &histograms[0], &errors);
+        if (instance == NULL || errors != 0)
+        {
+            fprintf(stderr, "%s: failed to fill to size %ld, skipping larger sizes\n", container->name, size);
+            if (instance != NULL)
+            {
+                container->destroy(instance);
+            }
+            return;
+        }
+        print_result(output, container->name, "push_back", size, errors, &histograms[0]);
+
+        bench_get(container, instance, &random_state, &histograms[0]);
+        print_result(output, container->name, "get", size, 0, &histograms[0]);
+
+        if (container->sum != NULL)
+        {
+            bench_sum(container, instance, &histograms[0]);
+            print_result(output, container->name, "sum", size, 0, &histograms[0]);
+        }
+
+        if (container->insert != NULL && container->erase != NULL)
+        {
+            bench_insert_erase(container, instance, &random_state,
+                               &histograms[0], &histograms[1], &errors, &erase_errors);
+            print_result(output, container->name, "insert", size, errors, &histograms[0]);
+            print_result(output, container->name, "erase", size, erase_errors, &histograms[1]);
+        }
+
+        container->destroy(instance);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    bench_options options = {
+        DEFAULT_MIN_SIZE,
+        DEFAULT_MAX_SIZE,
+        DEFAULT_SEED,
+        FORMAT_TEXT,
+        NULL};
+
+    if (!parse_options(argc, argv, &options))
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    latency_histogram *histograms = malloc(2 * sizeof(latency_histogram));
+    if (histograms == NULL)
+    {
+        return 1;
+    }
+
+    bench_output output = {
+        options.format,
+        calibrate_cycles_per_ns(),
+        measure_timer_overhead(),
+        0};
+
+    print_header(&output);
+
+    for (int i = 0; i < bench_containers_count; ++i)
+    {
+        if (options.container_filter != NULL && strcmp(options.container_filter, bench_containers[i].name) != 0)
+        {
+            continue;
+        }
+
+        run_container(&bench_containers[i], &options, &output, histograms);
+    }
+
+    print_footer(&output);
+    free(histograms);
+
+    return 0;
+}
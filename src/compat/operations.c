@@ -0,0 +1,104 @@
+#include <limits.h>
+#include <stddef.h>
+#include "../include/compat/operations.h"
+#include "../include/deamortized_vector/operations.h"
+#include "../include/search/operations.h"
+#include "../include/sorted_vector/operations.h"
+
+// Stores the wide out-parameter of a finished call into an int one, unless the
+// call failed or the value doesn't fit. wide is passed by address so it is read
+// only after the call has written it.
+static operation_result narrow(const operation_result result, const ptrdiff_t *const wide, int *const target)
+{
+    if (result != OK)
+    {
+        return result;
+    }
+
+    if (*wide > INT_MAX || *wide < INT_MIN)
+    {
+        return ERR_INVALID_CAPACITY;
+    }
+
+    if (target != NULL)
+    {
+        *target = (int)*wide;
+    }
+
+    return OK;
+}
+
+operation_result vector_get_size_int(const vector_header *const header, int *const size)
+{
+    if (header == NULL || size == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return narrow(header->is_allocated ? OK : ERR_INVALID_HEADER, &header->size, size);
+}
+
+operation_result deamortized_get_size_int(const deamortized_vector_header *const header, int *const size)
+{
+    if (header == NULL || size == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return vector_get_size_int(&header->current_vector, size);
+}
+
+operation_result vector_find_int(const vector_header *const header, const long value, int *const index)
+{
+    ptrdiff_t wide = 0;
+    return index == NULL ? ERR_NULL : narrow(vector_find(header, value, &wide), &wide, index);
+}
+
+operation_result vector_count_int(const vector_header *const header, const long value, int *const count)
+{
+    ptrdiff_t wide = 0;
+    return count == NULL ? ERR_NULL : narrow(vector_count(header, value, &wide), &wide, count);
+}
+
+operation_result vector_argmin_int(const vector_header *const header, int *const index)
+{
+    ptrdiff_t wide = 0;
+    return index == NULL ? ERR_NULL : narrow(vector_argmin(header, &wide), &wide, index);
+}
+
+operation_result deamortized_find_int(const deamortized_vector_header *const header, const long value, int *const index)
+{
+    ptrdiff_t wide = 0;
+    return index == NULL ? ERR_NULL : narrow(deamortized_find(header, value, &wide), &wide, index);
+}
+
+operation_result deamortized_count_int(const deamortized_vector_header *const header, const long value, int *const count)
+{
+    ptrdiff_t wide = 0;
+    return count == NULL ? ERR_NULL : narrow(deamortized_count(header, value, &wide), &wide, count);
+}
+
+operation_result deamortized_argmin_int(const deamortized_vector_header *const header, int *const index)
+{
+    ptrdiff_t wide = 0;
+    return index == NULL ? ERR_NULL : narrow(deamortized_argmin(header, &wide), &wide, index);
+}
+
+operation_result sorted_lower_bound_int(const vector_header *const header, const long key, int *const index)
+{
+    ptrdiff_t wide = 0;
+    return index == NULL ? ERR_NULL : narrow(sorted_lower_bound(header, key, &wide), &wide, index);
+}
+
+operation_result sorted_upper_bound_int(const vector_header *const header, const long key, int *const index)
+{
+    ptrdiff_t wide = 0;
+    return index == NULL ? ERR_NULL : narrow(sorted_upper_bound(header, key, &wide), &wide, index);
+}
+
+// erased may be NULL, as in sorted_erase(); an oversized count still erased
+operation_result sorted_erase_int(vector_header *const header, const long key, int *const erased)
+{
+    ptrdiff_t wide = 0;
+    return narrow(sorted_erase(header, key, &wide), &wide, erased);
+}
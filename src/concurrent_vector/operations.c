@@ -0,0 +1,215 @@
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "../include/concurrent_vector/header.h"
+#include "../include/concurrent_vector/operations.h"
+
+static int is_invalid(const concurrent_vector_header *const header)
+{
+    return !header->is_allocated;
+}
+
+static long get_segment_length(const int segment)
+{
+    return 1L << (FIRST_SEGMENT_SHIFT + segment);
+}
+
+// Index i lives in segment msb(i + 2^FIRST_SEGMENT_SHIFT) - FIRST_SEGMENT_SHIFT
+static int get_segment(const int index, long *const offset)
+{
+    unsigned long position = (unsigned long)index + (1UL << FIRST_SEGMENT_SHIFT);
+    int msb = 63 - __builtin_clzl(position);
+
+    *offset = (long)(position - (1UL << msb));
+    return msb - FIRST_SEGMENT_SHIFT;
+}
+
+static atomic_uchar *get_ready_flags(atomic_long *const values, const int segment)
+{
+    return (atomic_uchar *)(values + get_segment_length(segment));
+}
+
+// Installs segment unless another thread got there first; either way returns
+// the published one
+static atomic_long *publish_segment(concurrent_vector_header *const header, const int segment)
+{
+    atomic_long *values = atomic_load_explicit(&header->segments[segment], memory_order_acquire);
+    if (values != NULL)
+    {
+        return values;
+    }
+
+    long length = get_segment_length(segment);
+    atomic_long *allocated = calloc(length, sizeof(atomic_long) + sizeof(atomic_uchar));
+
+    if (allocated == NULL)
+    {
+        return NULL;
+    }
+
+    if (!atomic_compare_exchange_strong_explicit(&header->segments[segment], &values, allocated,
+                                                 memory_order_acq_rel, memory_order_acquire))
+    {
+        free(allocated);
+        return values;
+    }
+
+    return allocated;
+}
+
+// Returns the slot of a published element, or NULL if it isn't there yet
+static atomic_long *get_slot(const concurrent_vector_header *const header, const int index)
+{
+    if (index < 0 || index >= atomic_load_explicit(&header->reserved, memory_order_acquire))
+    {
+        return NULL;
+    }
+
+    long offset;
+    int segment = get_segment(index, &offset);
+    atomic_long *values = atomic_load_explicit(&header->segments[segment], memory_order_acquire);
+
+    if (values == NULL || !atomic_load_explicit(&get_ready_flags(values, segment)[offset], memory_order_acquire))
+    {
+        return NULL;
+    }
+
+    return &values[offset];
+}
+
+concurrent_vector_header init_concurrent_vector(void)
+{
+    concurrent_vector_header header = {0};
+
+    atomic_init(&header.reserved, 0);
+    for (int i = 0; i < CONCURRENT_SEGMENTS; ++i)
+    {
+        atomic_init(&header.segments[i], NULL);
+    }
+
+    // the first segment up front, so small vectors never race to allocate
+    header.is_allocated = publish_segment(&header, 0) != NULL;
+
+    return header;
+}
+
+operation_result free_concurrent_vector(concurrent_vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    for (int i = 0; i < CONCURRENT_SEGMENTS; ++i)
+    {
+        free(atomic_load_explicit(&header->segments[i], memory_order_relaxed));
+        atomic_store_explicit(&header->segments[i], NULL, memory_order_relaxed);
+    }
+
+    header->is_allocated = false;
+
+    return OK;
+}
+
+operation_result concurrent_get(const concurrent_vector_header *const header, const int index, long *const value)
+{
+    if (header == NULL || value == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    atomic_long *slot = get_slot(header, index);
+    if (slot == NULL)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    *value = atomic_load_explicit(slot, memory_order_relaxed);
+    return OK;
+}
+
+operation_result concurrent_set(concurrent_vector_header *const header, const int index, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    atomic_long *slot = get_slot(header, index);
+    if (slot == NULL)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    atomic_store_explicit(slot, value, memory_order_relaxed);
+    return OK;
+}
+
+operation_result concurrent_push_back(concurrent_vector_header *const header, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    long index = atomic_fetch_add_explicit(&header->reserved, 1, memory_order_relaxed);
+
+    if (index >= INT_MAX)
+    {
+        // the claim can't be undone, the slot just stays unpublished
+        return ERR_INVALID_CAPACITY;
+    }
+
+    long offset;
+    int segment = get_segment((int)index, &offset);
+    atomic_long *values = publish_segment(header, segment);
+
+    if (values == NULL)
+    {
+        return ERR_MALLOC_FAILED;
+    }
+
+    // whoever opens a segment allocates the next one, off everyone else's path
+    if (offset == 0 && segment + 1 < CONCURRENT_SEGMENTS)
+    {
+        publish_segment(header, segment + 1);
+    }
+
+    atomic_store_explicit(&values[offset], value, memory_order_relaxed);
+    atomic_store_explicit(&get_ready_flags(values, segment)[offset], 1, memory_order_release);
+
+    return OK;
+}
+
+// Claimed slots, including those whose writers haven't published yet
+int concurrent_get_size(const concurrent_vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    long reserved = atomic_load_explicit(&header->reserved, memory_order_acquire);
+
+    return reserved > INT_MAX ? INT_MAX : (int)reserved;
+}
@@ -1,190 +1,205 @@
-#include <malloc.h>
+#include <stddef.h>
 #include "../include/deamortized_vector/header.h"
+#include "../include/deamortized_vector/generic.h"
 #include "../include/deamortized_vector/operations.h"
 #include "../include/vector/operations.h"
+#include "../include/batch/operations.h"
+#include "../include/sort/operations.h"
 
-static int get_capacity(const int capacity)
+DEFINE_DEAMORTIZED_VECTOR_OF(deamortized_vector, long, vector);
+
+deamortized_vector_header init_deamortized_vector(const ptrdiff_t capacity)
 {
-    return capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity;
+    return deamortized_vector_init(capacity);
 }
 
-deamortized_vector_header init_deamortized_vector(const int capacity)
+deamortized_vector_header init_deamortized_vector_with_allocator(const ptrdiff_t capacity, const vector_allocator *const allocator)
 {
-    // Made to avoid corner-cases with odd size.
-    // Removed: bad decision
-    // if (real_capacity % 2 != 0)
-    // {
-    //     real_capacity++;
-    // }
+    return deamortized_vector_init_with_allocator(capacity, allocator);
+}
 
-    int real_capacity = get_capacity(capacity);
+operation_result free_deamortized_vector(deamortized_vector_header *const header)
+{
+    return deamortized_vector_free(header);
+}
 
-    vector_header current = init_vector(real_capacity);
-    vector_header next = init_vector(real_capacity * 2);
+long deamortized_get(const deamortized_vector_header *const header, const ptrdiff_t index)
+{
+    long value;
+    operation_result result = deamortized_vector_get(header, index, &value);
 
-    return (deamortized_vector_header){
-        current,
-        next,
-        0};
+    return result == OK ? value : result;
 }
 
-operation_result free_deamortized_vector(deamortized_vector_header *header)
+operation_result deamortized_set(deamortized_vector_header *const header, const ptrdiff_t index, const long value)
 {
-    if (header == NULL)
-    {
-        return ERR_NULL;
-    }
-    operation_result result = free_vector(&header->next_vector);
-    if (result != OK)
-    {
-        return result;
-    }
+    return deamortized_vector_set(header, index, value);
+}
 
-    return free_vector(&header->current_vector);
+operation_result deamortized_insert(deamortized_vector_header *const header, const ptrdiff_t index, const long value)
+{
+    return deamortized_vector_insert(header, index, value);
 }
 
-long deamortized_get(const deamortized_vector_header *header, int index)
+operation_result deamortized_push_back(deamortized_vector_header *const header, const long value)
 {
-    if (header == NULL) {
-        return ERR_NULL;
-    }
-    
-    return get(&header->current_vector, index);
+    return deamortized_vector_push_back(header, value);
 }
 
-operation_result deamortized_set(deamortized_vector_header *const header, const int index, const long value)
+operation_result deamortized_erase(deamortized_vector_header *const header, const ptrdiff_t index)
 {
-    if (header == NULL) {
-        return ERR_NULL;
-    }
-    
-    if (index >= header->reallocated_amount)
-    {
-        return set(&header->current_vector, index, value);
-    }
+    return deamortized_vector_erase(header, index);
+}
 
-    operation_result result = set(&header->next_vector, index, value);
-    if (result != OK)
-    {
-        return result;
-    }
+operation_result deamortized_pop_back(deamortized_vector_header *const header)
+{
+    return deamortized_vector_pop_back(header);
+}
 
-    return set(&header->current_vector, index, value);
+ptrdiff_t get_size(const deamortized_vector_header *const header)
+{
+    return deamortized_vector_size(header);
 }
 
-operation_result deamortized_insert(deamortized_vector_header *const header, const int index, const long value)
+operation_result deamortized_insert_range(deamortized_vector_header *const header, const ptrdiff_t index, const long *values, const ptrdiff_t count)
 {
-    if (header == NULL) {
-        return ERR_NULL;
-    }
+    return deamortized_vector_insert_range(header, index, values, count);
+}
 
-    operation_result result;
+operation_result deamortized_erase_range(deamortized_vector_header *const header, const ptrdiff_t index, const ptrdiff_t count)
+{
+    return deamortized_vector_erase_range(header, index, count);
+}
 
-    if (index >= header->reallocated_amount)
-    {
-        result = insert(&header->current_vector, index, value);
-        if (result != OK)
-        {
-            return result;
-        }
-    }
-    else
-    {
-        result = insert(&header->next_vector, index, value);
-        if (result != OK)
-        {
-            return result;
-        }
+operation_result deamortized_push_back_n(deamortized_vector_header *const header, const ptrdiff_t count, const long value)
+{
+    return deamortized_vector_push_back_n(header, count, value);
+}
 
-        header->reallocated_amount++;
+operation_result deamortized_append_array(deamortized_vector_header *const header, const long *const values, const ptrdiff_t count)
+{
+    return deamortized_vector_append_array(header, values, count);
+}
 
-        result = insert(&header->current_vector, index, value);
-        if (result != OK)
-        {
-            return result;
-        }
+operation_result deamortized_assign(deamortized_vector_header *const header, const long *const values, const ptrdiff_t count)
+{
+    return deamortized_vector_assign(header, values, count);
+}
+
+operation_result deamortized_reserve(deamortized_vector_header *const header, const ptrdiff_t capacity)
+{
+    return deamortized_vector_reserve(header, capacity);
+}
+
+operation_result deamortized_resize(deamortized_vector_header *const header, const ptrdiff_t size, const long value)
+{
+    return deamortized_vector_resize(header, size, value);
+}
+
+operation_result deamortized_shrink_to_fit(deamortized_vector_header *const header)
+{
+    return deamortized_vector_shrink_to_fit(header);
+}
+
+// Sweeps current_vector once, like a single insert would, and rewinds
+// migration to the first changed element. The re-migration that can't wait,
+// so much that the rest still fits the target's free slots, happens in this
+// call as part of its O(n + k); only the remainder goes at the usual rate.
+operation_result deamortized_apply_batch(deamortized_vector_header *const header, const vector_edit *const edits, const ptrdiff_t count)
+{
+    if (header == NULL) {
+        return ERR_NULL;
     }
 
-    if (header->current_vector.size >= header->current_vector.capacity / 2)
+    if (deamortized_vector_is_invalid(header))
     {
-        result = push_back(&header->next_vector, get(&header->current_vector, header->reallocated_amount++));
+        return ERR_INVALID_HEADER;
+    }
 
-        if (result != OK)
-        {
-            return result;
-        }
+    batch_plan plan;
+    operation_result result = plan_batch(edits, count, header->current_vector.size, &plan);
+    if (result != OK)
+    {
+        return result;
+    }
 
-        if (header->current_vector.size != header->reallocated_amount)
-        {
-            result = push_back(&header->next_vector, get(&header->current_vector, header->reallocated_amount++));
+    // even a batch that doesn't grow can leave size where migration is due
+    ptrdiff_t growth = plan.size - header->current_vector.size;
+    result = deamortized_vector_make_room(header, growth > 0 ? growth : 0);
 
-            if (result != OK)
-            {
-                return result;
-            }
-        }
+    if (result == OK)
+    {
+        result = vector_prepare_write(&header->current_vector, plan.first_changed, plan.size - plan.first_changed);
     }
 
-    if (header->current_vector.size == header->current_vector.capacity)
+    if (result == OK)
     {
-        vector_header new_vector = init_vector(header->next_vector.capacity * 2);
+        ptrdiff_t moved = apply_batch_plan(header->current_vector.start_address, &plan);
+        STATS_ADD(deamortized_vector_get_stats(header), bytes_shifted, moved * sizeof(long));
+        header->current_vector.size = plan.size;
 
-        if (new_vector.is_allocated == 0)
+        if (header->reallocated_amount > plan.first_changed)
         {
-            return ERR_INVALID_HEADER;
+            header->reallocated_amount = plan.first_changed;
+            header->next_vector.size = plan.first_changed;
         }
 
-        free_vector(&header->current_vector);
-
-        header->current_vector = header->next_vector;
-        header->next_vector = new_vector;
-        header->reallocated_amount = 0;
+        deamortized_vector_start_shrink(header);
+        result = deamortized_vector_advance_migration(header, count);
     }
 
-    return OK;
-}
+    free_batch_plan(&plan);
 
-operation_result deamortized_push_back(deamortized_vector_header *const header, const long value)
-{
-    if (header == NULL) {
-        return ERR_NULL;
-    }
-
-    return deamortized_insert(header, header->current_vector.size, value);
+    return result;
 }
 
-operation_result deamortized_erase(deamortized_vector_header *const header, const int index)
+// Like deamortized_vector_sort_by(), but with the radix vector_sort()
+operation_result deamortized_sort(deamortized_vector_header *const header, const int finish_migration)
 {
     if (header == NULL) {
         return ERR_NULL;
     }
 
-    if (index >= header->reallocated_amount)
+    if (deamortized_vector_is_invalid(header))
     {
-        return erase(&header->current_vector, index);
+        return ERR_INVALID_HEADER;
     }
 
-    operation_result result = erase(&header->next_vector, index);
-    if (result != OK)
+    operation_result result = finish_migration ? deamortized_vector_complete_migration(header) : OK;
+    if (result == OK)
     {
-        return result;
+        result = vector_sort(&header->current_vector);
     }
 
-    header->reallocated_amount--;
+    return result == OK ? deamortized_vector_restart_migration(header) : result;
+}
 
-    return erase(&header->current_vector, index);
+operation_result deamortized_release_next(deamortized_vector_header *const header)
+{
+    return deamortized_vector_release_next(header);
 }
 
-operation_result deamortized_pop_back(deamortized_vector_header *const header)
+operation_result deamortized_set_migration_rate(deamortized_vector_header *const header, const int elements)
 {
-    return deamortized_erase(header, header->current_vector.size - 1);
+    return deamortized_vector_set_migration_rate(header, elements);
 }
 
-int get_size(const deamortized_vector_header *const header)
+operation_result deamortized_set_migration_bytes(deamortized_vector_header *const header, const long bytes)
 {
-    if (header == NULL) {
-        return ERR_NULL;
-    }
+    return deamortized_vector_set_migration_bytes(header, bytes);
+}
+
+operation_result deamortized_set_deferred_migration(deamortized_vector_header *const header, const int deferred)
+{
+    return deamortized_vector_set_deferred_migration(header, deferred);
+}
+
+operation_result deamortized_make_progress(deamortized_vector_header *const header, const ptrdiff_t budget)
+{
+    return deamortized_vector_make_progress(header, budget);
+}
 
-    return header->current_vector.size;
+ptrdiff_t deamortized_pending_migration(const deamortized_vector_header *const header)
+{
+    return deamortized_vector_pending_migration(header);
 }
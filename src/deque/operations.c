@@ -0,0 +1,353 @@
+#include <stdbool.h>
+#include "../include/deque/header.h"
+#include "../include/deque/operations.h"
+#include "../include/allocator/operations.h"
+
+static int is_invalid(const deque_header *const header)
+{
+    return !header->is_allocated;
+}
+
+static int get_capacity(const int capacity)
+{
+    int actual_capacity = MIN_CAPACITY;
+    while (actual_capacity < capacity && actual_capacity < MAX_DEQUE_CAPACITY)
+    {
+        actual_capacity *= 2;
+    }
+
+    return actual_capacity;
+}
+
+static long *get_address(const deque_ring *const ring, const int index)
+{
+    return ring->start_address + ((ring->head + index) & (ring->capacity - 1));
+}
+
+static deque_ring init_ring(const int capacity, const vector_allocator *const allocator)
+{
+    return (deque_ring){allocator_allocate(allocator, capacity * sizeof(long)), capacity, 0};
+}
+
+static void release_ring(deque_ring *const ring, const vector_allocator *const allocator)
+{
+    allocator_release(allocator, ring->start_address, ring->capacity * sizeof(long));
+    *ring = (deque_ring){NULL, 0, 0};
+}
+
+static int is_migrating(const deque_header *const header)
+{
+    return header->next.start_address != NULL;
+}
+
+static int is_migrated(const deque_header *const header, const int index)
+{
+    return is_migrating(header) && index >= header->migrated_front && index < header->migrated_back;
+}
+
+// next starts out empty, with head 0 so the elements land unwrapped
+static void start_migration(deque_header *const header)
+{
+    if (is_migrating(header) || header->size < header->current.capacity / 2 ||
+        header->current.capacity >= MAX_DEQUE_CAPACITY)
+    {
+        return;
+    }
+
+    deque_ring next = init_ring(header->current.capacity * 2, header->allocator);
+
+    // retried on the next operation, and only an error once the ring is full
+    if (next.start_address == NULL)
+    {
+        return;
+    }
+
+    header->next = next;
+    header->migrated_front = header->size;
+    header->migrated_back = header->size;
+}
+
+// Extends the migrated range towards the front first, then towards the back,
+// which pops may have left behind; swaps rings once it covers everything
+static void migrate(deque_header *const header, int amount)
+{
+    if (!is_migrating(header))
+    {
+        return;
+    }
+
+    for (; amount > 0 && header->migrated_front > 0; --amount)
+    {
+        int index = --header->migrated_front;
+        *get_address(&header->next, index) = *get_address(&header->current, index);
+    }
+
+    for (; amount > 0 && header->migrated_back < header->size; --amount)
+    {
+        int index = header->migrated_back++;
+        *get_address(&header->next, index) = *get_address(&header->current, index);
+    }
+
+    if (header->migrated_front == 0 && header->migrated_back == header->size)
+    {
+        release_ring(&header->current, header->allocator);
+        header->current = header->next;
+        header->next = (deque_ring){NULL, 0, 0};
+    }
+}
+
+static void advance_migration(deque_header *const header)
+{
+    start_migration(header);
+    migrate(header, DEQUE_MIGRATION_RATE);
+}
+
+// Migration normally finishes well before this; a full ring only happens when
+// allocating next failed earlier, or at MAX_DEQUE_CAPACITY
+static operation_result make_room(deque_header *const header)
+{
+    if (header->size < header->current.capacity)
+    {
+        return OK;
+    }
+
+    start_migration(header);
+    if (!is_migrating(header))
+    {
+        return header->current.capacity >= MAX_DEQUE_CAPACITY ? ERR_INVALID_CAPACITY : ERR_MALLOC_FAILED;
+    }
+
+    migrate(header, header->size);
+    return OK;
+}
+
+deque_header init_deque(const int capacity)
+{
+    return init_deque_with_allocator(capacity, NULL);
+}
+
+deque_header init_deque_with_allocator(const int capacity, const vector_allocator *const allocator)
+{
+    deque_header header = {0};
+
+    header.current = init_ring(get_capacity(capacity), allocator);
+    header.allocator = allocator;
+    header.is_allocated = header.current.start_address != NULL;
+
+    return header;
+}
+
+operation_result free_deque(deque_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (is_migrating(header))
+    {
+        release_ring(&header->next, header->allocator);
+    }
+
+    release_ring(&header->current, header->allocator);
+    header->is_allocated = false;
+    header->size = 0;
+
+    return OK;
+}
+
+long deque_get(const deque_header *const header, const int index)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (index < 0 || index >= header->size)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    return *get_address(&header->current, index);
+}
+
+operation_result deque_set(deque_header *const header, const int index, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (index < 0 || index >= header->size)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    *get_address(&header->current, index) = value;
+    if (is_migrated(header, index))
+    {
+        *get_address(&header->next, index) = value;
+    }
+
+    return OK;
+}
+
+operation_result deque_push_back(deque_header *const header, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    operation_result result = make_room(header);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    int index = header->size++;
+    *get_address(&header->current, index) = value;
+
+    // appending right after the migrated range keeps it growing for free
+    if (is_migrating(header) && header->migrated_back == index)
+    {
+        *get_address(&header->next, index) = value;
+        header->migrated_back++;
+    }
+
+    advance_migration(header);
+    return OK;
+}
+
+operation_result deque_push_front(deque_header *const header, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    operation_result result = make_room(header);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    header->current.head = (header->current.head - 1) & (header->current.capacity - 1);
+    header->size++;
+    *get_address(&header->current, 0) = value;
+
+    if (is_migrating(header))
+    {
+        header->next.head = (header->next.head - 1) & (header->next.capacity - 1);
+        header->migrated_front++;
+        header->migrated_back++;
+
+        if (header->migrated_front == 1)
+        {
+            *get_address(&header->next, 0) = value;
+            header->migrated_front = 0;
+        }
+    }
+
+    advance_migration(header);
+    return OK;
+}
+
+operation_result deque_pop_back(deque_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (header->size == 0)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    header->size--;
+
+    if (header->migrated_back > header->size)
+    {
+        header->migrated_back = header->size;
+    }
+
+    if (header->migrated_front > header->migrated_back)
+    {
+        header->migrated_front = header->migrated_back;
+    }
+
+    advance_migration(header);
+    return OK;
+}
+
+operation_result deque_pop_front(deque_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (header->size == 0)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    header->current.head = (header->current.head + 1) & (header->current.capacity - 1);
+    header->size--;
+
+    if (is_migrating(header))
+    {
+        header->next.head = (header->next.head + 1) & (header->next.capacity - 1);
+        header->migrated_front -= header->migrated_front > 0;
+        header->migrated_back -= header->migrated_back > 0;
+    }
+
+    advance_migration(header);
+    return OK;
+}
+
+int deque_get_size(const deque_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return header->size;
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+#include "allocator/header.h"
+#include "allocator/operations.h"
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stddef.h>
+
+// Size classes are powers of two from 2^MIN_POOL_CLASS_SHIFT bytes
+#define MIN_POOL_CLASS_SHIFT 6
+#define POOL_CLASSES 48
+
+// Where a vector gets its buffers from. Sizes are passed back on
+// reallocate/release so backends don't need per-block bookkeeping.
+// A NULL allocator means plain malloc/realloc/free.
+// prepare_write, when set, runs before a vector writes length bytes at offset
+// into a buffer and returns nonzero if they can't be made writable; a NULL
+// one means buffers are always written in place.
+typedef struct
+{
+    void *(*allocate)(void *context, size_t size);
+    void *(*reallocate)(void *context, void *address, size_t old_size, size_t new_size);
+    void (*release)(void *context, void *address, size_t size);
+    int (*prepare_write)(void *context, void *address, size_t offset, size_t length);
+    void *context;
+} vector_allocator;
+
+// Bump allocator over one region; everything is released at once by
+// reset_arena(). Only the most recent block can grow or be given back in place.
+typedef struct
+{
+    char *start_address;
+    size_t capacity;
+    size_t used;
+    size_t last_block;
+    vector_allocator allocator;
+} vector_arena;
+
+// Keeps released buffers on a free list per power-of-two size class, so the
+// buffers a deamortized vector keeps swapping are reused instead of going
+// back to malloc. Not thread-safe: meant to be owned by one thread.
+typedef struct
+{
+    void *free_lists[POOL_CLASSES];
+    int cached[POOL_CLASSES];
+    int max_cached_per_class;
+    long hits;
+    long misses;
+    vector_allocator allocator;
+} vector_pool;
+
+// Anonymous mmap for buffers of at least mmap_threshold bytes, which grow
+// with mremap, so page tables move instead of data. Buffers past
+// huge_page_threshold are advised to use transparent huge pages. With
+// prefault set, new pages are touched on allocation rather than on first use.
+// Smaller buffers come from malloc.
+typedef struct
+{
+    size_t mmap_threshold;
+    size_t huge_page_threshold;
+    int prefault;
+    long remaps;
+    vector_allocator allocator;
+} vector_mmap;
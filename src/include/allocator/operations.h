@@ -0,0 +1,20 @@
+#pragma once
+
+#include "header.h"
+
+void *allocator_allocate(const vector_allocator *const allocator, const size_t size);
+void *allocator_reallocate(const vector_allocator *const allocator, void *address, const size_t old_size, const size_t new_size);
+void allocator_release(const vector_allocator *const allocator, void *address, const size_t size);
+int allocator_prepare_write(const vector_allocator *const allocator, void *address, const size_t offset, const size_t length);
+
+vector_arena init_arena(const size_t capacity);
+void reset_arena(vector_arena *const arena);
+void free_arena(vector_arena *const arena);
+const vector_allocator *arena_allocator(vector_arena *const arena);
+
+vector_pool init_pool(const int max_cached_per_class);
+void free_pool(vector_pool *const pool);
+const vector_allocator *pool_allocator(vector_pool *const pool);
+
+vector_mmap init_mmap(const size_t mmap_threshold, const size_t huge_page_threshold, const int prefault);
+const vector_allocator *mmap_allocator(vector_mmap *const mapping);
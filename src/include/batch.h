@@ -0,0 +1,4 @@
+#pragma once
+
+#include "batch/header.h"
+#include "batch/operations.h"
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+
+typedef enum
+{
+    EDIT_INSERT,
+    EDIT_ERASE,
+    EDIT_SET
+} edit_kind;
+
+// Edits in a batch apply in order, each index referring to the vector as the
+// edits before it left it: the same result as the matching insert(), erase()
+// and set() calls one after another. value is ignored by EDIT_ERASE.
+typedef struct
+{
+    edit_kind kind;
+    ptrdiff_t index;
+    long value;
+} vector_edit;
+
+// One run of a resolved batch: length elements taken from source onwards,
+// either in the vector as it was or, with from_literals set, in literals
+typedef struct
+{
+    ptrdiff_t source;
+    ptrdiff_t length;
+    int from_literals;
+} batch_piece;
+
+// A batch resolved against a vector of a given size, in the order the
+// result lays out. Elements before first_changed stay where they are.
+typedef struct
+{
+    batch_piece *pieces;
+    ptrdiff_t piece_count;
+    long *literals;
+    ptrdiff_t literal_count;
+    ptrdiff_t size;
+    ptrdiff_t first_changed;
+} batch_plan;
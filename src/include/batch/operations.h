@@ -0,0 +1,14 @@
+#pragma once
+
+#include "header.h"
+#include "../operation_result.h"
+
+// Resolves count edits against a vector of size elements in O(k log k),
+// without touching the vector. ERR_OUT_OF_BOUNDS if any edit's index is
+// outside the vector as the edits before it left it.
+operation_result plan_batch(const vector_edit *const edits, const ptrdiff_t count, const ptrdiff_t size, batch_plan *const plan);
+// Rewrites values, holding the vector plan was made for, into the result in
+// one O(n + k) sweep. values needs room for both sizes; returns how many
+// elements moved.
+ptrdiff_t apply_batch_plan(long *const values, const batch_plan *const plan);
+void free_batch_plan(batch_plan *const plan);
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "../vector/header.h"
+#include "../deamortized_vector/header.h"
+#include "../operation_result.h"
+
+// The int-sized API from before sizes and indices became ptrdiff_t. Each call
+// forwards to the ptrdiff_t one and fails with ERR_INVALID_CAPACITY rather than
+// truncate a result past INT_MAX. Arguments passed by value never needed a
+// shim, an int widens on its own.
+operation_result vector_get_size_int(const vector_header *const header, int *const size);
+operation_result deamortized_get_size_int(const deamortized_vector_header *const header, int *const size);
+
+operation_result vector_find_int(const vector_header *const header, const long value, int *const index);
+operation_result vector_count_int(const vector_header *const header, const long value, int *const count);
+operation_result vector_argmin_int(const vector_header *const header, int *const index);
+operation_result deamortized_find_int(const deamortized_vector_header *const header, const long value, int *const index);
+operation_result deamortized_count_int(const deamortized_vector_header *const header, const long value, int *const count);
+operation_result deamortized_argmin_int(const deamortized_vector_header *const header, int *const index);
+
+operation_result sorted_lower_bound_int(const vector_header *const header, const long key, int *const index);
+operation_result sorted_upper_bound_int(const vector_header *const header, const long key, int *const index);
+operation_result sorted_erase_int(vector_header *const header, const long key, int *const erased);
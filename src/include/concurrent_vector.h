@@ -0,0 +1,4 @@
+#pragma once
+
+#include "concurrent_vector/header.h"
+#include "concurrent_vector/operations.h"
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdatomic.h>
+
+// Segment k holds 2^(FIRST_SEGMENT_SHIFT + k) elements, enough segments to
+// address every int index
+#define FIRST_SEGMENT_SHIFT 5
+#define CONCURRENT_SEGMENTS (32 - FIRST_SEGMENT_SHIFT)
+
+// Append-only vector for many threads. Appenders claim an index with one
+// fetch-add on reserved, write the element and then raise its ready flag.
+// A segment is its elements followed by one ready flag per element, and
+// segments never move once published, so growth is a single pointer CAS and
+// readers never wait on it. Only free_concurrent_vector needs the other
+// threads to be done, and the header must not be copied once shared.
+typedef struct
+{
+    int is_allocated;
+    _Atomic(atomic_long *) segments[CONCURRENT_SEGMENTS];
+    atomic_long reserved;
+} concurrent_vector_header;
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "header.h"
+#include "../operation_result.h"
+
+concurrent_vector_header init_concurrent_vector(void);
+operation_result free_concurrent_vector(concurrent_vector_header *const header);
+operation_result concurrent_get(const concurrent_vector_header *const header, const int index, long *const value);
+operation_result concurrent_set(concurrent_vector_header *const header, const int index, const long value);
+operation_result concurrent_push_back(concurrent_vector_header *const header, const long value);
+int concurrent_get_size(const concurrent_vector_header *const header);
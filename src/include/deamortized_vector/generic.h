@@ -0,0 +1,1131 @@
+#pragma once
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../vector/generic.h"
+#include "header.h"
+
+// The one implementation of the deamortized vector, for any element type T:
+//
+//     DECLARE_DEAMORTIZED_VECTOR(int32_deamortized_vector, int32_t);
+//     DEFINE_DEAMORTIZED_VECTOR(int32_deamortized_vector, int32_t);
+//
+// Both buffers are name##_buffer vectors, instantiated along with it. The
+// _OF variants build on an existing vector instance instead: the long
+// deamortized_vector runs on vector, and operations.h wraps it in the classic
+// init_deamortized_vector(), deamortized_get() and so on.
+
+#define DECLARE_DEAMORTIZED_VECTOR_OPERATIONS(name, T)                                                                            \
+name##_header name##_init(const ptrdiff_t capacity);                                                                              \
+name##_header name##_init_with_allocator(const ptrdiff_t capacity, const vector_allocator *const allocator);                      \
+operation_result name##_free(name##_header *const header);                                                                        \
+operation_result name##_get(const name##_header *const header, const ptrdiff_t index, T *const value);                            \
+operation_result name##_set(name##_header *const header, const ptrdiff_t index, const T value);                                   \
+operation_result name##_insert(name##_header *const header, const ptrdiff_t index, const T value);                                \
+operation_result name##_push_back(name##_header *const header, const T value);                                                    \
+operation_result name##_erase(name##_header *const header, const ptrdiff_t index);                                                \
+operation_result name##_pop_back(name##_header *const header);                                                                    \
+ptrdiff_t name##_size(const name##_header *const header);                                                                         \
+operation_result name##_insert_range(name##_header *const header, const ptrdiff_t index, const T *values, const ptrdiff_t count); \
+operation_result name##_erase_range(name##_header *const header, const ptrdiff_t index, const ptrdiff_t count);                   \
+operation_result name##_push_back_n(name##_header *const header, const ptrdiff_t count, const T value);                           \
+operation_result name##_append_array(name##_header *const header, const T *const values, const ptrdiff_t count);                  \
+operation_result name##_assign(name##_header *const header, const T *const values, const ptrdiff_t count);                        \
+operation_result name##_reserve(name##_header *const header, const ptrdiff_t capacity);                                           \
+operation_result name##_resize(name##_header *const header, const ptrdiff_t size, const T value);                                 \
+operation_result name##_shrink_to_fit(name##_header *const header);                                                               \
+operation_result name##_sort_by(name##_header *const header, const sort_compare compare, const int finish_migration);             \
+operation_result name##_release_next(name##_header *const header);                                                                \
+operation_result name##_set_migration_rate(name##_header *const header, const int elements);                                      \
+operation_result name##_set_migration_bytes(name##_header *const header, const long bytes);                                       \
+operation_result name##_set_deferred_migration(name##_header *const header, const int deferred);                                  \
+operation_result name##_make_progress(name##_header *const header, const ptrdiff_t budget);                                       \
+ptrdiff_t name##_pending_migration(const name##_header *const header)
+
+#define DECLARE_DEAMORTIZED_VECTOR_OF(name, T, buffer) \
+DECLARE_DEAMORTIZED_VECTOR_HEADER(name, buffer);       \
+DECLARE_DEAMORTIZED_VECTOR_OPERATIONS(name, T)
+
+#define DECLARE_DEAMORTIZED_VECTOR(name, T)           \
+DECLARE_VECTOR(name##_buffer, T);                     \
+DECLARE_DEAMORTIZED_VECTOR_OF(name, T, name##_buffer)
+
+#define DEFINE_DEAMORTIZED_VECTOR(name, T)           \
+DEFINE_VECTOR(name##_buffer, T);                     \
+DEFINE_DEAMORTIZED_VECTOR_OF(name, T, name##_buffer)
+
+#define DEFINE_DEAMORTIZED_VECTOR_OF(name, T, buffer)                                                                            \
+static ptrdiff_t name##_get_capacity(const ptrdiff_t capacity)                                                                   \
+{                                                                                                                                \
+    return capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity;                                                                    \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Buffers are resized by migration only, never by the vector operations on them */                                              \
+static buffer##_header name##_init_buffer(const ptrdiff_t capacity, const vector_allocator *const allocator,                     \
+                                          vector_stats *const stats)                                                             \
+{                                                                                                                                \
+    buffer##_header result;                                                                                                      \
+                                                                                                                                 \
+    STATS_ALLOCATOR_CALL(stats, result = buffer##_init_with_allocator(capacity, allocator));                                     \
+    STATS_MAX(stats, peak_capacity, result.capacity);                                                                            \
+    result.auto_shrink = 0;                                                                                                      \
+    result.stats = stats;                                                                                                        \
+                                                                                                                                 \
+    return result;                                                                                                               \
+}                                                                                                                                \
+                                                                                                                                 \
+/* An unallocated next_vector that still remembers the allocator and stats */                                                    \
+static buffer##_header name##_no_buffer(const vector_allocator *const allocator, vector_stats *const stats)                      \
+{                                                                                                                                \
+    buffer##_header result = buffer##_init_with_allocator(0, allocator);                                                         \
+    result.stats = stats;                                                                                                        \
+                                                                                                                                 \
+    return result;                                                                                                               \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Both buffers share one vector_stats, so current_vector's is the container's */                                                \
+static vector_stats *name##_get_stats(const name##_header *const header)                                                         \
+{                                                                                                                                \
+    return header->current_vector.stats;                                                                                         \
+}                                                                                                                                \
+                                                                                                                                 \
+static void name##_record_migration(const name##_header *const header)                                                           \
+{                                                                                                                                \
+    STATS_SET(name##_get_stats(header), migrated, header->reallocated_amount);                                                   \
+    STATS_SET(name##_get_stats(header), size, header->current_vector.size);                                                      \
+}                                                                                                                                \
+                                                                                                                                 \
+/* next_vector only exists while something is migrating into it */                                                               \
+static int name##_has_next(const name##_header *const header)                                                                    \
+{                                                                                                                                \
+    return header->next_vector.is_allocated;                                                                                     \
+}                                                                                                                                \
+                                                                                                                                 \
+/* A next_vector smaller than current_vector is the target of a shrink */                                                        \
+static int name##_is_shrinking(const name##_header *const header)                                                                \
+{                                                                                                                                \
+    return name##_has_next(header) && header->next_vector.capacity < header->current_vector.capacity;                            \
+}                                                                                                                                \
+                                                                                                                                 \
+static int name##_is_invalid(const name##_header *const header)                                                                  \
+{                                                                                                                                \
+    return !header->current_vector.is_allocated;                                                                                 \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Size from which next_vector is kept around. Deferred migration allocates it                                                   \
+   earlier, so make_progress() gets a head start before inserts have to catch                                                    \
+   up; still above the quarter that shrinking starts at. */                                                                      \
+static ptrdiff_t name##_growth_threshold(const name##_header *const header)                                                      \
+{                                                                                                                                \
+    ptrdiff_t capacity = header->current_vector.capacity;                                                                        \
+                                                                                                                                 \
+    return header->deferred_migration ? capacity / 2 - capacity / 8 : capacity / 2;                                              \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Whether next_vector is being migrated into, rather than allocated early or                                                    \
+   left over from a migration that is no longer due */                                                                           \
+static int name##_is_migration_due(const name##_header *const header)                                                            \
+{                                                                                                                                \
+    return name##_has_next(header) &&                                                                                            \
+           (name##_is_shrinking(header) || header->reserving ||                                                                  \
+            header->current_vector.size >= name##_growth_threshold(header));                                                     \
+}                                                                                                                                \
+                                                                                                                                 \
+static void name##_drop_next(name##_header *const header)                                                                        \
+{                                                                                                                                \
+    if (name##_has_next(header))                                                                                                 \
+    {                                                                                                                            \
+        buffer##_free(&header->next_vector);                                                                                     \
+    }                                                                                                                            \
+                                                                                                                                 \
+    header->next_vector = name##_no_buffer(header->current_vector.allocator, name##_get_stats(header));                          \
+    header->reallocated_amount = 0;                                                                                              \
+    header->reserving = 0;                                                                                                       \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Allocates the growth buffer when migration is about to begin */                                                               \
+static operation_result name##_ensure_next(name##_header *const header)                                                          \
+{                                                                                                                                \
+    if (name##_has_next(header))                                                                                                 \
+    {                                                                                                                            \
+        return OK;                                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (header->current_vector.capacity > MAX_CAPACITY_OF(T) / 2)                                                                \
+    {                                                                                                                            \
+        return ERR_INVALID_CAPACITY;                                                                                             \
+    }                                                                                                                            \
+                                                                                                                                 \
+    buffer##_header next = name##_init_buffer(header->current_vector.capacity * 2, header->current_vector.allocator,             \
+                                              name##_get_stats(header));                                                         \
+                                                                                                                                 \
+    if (!next.is_allocated)                                                                                                      \
+    {                                                                                                                            \
+        return ERR_MALLOC_FAILED;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    header->next_vector = next;                                                                                                  \
+    header->reallocated_amount = 0;                                                                                              \
+    STATS_ADD(name##_get_stats(header), grows, 1);                                                                               \
+                                                                                                                                 \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Copies up to amount not-yet-migrated elements into next_vector in one block.                                                  \
+   next_vector can be a former current_vector that snapshots still see. */                                                       \
+static operation_result name##_migrate(name##_header *const header, const ptrdiff_t amount)                                      \
+{                                                                                                                                \
+    ptrdiff_t remaining = header->current_vector.size - header->reallocated_amount;                                              \
+    ptrdiff_t count = amount < remaining ? amount : remaining;                                                                   \
+                                                                                                                                 \
+    if (count <= 0)                                                                                                              \
+    {                                                                                                                            \
+        return OK;                                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    operation_result result = buffer##_prepare_write(&header->next_vector, header->next_vector.size, count);                     \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    memcpy(header->next_vector.start_address + header->next_vector.size,                                                         \
+           header->current_vector.start_address + header->reallocated_amount,                                                    \
+           count * sizeof(T));                                                                                                   \
+    STATS_ADD(name##_get_stats(header), bytes_migrated, count * sizeof(T));                                                      \
+                                                                                                                                 \
+    header->next_vector.size += count;                                                                                           \
+    header->reallocated_amount += count;                                                                                         \
+                                                                                                                                 \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+static void name##_swap_vectors(name##_header *const header)                                                                     \
+{                                                                                                                                \
+    STATS_ADD(name##_get_stats(header), swaps, 1);                                                                               \
+    buffer##_free(&header->current_vector);                                                                                      \
+                                                                                                                                 \
+    header->current_vector = header->next_vector;                                                                                \
+    header->next_vector = name##_no_buffer(header->current_vector.allocator, name##_get_stats(header));                          \
+    header->reallocated_amount = 0;                                                                                              \
+    header->reserving = 0;                                                                                                       \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Starts migrating into a buffer of half the capacity once size drops below a                                                   \
+   quarter of it. Starting that low means migration, at MIN_MIGRATION_RATE                                                       \
+   elements per operation, always completes before size could outgrow the                                                        \
+   smaller buffer. */                                                                                                            \
+static void name##_start_shrink(name##_header *const header)                                                                     \
+{                                                                                                                                \
+    ptrdiff_t capacity = header->current_vector.capacity;                                                                        \
+                                                                                                                                 \
+    if (name##_is_shrinking(header) || capacity / 2 < MIN_CAPACITY || header->current_vector.size >= capacity / 4)               \
+    {                                                                                                                            \
+        return;                                                                                                                  \
+    }                                                                                                                            \
+                                                                                                                                 \
+    buffer##_header smaller = name##_init_buffer(capacity / 2, header->current_vector.allocator, name##_get_stats(header));      \
+                                                                                                                                 \
+    /* shrinking only saves memory, so failing to do it is not an error */                                                       \
+    if (!smaller.is_allocated)                                                                                                   \
+    {                                                                                                                            \
+        return;                                                                                                                  \
+    }                                                                                                                            \
+                                                                                                                                 \
+    name##_drop_next(header);                                                                                                    \
+    header->next_vector = smaller;                                                                                               \
+    STATS_ADD(name##_get_stats(header), shrinks, 1);                                                                             \
+}                                                                                                                                \
+                                                                                                                                 \
+/* The old current_vector is an exact copy at twice the new capacity. If growth                                                  \
+   migration is already due, that is precisely a fully migrated next_vector;                                                     \
+   otherwise it is idle memory. */                                                                                               \
+static void name##_finish_shrink(name##_header *const header)                                                                    \
+{                                                                                                                                \
+    buffer##_header previous = header->current_vector;                                                                           \
+                                                                                                                                 \
+    STATS_ADD(name##_get_stats(header), swaps, 1);                                                                               \
+    header->current_vector = header->next_vector;                                                                                \
+                                                                                                                                 \
+    if (header->current_vector.size >= name##_growth_threshold(header))                                                          \
+    {                                                                                                                            \
+        header->next_vector = previous;                                                                                          \
+        header->reallocated_amount = header->current_vector.size;                                                                \
+    }                                                                                                                            \
+    else                                                                                                                         \
+    {                                                                                                                            \
+        buffer##_free(&previous);                                                                                                \
+        header->next_vector = name##_no_buffer(header->current_vector.allocator, name##_get_stats(header));                      \
+        header->reallocated_amount = 0;                                                                                          \
+    }                                                                                                                            \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Copies current_vector into a fresh buffer of capacity in one go, dropping                                                     \
+   next_vector along with whatever migration it was for */                                                                       \
+static operation_result name##_replace_current(name##_header *const header, const ptrdiff_t capacity)                            \
+{                                                                                                                                \
+    buffer##_header current = name##_init_buffer(capacity, header->current_vector.allocator, name##_get_stats(header));          \
+                                                                                                                                 \
+    if (!current.is_allocated)                                                                                                   \
+    {                                                                                                                            \
+        return ERR_MALLOC_FAILED;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    memcpy(current.start_address, header->current_vector.start_address, header->current_vector.size * sizeof(T));                \
+    STATS_ADD(name##_get_stats(header), bytes_migrated, header->current_vector.size * sizeof(T));                                \
+    current.size = header->current_vector.size;                                                                                  \
+                                                                                                                                 \
+    name##_drop_next(header);                                                                                                    \
+    buffer##_free(&header->current_vector);                                                                                      \
+    header->current_vector = current;                                                                                            \
+                                                                                                                                 \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+/* The capacity, current_vector's doubled as often as it takes, at which                                                         \
+   required elements leave it at most half full */                                                                               \
+static operation_result name##_half_full_capacity(const name##_header *const header, const ptrdiff_t required,                   \
+                                                  ptrdiff_t *const capacity)                                                     \
+{                                                                                                                                \
+    /* next_vector will need twice the capacity again */                                                                         \
+    if (required > MAX_CAPACITY_OF(T) / 4)                                                                                       \
+    {                                                                                                                            \
+        return ERR_INVALID_CAPACITY;                                                                                             \
+    }                                                                                                                            \
+                                                                                                                                 \
+    *capacity = header->current_vector.capacity;                                                                                 \
+    while (*capacity < 2 * required)                                                                                             \
+    {                                                                                                                            \
+        *capacity *= 2;                                                                                                          \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return *capacity > MAX_CAPACITY_OF(T) / 2 ? ERR_INVALID_CAPACITY : OK;                                                       \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Replaces current_vector with a fresh one at most half full, for bulk                                                          \
+   operations that would overflow even next_vector */                                                                            \
+static operation_result name##_rebuild(name##_header *const header, const ptrdiff_t required)                                    \
+{                                                                                                                                \
+    ptrdiff_t capacity;                                                                                                          \
+    operation_result result = name##_half_full_capacity(header, required, &capacity);                                            \
+                                                                                                                                 \
+    if (result == OK)                                                                                                            \
+    {                                                                                                                            \
+        result = name##_replace_current(header, capacity);                                                                       \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (result == OK)                                                                                                            \
+    {                                                                                                                            \
+        STATS_ADD(name##_get_stats(header), grows, 1);                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return result;                                                                                                               \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Ensures current_vector can take count more elements without reallocating */                                                   \
+static operation_result name##_make_room(name##_header *const header, const ptrdiff_t count)                                     \
+{                                                                                                                                \
+    if (count > MAX_CAPACITY_OF(T) - header->current_vector.size)                                                                \
+    {                                                                                                                            \
+        return ERR_INVALID_CAPACITY;                                                                                             \
+    }                                                                                                                            \
+                                                                                                                                 \
+    ptrdiff_t required = header->current_vector.size + count;                                                                    \
+                                                                                                                                 \
+    if (name##_is_shrinking(header))                                                                                             \
+    {                                                                                                                            \
+        if (required < header->next_vector.capacity)                                                                             \
+        {                                                                                                                        \
+            return OK;                                                                                                           \
+        }                                                                                                                        \
+                                                                                                                                 \
+        /* it would not fit in the shrink target, so give up on shrinking */                                                     \
+        name##_drop_next(header);                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (required > header->current_vector.capacity)                                                                              \
+    {                                                                                                                            \
+        operation_result result;                                                                                                 \
+                                                                                                                                 \
+        if (!name##_has_next(header) || required > header->next_vector.capacity)                                                 \
+        {                                                                                                                        \
+            result = name##_rebuild(header, required);                                                                           \
+        }                                                                                                                        \
+        else                                                                                                                     \
+        {                                                                                                                        \
+            /* migration is nearly done by the time current_vector fills up, so this is cheap */                                 \
+            result = name##_migrate(header, header->current_vector.size - header->reallocated_amount);                           \
+            if (result == OK)                                                                                                    \
+            {                                                                                                                    \
+                name##_swap_vectors(header);                                                                                     \
+            }                                                                                                                    \
+        }                                                                                                                        \
+                                                                                                                                 \
+        if (result != OK)                                                                                                        \
+        {                                                                                                                        \
+            return result;                                                                                                       \
+        }                                                                                                                        \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return required >= name##_growth_threshold(header) ? name##_ensure_next(header) : OK;                                        \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Elements to migrate after an operation on count elements: migration_rate                                                      \
+   per element, or more if that would leave more elements to migrate than free                                                   \
+   slots in the target, so migration is complete before it could overflow.                                                       \
+   Deferred migration only does the latter. */                                                                                   \
+static ptrdiff_t name##_migration_amount(const name##_header *const header, const ptrdiff_t count,                               \
+                                         const ptrdiff_t target_capacity)                                                        \
+{                                                                                                                                \
+    ptrdiff_t remaining = header->current_vector.size - header->reallocated_amount;                                              \
+    ptrdiff_t slack = target_capacity - header->current_vector.size;                                                             \
+    ptrdiff_t amount = 0;                                                                                                        \
+                                                                                                                                 \
+    /* capped at remaining, without computing a rate * count that could overflow */                                              \
+    if (!header->deferred_migration)                                                                                             \
+    {                                                                                                                            \
+        amount = count > remaining / header->migration_rate ? remaining : header->migration_rate * count;                        \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return remaining - slack > amount ? remaining - slack : amount;                                                              \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Catches migration up after an operation on count elements */                                                                  \
+static operation_result name##_advance_migration(name##_header *const header, const ptrdiff_t count)                             \
+{                                                                                                                                \
+    operation_result result = OK;                                                                                                \
+                                                                                                                                 \
+    if (name##_is_shrinking(header))                                                                                             \
+    {                                                                                                                            \
+        result = name##_migrate(header, name##_migration_amount(header, count, header->next_vector.capacity));                   \
+                                                                                                                                 \
+        if (result != OK || header->reallocated_amount != header->current_vector.size)                                           \
+        {                                                                                                                        \
+            name##_record_migration(header);                                                                                     \
+            return result;                                                                                                       \
+        }                                                                                                                        \
+                                                                                                                                 \
+        name##_finish_shrink(header);                                                                                            \
+    }                                                                                                                            \
+    else if (header->reserving || header->current_vector.size >= header->current_vector.capacity / 2)                            \
+    {                                                                                                                            \
+        result = name##_migrate(header, name##_migration_amount(header, count, header->current_vector.capacity));                \
+                                                                                                                                 \
+        /* current_vector can't be dropped while part of it is still unmigrated */                                               \
+        if (result != OK)                                                                                                        \
+        {                                                                                                                        \
+            name##_record_migration(header);                                                                                     \
+            return result;                                                                                                       \
+        }                                                                                                                        \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (header->current_vector.size == header->current_vector.capacity ||                                                        \
+        (header->reserving && header->reallocated_amount == header->current_vector.size))                                        \
+    {                                                                                                                            \
+        name##_swap_vectors(header);                                                                                             \
+    }                                                                                                                            \
+                                                                                                                                 \
+    name##_record_migration(header);                                                                                             \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Copies whatever is left and switches over, leaving a single buffer unless a                                                   \
+   shrink hands back one that growth migration is already due for */                                                             \
+static operation_result name##_complete_migration(name##_header *const header)                                                   \
+{                                                                                                                                \
+    if (!name##_has_next(header))                                                                                                \
+    {                                                                                                                            \
+        return OK;                                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    /* a growth buffer that migration isn't due for yet holds nothing worth keeping */                                           \
+    if (!name##_is_migration_due(header))                                                                                        \
+    {                                                                                                                            \
+        name##_drop_next(header);                                                                                                \
+        return OK;                                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    operation_result result = name##_migrate(header, header->current_vector.size - header->reallocated_amount);                  \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_shrinking(header))                                                                                             \
+    {                                                                                                                            \
+        name##_finish_shrink(header);                                                                                            \
+    }                                                                                                                            \
+    else                                                                                                                         \
+    {                                                                                                                            \
+        name##_swap_vectors(header);                                                                                             \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+/* After current_vector is reordered in place whatever next_vector holds is in                                                   \
+   the old order, so migration starts over; copying now whatever can't fit the                                                   \
+   target's free slots is O(n) like the reordering, and leaves the following                                                     \
+   operations at the usual rate */                                                                                               \
+static operation_result name##_restart_migration(name##_header *const header)                                                    \
+{                                                                                                                                \
+    if (name##_has_next(header))                                                                                                 \
+    {                                                                                                                            \
+        header->next_vector.size = 0;                                                                                            \
+        header->reallocated_amount = 0;                                                                                          \
+                                                                                                                                 \
+        return name##_advance_migration(header, 0);                                                                              \
+    }                                                                                                                            \
+                                                                                                                                 \
+    name##_record_migration(header);                                                                                             \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+static int name##_is_in_buffer(const buffer##_header *const vector, const T *const values)                                       \
+{                                                                                                                                \
+    uintptr_t address = (uintptr_t)values;                                                                                       \
+    uintptr_t start = (uintptr_t)vector->start_address;                                                                          \
+                                                                                                                                 \
+    return vector->is_allocated && address >= start && address - start < (uintptr_t)vector->capacity * sizeof(T);                \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Growth can swap or rebuild either buffer before values are read, so values                                                    \
+   from inside them are copied out first; *copy is NULL if that wasn't needed */                                                 \
+static operation_result name##_copy_own_values(const name##_header *const header, const T **const values,                        \
+                                               const ptrdiff_t count, T **const copy)                                            \
+{                                                                                                                                \
+    *copy = NULL;                                                                                                                \
+                                                                                                                                 \
+    if (count <= 0 || (!name##_is_in_buffer(&header->current_vector, *values) &&                                                 \
+                       !name##_is_in_buffer(&header->next_vector, *values)))                                                     \
+    {                                                                                                                            \
+        return OK;                                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    *copy = malloc(count * sizeof(T));                                                                                           \
+    if (*copy == NULL)                                                                                                           \
+    {                                                                                                                            \
+        return ERR_MALLOC_FAILED;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    memcpy(*copy, *values, count * sizeof(T));                                                                                   \
+    *values = *copy;                                                                                                             \
+                                                                                                                                 \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+static operation_result name##_insert_values(name##_header *const header, const ptrdiff_t index, const T *const values,          \
+                                             const ptrdiff_t count)                                                              \
+{                                                                                                                                \
+    if (index < 0 || index > header->current_vector.size || count < 0)                                                           \
+    {                                                                                                                            \
+        return ERR_OUT_OF_BOUNDS;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    operation_result result = name##_make_room(header, count);                                                                   \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (index < header->reallocated_amount)                                                                                      \
+    {                                                                                                                            \
+        result = buffer##_insert_range(&header->next_vector, index, values, count);                                              \
+        if (result != OK)                                                                                                        \
+        {                                                                                                                        \
+            return result;                                                                                                       \
+        }                                                                                                                        \
+                                                                                                                                 \
+        header->reallocated_amount += count;                                                                                     \
+    }                                                                                                                            \
+                                                                                                                                 \
+    result = buffer##_insert_range(&header->current_vector, index, values, count);                                               \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_advance_migration(header, count);                                                                              \
+}                                                                                                                                \
+                                                                                                                                 \
+name##_header name##_init(const ptrdiff_t capacity)                                                                              \
+{                                                                                                                                \
+    return name##_init_with_allocator(capacity, NULL);                                                                           \
+}                                                                                                                                \
+                                                                                                                                 \
+name##_header name##_init_with_allocator(const ptrdiff_t capacity, const vector_allocator *const allocator)                      \
+{                                                                                                                                \
+    buffer##_header current = name##_init_buffer(name##_get_capacity(capacity), allocator, NULL);                                \
+                                                                                                                                 \
+    return (name##_header){current, name##_no_buffer(allocator, NULL), 0, DEFAULT_MIGRATION_RATE, 0, 0};                         \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_free(name##_header *const header)                                                                        \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    name##_drop_next(header);                                                                                                    \
+                                                                                                                                 \
+    return buffer##_free(&header->current_vector);                                                                               \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_get(const name##_header *const header, const ptrdiff_t index, T *const value)                            \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return buffer##_get(&header->current_vector, index, value);                                                                  \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_set(name##_header *const header, const ptrdiff_t index, const T value)                                   \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (index < 0 || index >= header->reallocated_amount)                                                                        \
+    {                                                                                                                            \
+        return buffer##_set(&header->current_vector, index, value);                                                              \
+    }                                                                                                                            \
+                                                                                                                                 \
+    operation_result result = buffer##_set(&header->next_vector, index, value);                                                  \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return buffer##_set(&header->current_vector, index, value);                                                                  \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_insert(name##_header *const header, const ptrdiff_t index, const T value)                                \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    operation_result result;                                                                                                     \
+                                                                                                                                 \
+    if (index >= 0 && index <= header->current_vector.size &&                                                                    \
+        header->current_vector.size + 1 >= name##_growth_threshold(header))                                                      \
+    {                                                                                                                            \
+        result = name##_ensure_next(header);                                                                                     \
+        if (result != OK)                                                                                                        \
+        {                                                                                                                        \
+            return result;                                                                                                       \
+        }                                                                                                                        \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (index < header->reallocated_amount)                                                                                      \
+    {                                                                                                                            \
+        result = buffer##_insert(&header->next_vector, index, value);                                                            \
+        if (result != OK)                                                                                                        \
+        {                                                                                                                        \
+            return result;                                                                                                       \
+        }                                                                                                                        \
+                                                                                                                                 \
+        header->reallocated_amount++;                                                                                            \
+    }                                                                                                                            \
+                                                                                                                                 \
+    result = buffer##_insert(&header->current_vector, index, value);                                                             \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_advance_migration(header, 1);                                                                                  \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_push_back(name##_header *const header, const T value)                                                    \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_insert(header, header->current_vector.size, value);                                                            \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_erase(name##_header *const header, const ptrdiff_t index)                                                \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_erase_range(header, index, 1);                                                                                 \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_pop_back(name##_header *const header)                                                                    \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_erase(header, header->current_vector.size - 1);                                                                \
+}                                                                                                                                \
+                                                                                                                                 \
+ptrdiff_t name##_size(const name##_header *const header)                                                                         \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return header->current_vector.size;                                                                                          \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_insert_range(name##_header *const header, const ptrdiff_t index, const T *values, const ptrdiff_t count) \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (values == NULL && count > 0)                                                                                             \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    T *copy;                                                                                                                     \
+    operation_result result = name##_copy_own_values(header, &values, count, &copy);                                             \
+    if (result == OK)                                                                                                            \
+    {                                                                                                                            \
+        result = name##_insert_values(header, index, values, count);                                                             \
+    }                                                                                                                            \
+                                                                                                                                 \
+    free(copy);                                                                                                                  \
+    return result;                                                                                                               \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_erase_range(name##_header *const header, const ptrdiff_t index, const ptrdiff_t count)                   \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (index < 0 || count < 0 || index > header->current_vector.size - count)                                                   \
+    {                                                                                                                            \
+        return ERR_OUT_OF_BOUNDS;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    operation_result result;                                                                                                     \
+                                                                                                                                 \
+    if (index < header->reallocated_amount)                                                                                      \
+    {                                                                                                                            \
+        ptrdiff_t migrated_end = index + count < header->reallocated_amount ? index + count : header->reallocated_amount;        \
+                                                                                                                                 \
+        result = buffer##_erase_range(&header->next_vector, index, migrated_end - index);                                        \
+        if (result != OK)                                                                                                        \
+        {                                                                                                                        \
+            return result;                                                                                                       \
+        }                                                                                                                        \
+                                                                                                                                 \
+        header->reallocated_amount -= migrated_end - index;                                                                      \
+    }                                                                                                                            \
+                                                                                                                                 \
+    result = buffer##_erase_range(&header->current_vector, index, count);                                                        \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    name##_start_shrink(header);                                                                                                 \
+                                                                                                                                 \
+    return name##_is_shrinking(header) ? name##_advance_migration(header, count) : OK;                                           \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_push_back_n(name##_header *const header, const ptrdiff_t count, const T value)                           \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (count < 0)                                                                                                               \
+    {                                                                                                                            \
+        return ERR_OUT_OF_BOUNDS;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    operation_result result = name##_make_room(header, count);                                                                   \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    result = buffer##_push_back_n(&header->current_vector, count, value);                                                        \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_advance_migration(header, count);                                                                              \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_append_array(name##_header *const header, const T *const values, const ptrdiff_t count)                  \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_insert_range(header, header->current_vector.size, values, count);                                              \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_assign(name##_header *const header, const T *const values, const ptrdiff_t count)                        \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (values == NULL && count > 0)                                                                                             \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (count < 0)                                                                                                               \
+    {                                                                                                                            \
+        return ERR_OUT_OF_BOUNDS;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    /* drop the old contents and any migration progress, then refill in one pass */                                              \
+    header->current_vector.size = 0;                                                                                             \
+    header->next_vector.size = 0;                                                                                                \
+    header->reallocated_amount = 0;                                                                                              \
+                                                                                                                                 \
+    return name##_insert_range(header, 0, values, count);                                                                        \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Migrates into a buffer capacity elements fill at most halfway, swapped in once reserving has filled it */                     \
+operation_result name##_reserve(name##_header *const header, const ptrdiff_t capacity)                                           \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    ptrdiff_t target;                                                                                                            \
+    operation_result result = name##_half_full_capacity(header, capacity, &target);                                              \
+    if (result != OK || target == header->current_vector.capacity)                                                               \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (header->current_vector.size <= RESIZE_DIRECT_SIZE)                                                                       \
+    {                                                                                                                            \
+        result = name##_replace_current(header, target);                                                                         \
+    }                                                                                                                            \
+    else if (name##_has_next(header) && header->next_vector.capacity >= target)                                                  \
+    {                                                                                                                            \
+        /* the growth buffer is big enough already, it only has to be filled now */                                              \
+        header->reserving = 1;                                                                                                   \
+    }                                                                                                                            \
+    else                                                                                                                         \
+    {                                                                                                                            \
+        buffer##_header next = name##_init_buffer(target, header->current_vector.allocator, name##_get_stats(header));           \
+                                                                                                                                 \
+        if (!next.is_allocated)                                                                                                  \
+        {                                                                                                                        \
+            return ERR_MALLOC_FAILED;                                                                                            \
+        }                                                                                                                        \
+                                                                                                                                 \
+        name##_drop_next(header);                                                                                                \
+        header->next_vector = next;                                                                                              \
+        header->reserving = 1;                                                                                                   \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    STATS_ADD(name##_get_stats(header), grows, 1);                                                                               \
+                                                                                                                                 \
+    return name##_advance_migration(header, 0);                                                                                  \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_resize(name##_header *const header, const ptrdiff_t size, const T value)                                 \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (size < 0)                                                                                                                \
+    {                                                                                                                            \
+        return ERR_OUT_OF_BOUNDS;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (size > header->current_vector.size)                                                                                      \
+    {                                                                                                                            \
+        return name##_push_back_n(header, size - header->current_vector.size, value);                                            \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_erase_range(header, size, header->current_vector.size - size);                                                 \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_shrink_to_fit(name##_header *const header)                                                               \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    ptrdiff_t size = header->current_vector.size;                                                                                \
+    ptrdiff_t target = header->current_vector.capacity;                                                                          \
+    while (target / 2 >= MIN_CAPACITY && target / 2 >= 2 * size)                                                                 \
+    {                                                                                                                            \
+        target /= 2;                                                                                                             \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (target == header->current_vector.capacity)                                                                               \
+    {                                                                                                                            \
+        return name##_release_next(header);                                                                                      \
+    }                                                                                                                            \
+                                                                                                                                 \
+    /* a shrink at least this far along the way is left to finish */                                                             \
+    if (name##_is_shrinking(header) && header->next_vector.capacity <= target)                                                   \
+    {                                                                                                                            \
+        return OK;                                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    operation_result result = OK;                                                                                                \
+                                                                                                                                 \
+    if (size <= RESIZE_DIRECT_SIZE)                                                                                              \
+    {                                                                                                                            \
+        result = name##_replace_current(header, target);                                                                         \
+    }                                                                                                                            \
+    else                                                                                                                         \
+    {                                                                                                                            \
+        buffer##_header smaller = name##_init_buffer(target, header->current_vector.allocator, name##_get_stats(header));        \
+                                                                                                                                 \
+        if (!smaller.is_allocated)                                                                                               \
+        {                                                                                                                        \
+            return ERR_MALLOC_FAILED;                                                                                            \
+        }                                                                                                                        \
+                                                                                                                                 \
+        name##_drop_next(header);                                                                                                \
+        header->next_vector = smaller;                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    STATS_ADD(name##_get_stats(header), shrinks, 1);                                                                             \
+                                                                                                                                 \
+    return name##_advance_migration(header, 0);                                                                                  \
+}                                                                                                                                \
+                                                                                                                                 \
+/* The migration in progress is either finished first or, with                                                                   \
+   finish_migration unset, started over afterwards */                                                                            \
+operation_result name##_sort_by(name##_header *const header, const sort_compare compare, const int finish_migration)             \
+{                                                                                                                                \
+    if (header == NULL || compare == NULL)                                                                                       \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    operation_result result = finish_migration ? name##_complete_migration(header) : OK;                                         \
+    if (result == OK)                                                                                                            \
+    {                                                                                                                            \
+        result = buffer##_sort_by(&header->current_vector, compare);                                                             \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return result == OK ? name##_restart_migration(header) : result;                                                             \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_release_next(name##_header *const header)                                                                \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    /* a shrink or reserve target, or a growth buffer migration is due for, is still needed */                                   \
+    if (!name##_is_migration_due(header))                                                                                        \
+    {                                                                                                                            \
+        name##_drop_next(header);                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_set_migration_rate(name##_header *const header, const int elements)                                      \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (elements < MIN_MIGRATION_RATE)                                                                                           \
+    {                                                                                                                            \
+        return ERR_OUT_OF_BOUNDS;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    header->migration_rate = elements;                                                                                           \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_set_migration_bytes(name##_header *const header, const long bytes)                                       \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    long elements = bytes / (long)sizeof(T);                                                                                     \
+                                                                                                                                 \
+    return name##_set_migration_rate(header, elements > INT_MAX ? INT_MAX : (int)elements);                                      \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_set_deferred_migration(name##_header *const header, const int deferred)                                  \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    header->deferred_migration = deferred;                                                                                       \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Migrates up to budget elements ahead of time, for idle periods or a helper                                                    \
+   thread. The header isn't thread-safe: a helper must hold the same lock as                                                     \
+   every other caller. */                                                                                                        \
+operation_result name##_make_progress(name##_header *const header, const ptrdiff_t budget)                                       \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (budget < 0)                                                                                                              \
+    {                                                                                                                            \
+        return ERR_OUT_OF_BOUNDS;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_pending_migration(header) == 0)                                                                                   \
+    {                                                                                                                            \
+        return OK;                                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    operation_result result = name##_migrate(header, budget);                                                                    \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_shrinking(header) && header->reallocated_amount == header->current_vector.size)                                \
+    {                                                                                                                            \
+        name##_finish_shrink(header);                                                                                            \
+    }                                                                                                                            \
+    else if (header->reserving && header->reallocated_amount == header->current_vector.size)                                     \
+    {                                                                                                                            \
+        name##_swap_vectors(header);                                                                                             \
+    }                                                                                                                            \
+                                                                                                                                 \
+    name##_record_migration(header);                                                                                             \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Elements still to copy for the migration in progress, 0 when there is none */                                                 \
+ptrdiff_t name##_pending_migration(const name##_header *const header)                                                            \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header) || !name##_is_migration_due(header))                                                           \
+    {                                                                                                                            \
+        return 0;                                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return header->current_vector.size - header->reallocated_amount;                                                             \
+}                                                                                                                                \
+                                                                                                                                 \
+/* redeclared so that the instantiation takes the caller's semicolon */                                                          \
+ptrdiff_t name##_pending_migration(const name##_header *const header)
@@ -2,9 +2,28 @@
 
 #include "../vector/header.h"
 
-typedef struct
-{
-    vector_header current_vector;
-    vector_header next_vector;
-    int reallocated_amount;
-} deamortized_vector_header;
+// Elements migrated per inserted or erased element. Two is the least that
+// finishes migration before current_vector fills up without catching up.
+#define DEFAULT_MIGRATION_RATE 2
+#define MIN_MIGRATION_RATE 2
+// deamortized_reserve() and deamortized_shrink_to_fit() copy vectors up to
+// this size in one go, and migrate larger ones incrementally
+#define RESIZE_DIRECT_SIZE 4096
+
+// The header of a deamortized vector over two buffer##_header vectors.
+//   deferred_migration: leave migration to deamortized_make_progress(), with
+//     inserts only catching up when it falls behind
+//   reserving: next_vector is the target of deamortized_reserve(): migration
+//     into it is due whatever the size, and it takes over as soon as it completes
+#define DECLARE_DEAMORTIZED_VECTOR_HEADER(name, buffer) \
+    typedef struct                                      \
+    {                                                   \
+        buffer##_header current_vector;                 \
+        buffer##_header next_vector;                    \
+        ptrdiff_t reallocated_amount;                   \
+        int migration_rate;                             \
+        int deferred_migration;                         \
+        int reserving;                                  \
+    } name##_header
+
+DECLARE_DEAMORTIZED_VECTOR_HEADER(deamortized_vector, vector);
@@ -1,14 +1,45 @@
 #pragma once
 
 #include "header.h"
+#include "generic.h"
+#include "../batch/header.h"
 #include "../operation_result.h"
 
-deamortized_vector_header init_deamortized_vector(const int capacity);
+// The long instance of generic.h, on the vector instance as its buffers; the
+// classic operations below wrap it
+DECLARE_DEAMORTIZED_VECTOR_OPERATIONS(deamortized_vector, long);
+
+deamortized_vector_header init_deamortized_vector(const ptrdiff_t capacity);
+deamortized_vector_header init_deamortized_vector_with_allocator(const ptrdiff_t capacity, const vector_allocator *const allocator);
 operation_result free_deamortized_vector(deamortized_vector_header *header);
-long deamortized_get(const deamortized_vector_header *header, int index);
-operation_result deamortized_set(deamortized_vector_header *const header, const int index, const long value);
-operation_result deamortized_insert(deamortized_vector_header *const header, const int index, const long value);
+long deamortized_get(const deamortized_vector_header *header, ptrdiff_t index);
+operation_result deamortized_set(deamortized_vector_header *const header, const ptrdiff_t index, const long value);
+operation_result deamortized_insert(deamortized_vector_header *const header, const ptrdiff_t index, const long value);
 operation_result deamortized_push_back(deamortized_vector_header *const header, const long value);
-operation_result deamortized_erase(deamortized_vector_header *const header, const int index);
+operation_result deamortized_erase(deamortized_vector_header *const header, const ptrdiff_t index);
 operation_result deamortized_pop_back(deamortized_vector_header *const header);
-int get_size(const deamortized_vector_header *const header);
+ptrdiff_t get_size(const deamortized_vector_header *const header);
+// values may point into the vector itself; such elements are copied out first
+operation_result deamortized_insert_range(deamortized_vector_header *const header, const ptrdiff_t index, const long *values, const ptrdiff_t count);
+operation_result deamortized_erase_range(deamortized_vector_header *const header, const ptrdiff_t index, const ptrdiff_t count);
+operation_result deamortized_push_back_n(deamortized_vector_header *const header, const ptrdiff_t count, const long value);
+operation_result deamortized_append_array(deamortized_vector_header *const header, const long *const values, const ptrdiff_t count);
+operation_result deamortized_assign(deamortized_vector_header *const header, const long *const values, const ptrdiff_t count);
+// Makes room for capacity elements without further growth: small vectors
+// move straight into a big enough current_vector, larger ones migrate into it
+// incrementally from the next operation on
+operation_result deamortized_reserve(deamortized_vector_header *const header, const ptrdiff_t capacity);
+operation_result deamortized_resize(deamortized_vector_header *const header, const ptrdiff_t size, const long value);
+// Brings capacity down to the least that leaves the vector at most half full,
+// directly for small vectors and by migration for larger ones
+operation_result deamortized_shrink_to_fit(deamortized_vector_header *const header);
+operation_result deamortized_apply_batch(deamortized_vector_header *const header, const vector_edit *const edits, const ptrdiff_t count);
+// Sorts current_vector with vector_sort(). The migration in progress is either
+// finished first or, with finish_migration unset, started over afterwards.
+operation_result deamortized_sort(deamortized_vector_header *const header, const int finish_migration);
+operation_result deamortized_release_next(deamortized_vector_header *const header);
+operation_result deamortized_set_migration_rate(deamortized_vector_header *const header, const int elements);
+operation_result deamortized_set_migration_bytes(deamortized_vector_header *const header, const long bytes);
+operation_result deamortized_set_deferred_migration(deamortized_vector_header *const header, const int deferred);
+operation_result deamortized_make_progress(deamortized_vector_header *const header, const ptrdiff_t budget);
+ptrdiff_t deamortized_pending_migration(const deamortized_vector_header *const header);
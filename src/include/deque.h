@@ -0,0 +1,4 @@
+#pragma once
+
+#include "deque/header.h"
+#include "deque/operations.h"
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "../vector/header.h"
+
+// Elements migrated into the doubled ring per operation. As with the
+// deamortized vector, two is enough to finish before the old ring fills up.
+#define DEQUE_MIGRATION_RATE 2
+#define MAX_DEQUE_CAPACITY (1 << 30)
+
+// capacity is a power of two, and logical index i lives at
+// (head + i) & (capacity - 1)
+typedef struct
+{
+    long *start_address;
+    int capacity;
+    int head;
+} deque_ring;
+
+// Once size reaches half the capacity, next is allocated at twice the size and
+// elements are copied into it, unwrapped, a few per operation; when every
+// element is there, it replaces current. Logical indices
+// [migrated_front, migrated_back) are already in next, and writes inside that
+// range go to both rings.
+typedef struct
+{
+    int is_allocated;
+    int size;
+    deque_ring current;
+    // start_address is NULL unless migrating
+    deque_ring next;
+    int migrated_front;
+    int migrated_back;
+    // NULL for malloc; must outlive the deque
+    const vector_allocator *allocator;
+} deque_header;
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "header.h"
+#include "../operation_result.h"
+
+deque_header init_deque(const int capacity);
+deque_header init_deque_with_allocator(const int capacity, const vector_allocator *const allocator);
+operation_result free_deque(deque_header *const header);
+long deque_get(const deque_header *const header, const int index);
+operation_result deque_set(deque_header *const header, const int index, const long value);
+operation_result deque_push_back(deque_header *const header, const long value);
+operation_result deque_push_front(deque_header *const header, const long value);
+operation_result deque_pop_back(deque_header *const header);
+operation_result deque_pop_front(deque_header *const header);
+int deque_get_size(const deque_header *const header);
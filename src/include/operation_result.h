@@ -8,5 +8,7 @@ typedef enum
     ERR_MALLOC_FAILED,
     ERR_REALLOC_FAILED,
     ERR_OUT_OF_BOUNDS,
-    ERR_NULL
+    ERR_NULL,
+    ERR_IO,
+    ERR_INVALID_FILE
 } operation_result;
@@ -0,0 +1,4 @@
+#pragma once
+
+#include "packed_vector/header.h"
+#include "packed_vector/operations.h"
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../allocator/header.h"
+
+// Elements per block, a multiple of 64 so a block of width w packs into
+// exactly PACKED_BLOCK_WORDS(w) words
+#define PACKED_BLOCK_SIZE 128
+#define PACKED_BLOCK_WORDS(width) (PACKED_BLOCK_SIZE / 64 * (width))
+
+// Frame of reference: element i of the block is base plus the i-th
+// bit_width-bit offset in words. words has two words of padding past the
+// offsets, so decoding may always load 16 bytes from the byte an offset
+// starts in. A block of equal elements has width 0 and no words.
+typedef struct
+{
+    long base;
+    int bit_width;
+    uint64_t *words;
+} packed_block;
+
+// Full blocks are packed; the elements after them stay unpacked in tail
+// until there are PACKED_BLOCK_SIZE of them, so push_back is a plain store.
+typedef struct
+{
+    int is_allocated;
+    packed_block *blocks;
+    ptrdiff_t block_count;
+    ptrdiff_t block_capacity;
+    // PACKED_BLOCK_SIZE elements, [0, size - block_count * PACKED_BLOCK_SIZE) in use
+    long *tail;
+    ptrdiff_t size;
+    // NULL for malloc; must outlive the vector
+    const vector_allocator *allocator;
+} packed_vector_header;
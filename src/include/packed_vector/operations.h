@@ -0,0 +1,23 @@
+#pragma once
+
+#include "header.h"
+#include "../operation_result.h"
+
+packed_vector_header init_packed_vector(const ptrdiff_t capacity);
+packed_vector_header init_packed_vector_with_allocator(const ptrdiff_t capacity, const vector_allocator *const allocator);
+operation_result free_packed_vector(packed_vector_header *const header);
+long packed_get(const packed_vector_header *const header, const ptrdiff_t index);
+// In place while value fits the block's frame, otherwise the block is re-packed
+operation_result packed_set(packed_vector_header *const header, const ptrdiff_t index, const long value);
+operation_result packed_push_back(packed_vector_header *const header, const long value);
+operation_result packed_pop_back(packed_vector_header *const header);
+ptrdiff_t packed_get_size(const packed_vector_header *const header);
+// Bytes held by blocks, directory and tail
+size_t packed_get_memory(const packed_vector_header *const header);
+
+// Copies elements [index, index + count) into values, a whole block at a time
+operation_result packed_decode(const packed_vector_header *const header, const ptrdiff_t index, const ptrdiff_t count, long *const values);
+// Blocks whose frame cannot hold value are skipped without decoding
+operation_result packed_find(const packed_vector_header *const header, const long value, ptrdiff_t *const index);
+operation_result packed_count(const packed_vector_header *const header, const long value, ptrdiff_t *const count);
+operation_result packed_sum(const packed_vector_header *const header, long *const sum);
@@ -0,0 +1,4 @@
+#pragma once
+
+#include "search/header.h"
+#include "search/operations.h"
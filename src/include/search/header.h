@@ -0,0 +1,22 @@
+#pragma once
+
+// Instruction sets the search kernels can run on, slowest first
+typedef enum
+{
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX2,
+    SIMD_AVX512
+} simd_level;
+
+// One implementation of every kernel over a plain array of longs. min, max
+// and argmin expect count > 0; find returns -1 when there is no match; sum
+// wraps around on overflow.
+typedef struct
+{
+    long (*find)(const long *values, long count, long value);
+    long (*count)(const long *values, long count, long value);
+    long (*sum)(const long *values, long count);
+    long (*min)(const long *values, long count);
+    long (*max)(const long *values, long count);
+} search_kernels;
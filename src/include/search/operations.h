@@ -0,0 +1,29 @@
+#pragma once
+
+#include "header.h"
+#include "../vector/header.h"
+#include "../deamortized_vector/header.h"
+#include "../operation_result.h"
+
+// Picked on first use from what the CPU supports; can be lowered for testing
+simd_level get_simd_level(void);
+operation_result set_simd_level(const simd_level level);
+const search_kernels *get_search_kernels(const simd_level level);
+
+// index is -1 when value isn't there
+operation_result vector_find(const vector_header *const header, const long value, ptrdiff_t *const index);
+operation_result vector_count(const vector_header *const header, const long value, ptrdiff_t *const count);
+operation_result vector_contains(const vector_header *const header, const long value, int *const found);
+operation_result vector_sum(const vector_header *const header, long *const sum);
+// ERR_OUT_OF_BOUNDS on an empty vector
+operation_result vector_min(const vector_header *const header, long *const min);
+operation_result vector_max(const vector_header *const header, long *const max);
+operation_result vector_argmin(const vector_header *const header, ptrdiff_t *const index);
+
+operation_result deamortized_find(const deamortized_vector_header *const header, const long value, ptrdiff_t *const index);
+operation_result deamortized_count(const deamortized_vector_header *const header, const long value, ptrdiff_t *const count);
+operation_result deamortized_contains(const deamortized_vector_header *const header, const long value, int *const found);
+operation_result deamortized_sum(const deamortized_vector_header *const header, long *const sum);
+operation_result deamortized_min(const deamortized_vector_header *const header, long *const min);
+operation_result deamortized_max(const deamortized_vector_header *const header, long *const max);
+operation_result deamortized_argmin(const deamortized_vector_header *const header, ptrdiff_t *const index);
@@ -0,0 +1,4 @@
+#pragma once
+
+#include "segmented_vector/header.h"
+#include "segmented_vector/operations.h"
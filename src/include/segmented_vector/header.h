@@ -0,0 +1,22 @@
+#pragma once
+
+#include "../allocator/header.h"
+
+// Block k holds 2^(FIRST_BLOCK_SHIFT + k) elements, enough blocks to address
+// every int index
+#define FIRST_BLOCK_SHIFT 5
+#define SEGMENTED_BLOCKS (32 - FIRST_BLOCK_SHIFT)
+
+// Blocks are only ever added or released at the end and never reallocated,
+// so an element stays at the same address for as long as it is in the
+// vector. Index i lives in block msb(i + 2^FIRST_BLOCK_SHIFT) - FIRST_BLOCK_SHIFT.
+typedef struct
+{
+    int is_allocated;
+    int size;
+    // blocks[0, block_count) are allocated, the rest are NULL
+    int block_count;
+    long *blocks[SEGMENTED_BLOCKS];
+    // NULL for malloc; must outlive the vector
+    const vector_allocator *allocator;
+} segmented_vector_header;
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "header.h"
+#include "../operation_result.h"
+
+segmented_vector_header init_segmented_vector(const int capacity);
+segmented_vector_header init_segmented_vector_with_allocator(const int capacity, const vector_allocator *const allocator);
+operation_result free_segmented_vector(segmented_vector_header *const header);
+long segmented_get(const segmented_vector_header *const header, const int index);
+operation_result segmented_set(segmented_vector_header *const header, const int index, const long value);
+operation_result segmented_push_back(segmented_vector_header *const header, const long value);
+operation_result segmented_pop_back(segmented_vector_header *const header);
+int segmented_get_size(const segmented_vector_header *const header);
+// Valid until the element is popped or the vector freed, whatever else happens
+operation_result segmented_get_address(const segmented_vector_header *const header, const int index, long **const address);
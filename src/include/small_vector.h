@@ -0,0 +1,4 @@
+#pragma once
+
+#include "small_vector/header.h"
+#include "small_vector/operations.h"
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "../vector/header.h"
+#include "../deamortized_vector/header.h"
+
+// Elements kept inside the header before the first heap allocation
+#define SMALL_VECTOR_CAPACITY 8
+
+// Holds up to SMALL_VECTOR_CAPACITY elements inline, then moves them into a
+// heap vector for good. The elements are always reached through the header
+// rather than a pointer into it, so it can be returned and copied by value
+// like the other headers.
+typedef struct
+{
+    int is_allocated;
+    int is_spilled;
+    // of the inline elements; once spilled, heap.size is the size
+    int size;
+    // NULL for malloc; used on spilling
+    const vector_allocator *allocator;
+    union
+    {
+        long elements[SMALL_VECTOR_CAPACITY];
+        vector_header heap;
+    } storage;
+} small_vector_header;
+
+// The same for a deamortized vector, which therefore only starts migrating
+// once it has spilled
+typedef struct
+{
+    int is_allocated;
+    int is_spilled;
+    int size;
+    const vector_allocator *allocator;
+    union
+    {
+        long elements[SMALL_VECTOR_CAPACITY];
+        deamortized_vector_header heap;
+    } storage;
+} small_deamortized_vector_header;
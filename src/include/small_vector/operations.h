@@ -0,0 +1,26 @@
+#pragma once
+
+#include "header.h"
+#include "../operation_result.h"
+
+small_vector_header init_small_vector(void);
+small_vector_header init_small_vector_with_allocator(const vector_allocator *const allocator);
+operation_result free_small_vector(small_vector_header *const header);
+long small_get(const small_vector_header *const header, const ptrdiff_t index);
+operation_result small_set(small_vector_header *const header, const ptrdiff_t index, const long value);
+operation_result small_insert(small_vector_header *const header, const ptrdiff_t index, const long value);
+operation_result small_push_back(small_vector_header *const header, const long value);
+operation_result small_erase(small_vector_header *const header, const ptrdiff_t index);
+operation_result small_pop_back(small_vector_header *const header);
+ptrdiff_t small_get_size(const small_vector_header *const header);
+
+small_deamortized_vector_header init_small_deamortized_vector(void);
+small_deamortized_vector_header init_small_deamortized_vector_with_allocator(const vector_allocator *const allocator);
+operation_result free_small_deamortized_vector(small_deamortized_vector_header *const header);
+long small_deamortized_get(const small_deamortized_vector_header *const header, const ptrdiff_t index);
+operation_result small_deamortized_set(small_deamortized_vector_header *const header, const ptrdiff_t index, const long value);
+operation_result small_deamortized_insert(small_deamortized_vector_header *const header, const ptrdiff_t index, const long value);
+operation_result small_deamortized_push_back(small_deamortized_vector_header *const header, const long value);
+operation_result small_deamortized_erase(small_deamortized_vector_header *const header, const ptrdiff_t index);
+operation_result small_deamortized_pop_back(small_deamortized_vector_header *const header);
+ptrdiff_t small_deamortized_get_size(const small_deamortized_vector_header *const header);
@@ -0,0 +1,4 @@
+#pragma once
+
+#include "snapshot/header.h"
+#include "snapshot/operations.h"
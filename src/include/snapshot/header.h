@@ -0,0 +1,63 @@
+#pragma once
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include "../allocator/header.h"
+
+// Unit of copy-on-write; a multiple of the page size
+#define SNAPSHOT_CHUNK_SIZE ((size_t)1 << 16)
+
+struct snapshot_record;
+
+// One buffer handed out by the copy-on-write allocator: a memfd the writer
+// maps read-write. Snapshots map the same file read-only, so taking one
+// copies nothing. Before the writer touches a chunk that snapshots taken
+// since its last copy still see, the chunk is copied out and mapped over
+// theirs, and only then written in place.
+typedef struct cow_buffer
+{
+    int fd;
+    char *address;
+    size_t length;
+    // never less than what any snapshot maps
+    size_t file_length;
+    // per chunk of the file, the generation it was last copied out at
+    unsigned long *copied_at;
+    size_t chunk_count;
+    // bumped by every snapshot
+    unsigned long generation;
+    // freed by the allocator; kept until its last snapshot goes
+    int is_released;
+    struct snapshot_record *snapshots;
+    struct cow_buffer *next;
+} cow_buffer;
+
+// The allocator behind vectors that can be snapshotted. Copied chunks live
+// in a second memfd, one slot per chunk, each counting the snapshots mapping
+// it; a slot's memory goes back to the system when the count drops to zero.
+// chunk_fd is negative if init_cow() couldn't create the file.
+typedef struct
+{
+    pthread_mutex_t lock;
+    cow_buffer *buffers;
+    // lets writes skip the lock while nothing is snapshotted
+    atomic_long snapshot_count;
+    int chunk_fd;
+    int *chunk_references;
+    size_t chunk_slots;
+    size_t slot_capacity;
+    size_t *free_slots;
+    size_t free_count;
+    long chunks_copied;
+    vector_allocator allocator;
+} vector_cow;
+
+// A read-only view of a vector as of vector_snapshot(): start_address stays
+// valid and unchanged, from any thread, until release_snapshot()
+typedef struct
+{
+    const long *start_address;
+    ptrdiff_t size;
+    struct snapshot_record *record;
+} snapshot_header;
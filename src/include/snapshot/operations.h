@@ -0,0 +1,21 @@
+#pragma once
+
+#include "header.h"
+#include "../vector/header.h"
+#include "../deamortized_vector/header.h"
+#include "../operation_result.h"
+
+// The vector_cow must outlive its vectors and their snapshots; free_cow()
+// refuses while any are left
+vector_cow init_cow(void);
+operation_result free_cow(vector_cow *const cow);
+const vector_allocator *cow_allocator(vector_cow *const cow);
+
+// O(1); the vector must use a cow_allocator(). Called from the writer's thread,
+// like any other operation on the vector.
+operation_result vector_snapshot(const vector_header *const header, snapshot_header *const snapshot);
+// Snapshots current_vector, which holds every element even mid-migration
+operation_result deamortized_snapshot(const deamortized_vector_header *const header, snapshot_header *const snapshot);
+// Safe from any thread
+operation_result release_snapshot(snapshot_header *const snapshot);
+long snapshot_get(const snapshot_header *const snapshot, const ptrdiff_t index);
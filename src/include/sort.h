@@ -0,0 +1,4 @@
+#pragma once
+
+#include "sort/header.h"
+#include "sort/operations.h"
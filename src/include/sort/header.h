@@ -0,0 +1,13 @@
+#pragma once
+
+// Below this many elements vector_sort() compares rather than counts digits
+#define RADIX_SORT_MIN_SIZE 256
+// From this many elements radix passes take 11 bits at a time, six passes
+// instead of eight, while a pass's counts still fit in L1
+#define RADIX_WIDE_DIGIT_SIZE (1 << 16)
+// vector_sort_parallel() sorts anything smaller on the calling thread
+#define PARALLEL_SORT_MIN_SIZE (1 << 18)
+#define SORT_MAX_THREADS 64
+
+// Same contract as qsort()'s comparison function
+typedef int (*sort_compare)(const void *, const void *);
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stddef.h>
+#include "header.h"
+#include "../vector/header.h"
+#include "../operation_result.h"
+
+// Pattern-defeating quicksort over count elements of size bytes each, for
+// element types radix sort can't handle. Not stable.
+void sort_elements(void *const base, const ptrdiff_t count, const size_t size, const sort_compare compare);
+
+// LSD radix sort into ascending order. The scratch buffer comes out of spare
+// capacity when there is enough of it, and from malloc() otherwise.
+operation_result vector_sort(vector_header *const header);
+// vector_sort_by() sorts with a comparator; it comes with the vector in vector/operations.h
+// Radix sort with each pass split across up to threads threads
+operation_result vector_sort_parallel(vector_header *const header, const int threads);
@@ -0,0 +1,3 @@
+#pragma once
+
+#include "sorted_vector/operations.h"
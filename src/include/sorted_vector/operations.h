@@ -0,0 +1,15 @@
+#pragma once
+
+#include "../vector/header.h"
+#include "../operation_result.h"
+
+// Operations on a vector_header kept in non-decreasing order. They assume the
+// order holds and keep it; equal keys stay in insertion order.
+operation_result sorted_lower_bound(const vector_header *const header, const long key, ptrdiff_t *const index);
+operation_result sorted_upper_bound(const vector_header *const header, const long key, ptrdiff_t *const index);
+operation_result sorted_contains(const vector_header *const header, const long key, int *const found);
+operation_result sorted_insert(vector_header *const header, const long key);
+// Erases every element equal to key; erased may be NULL
+operation_result sorted_erase(vector_header *const header, const long key, ptrdiff_t *const erased);
+// Merges count keys, themselves sorted, in one backward pass
+operation_result sorted_merge_insert(vector_header *const header, const long *const keys, const ptrdiff_t count);
@@ -0,0 +1,4 @@
+#pragma once
+
+#include "span/header.h"
+#include "span/operations.h"
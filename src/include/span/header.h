@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stddef.h>
+
+// Containers are exposed as at most this many contiguous runs
+#define MAX_SPANS 2
+
+// A contiguous run of elements inside a container's buffer. Valid until the
+// next operation that modifies the container.
+typedef struct
+{
+    const long *start_address;
+    ptrdiff_t length;
+} vector_span;
+
+// Walks the spans of one container, span by span or element by element
+typedef struct
+{
+    vector_span spans[MAX_SPANS];
+    int span_count;
+    int span;
+    ptrdiff_t offset;
+} vector_cursor;
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "header.h"
+#include "../vector/header.h"
+#include "../deamortized_vector/header.h"
+#include "../deque/header.h"
+#include "../operation_result.h"
+
+// Fill spans[0 .. *count) with the elements in order
+operation_result vector_get_spans(const vector_header *const header, vector_span spans[MAX_SPANS], int *const count);
+operation_result deamortized_get_spans(const deamortized_vector_header *const header, vector_span spans[MAX_SPANS], int *const count);
+// Two spans when the ring wraps around
+operation_result deque_get_spans(const deque_header *const header, vector_span spans[MAX_SPANS], int *const count);
+
+operation_result init_vector_cursor(vector_cursor *const cursor, const vector_header *const header);
+operation_result init_deamortized_cursor(vector_cursor *const cursor, const deamortized_vector_header *const header);
+operation_result init_deque_cursor(vector_cursor *const cursor, const deque_header *const header);
+// The rest of the current span, then each following one; 0 once done
+int cursor_next_span(vector_cursor *const cursor, vector_span *const span);
+
+// Inline so element-wise loops compile down to a pointer walk
+static inline int cursor_next(vector_cursor *const cursor, long *const value)
+{
+    while (cursor->span < cursor->span_count)
+    {
+        const vector_span *span = &cursor->spans[cursor->span];
+
+        if (cursor->offset < span->length)
+        {
+            *value = span->start_address[cursor->offset++];
+            return 1;
+        }
+
+        cursor->span++;
+        cursor->offset = 0;
+    }
+
+    return 0;
+}
@@ -0,0 +1,4 @@
+#pragma once
+
+#include "stats/header.h"
+#include "stats/operations.h"
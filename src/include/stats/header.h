@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+
+// Counters for one container. They are only updated when built with
+// -DVECTOR_STATS (make STATS=1); otherwise every STATS_* macro compiles away.
+typedef struct vector_stats
+{
+    const char *name;
+    uint64_t grows;
+    uint64_t shrinks;
+    // deamortized vectors: next_vector taking over from current_vector
+    uint64_t swaps;
+    // moved by insert and erase to open or close a gap
+    uint64_t bytes_shifted;
+    // copied from current_vector into next_vector
+    uint64_t bytes_migrated;
+    uint64_t peak_capacity;
+    uint64_t allocator_calls;
+    uint64_t allocator_ns;
+    // reallocated_amount and size as of the last operation
+    uint64_t migrated;
+    uint64_t size;
+    // registry link
+    struct vector_stats *next;
+} vector_stats;
+
+typedef enum
+{
+    STATS_TEXT,
+    STATS_JSON
+} stats_format;
+
+#ifdef VECTOR_STATS
+
+#define STATS_ADD(stats, field, amount)      \
+    do                                       \
+    {                                        \
+        if ((stats) != NULL)                 \
+        {                                    \
+            (stats)->field += (amount);      \
+        }                                    \
+    } while (0)
+
+#define STATS_SET(stats, field, value)       \
+    do                                       \
+    {                                        \
+        if ((stats) != NULL)                 \
+        {                                    \
+            (stats)->field = (value);        \
+        }                                    \
+    } while (0)
+
+#define STATS_MAX(stats, field, value)                          \
+    do                                                          \
+    {                                                           \
+        if ((stats) != NULL && (stats)->field < (uint64_t)(value)) \
+        {                                                       \
+            (stats)->field = (uint64_t)(value);                 \
+        }                                                       \
+    } while (0)
+
+// Runs statement as one allocator call, timing it
+#define STATS_ALLOCATOR_CALL(stats, statement)                          \
+    do                                                                  \
+    {                                                                   \
+        uint64_t stats_start_ = stats_clock_ns();                       \
+        statement;                                                      \
+        STATS_ADD(stats, allocator_ns, stats_clock_ns() - stats_start_); \
+        STATS_ADD(stats, allocator_calls, 1);                           \
+    } while (0)
+
+#else
+
+// sizeof keeps the arguments type-checked and used, without evaluating them
+#define STATS_ADD(stats, field, amount) ((void)sizeof((stats)->field + (amount)))
+#define STATS_SET(stats, field, value) ((void)sizeof((stats)->field + (value)))
+#define STATS_MAX(stats, field, value) ((void)sizeof((stats)->field + (value)))
+#define STATS_ALLOCATOR_CALL(stats, statement) \
+    do                                         \
+    {                                          \
+        statement;                             \
+    } while (0)
+
+#endif
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdio.h>
+#include "header.h"
+#include "../vector/header.h"
+#include "../deamortized_vector/header.h"
+#include "../operation_result.h"
+
+uint64_t stats_clock_ns(void);
+
+// stats must outlive the container, or be detached by attaching NULL
+operation_result vector_attach_stats(vector_header *const header, vector_stats *const stats);
+operation_result deamortized_attach_stats(deamortized_vector_header *const header, vector_stats *const stats);
+
+// The registry only links stats in; it never copies or frees them
+operation_result register_vector_stats(vector_stats *const stats, const char *const name);
+operation_result unregister_vector_stats(vector_stats *const stats);
+// Zeroes the counters but keeps the name and registration
+operation_result reset_vector_stats(vector_stats *const stats);
+// Every registered container, in registration order
+operation_result dump_vector_stats(FILE *const stream, const stats_format format);
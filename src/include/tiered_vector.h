@@ -0,0 +1,4 @@
+#pragma once
+
+#include "tiered_vector/header.h"
+#include "tiered_vector/operations.h"
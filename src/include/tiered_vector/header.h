@@ -0,0 +1,24 @@
+#pragma once
+
+// Blocks never get smaller than 2^MIN_BLOCK_SHIFT elements
+#define MIN_BLOCK_SHIFT 4
+
+// A circular buffer of 2^block_shift elements, starting at head
+typedef struct
+{
+    long *start_address;
+    int head;
+} tiered_block;
+
+// Every block in use is full except the last one, so index i lives in block
+// i >> block_shift. Blocks hold about sqrt(size) elements, which bounds both
+// the shift inside one block and the number of blocks to ripple through.
+typedef struct
+{
+    int is_allocated;
+    tiered_block *blocks;
+    int block_count;
+    int block_slots;
+    int block_shift;
+    int size;
+} tiered_vector_header;
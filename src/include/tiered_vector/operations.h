@@ -0,0 +1,14 @@
+#pragma once
+
+#include "header.h"
+#include "../operation_result.h"
+
+tiered_vector_header init_tiered_vector(const int capacity);
+operation_result free_tiered_vector(tiered_vector_header *header);
+long tiered_get(const tiered_vector_header *header, int index);
+operation_result tiered_set(tiered_vector_header *const header, const int index, const long value);
+operation_result tiered_insert(tiered_vector_header *const header, const int index, const long value);
+operation_result tiered_push_back(tiered_vector_header *const header, const long value);
+operation_result tiered_erase(tiered_vector_header *const header, const int index);
+operation_result tiered_pop_back(tiered_vector_header *const header);
+int tiered_get_size(const tiered_vector_header *const header);
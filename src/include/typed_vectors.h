@@ -0,0 +1,12 @@
+#pragma once
+
+#include <stdint.h>
+#include "vector/generic.h"
+#include "deamortized_vector/generic.h"
+
+DECLARE_VECTOR(int32_vector, int32_t);
+DECLARE_VECTOR(float_vector, float);
+DECLARE_VECTOR(double_vector, double);
+
+DECLARE_DEAMORTIZED_VECTOR(int32_deamortized_vector, int32_t);
+DECLARE_DEAMORTIZED_VECTOR(double_deamortized_vector, double);
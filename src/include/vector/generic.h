@@ -0,0 +1,658 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "header.h"
+#include "../allocator/operations.h"
+#include "../stats/operations.h"
+#include "../sort/operations.h"
+#include "../operation_result.h"
+
+// The one implementation of the vector, for any element type T:
+//
+//     DECLARE_VECTOR(int32_vector, int32_t);   // in a header
+//     DEFINE_VECTOR(int32_vector, int32_t);    // in exactly one source file
+//
+// gives int32_vector_header plus int32_vector_init(), int32_vector_push_back()
+// and the rest of the operations below. The long vector is the vector
+// instance, which operations.h wraps in the classic init_vector(), get() and
+// so on. An arbitrary T can't double as an error code the way get() does for
+// long, so name##_get() returns operation_result and writes through a pointer.
+
+#define DECLARE_VECTOR_OPERATIONS(name, T)                                                                                        \
+name##_header name##_init(const ptrdiff_t capacity);                                                                              \
+name##_header name##_init_with_allocator(const ptrdiff_t capacity, const vector_allocator *const allocator);                      \
+operation_result name##_free(name##_header *const header);                                                                        \
+operation_result name##_get(const name##_header *const header, const ptrdiff_t index, T *const value);                            \
+operation_result name##_set(name##_header *const header, const ptrdiff_t index, const T value);                                   \
+operation_result name##_insert(name##_header *const header, const ptrdiff_t index, const T value);                                \
+operation_result name##_push_back(name##_header *const header, const T value);                                                    \
+operation_result name##_erase(name##_header *const header, const ptrdiff_t index);                                                \
+operation_result name##_pop_back(name##_header *const header);                                                                    \
+operation_result name##_insert_range(name##_header *const header, const ptrdiff_t index, const T *values, const ptrdiff_t count); \
+operation_result name##_erase_range(name##_header *const header, const ptrdiff_t index, const ptrdiff_t count);                   \
+operation_result name##_push_back_n(name##_header *const header, const ptrdiff_t count, const T value);                           \
+operation_result name##_append_array(name##_header *const header, const T *const values, const ptrdiff_t count);                  \
+operation_result name##_assign(name##_header *const header, const T *values, const ptrdiff_t count);                              \
+operation_result name##_reserve(name##_header *const header, const ptrdiff_t capacity);                                           \
+operation_result name##_resize(name##_header *const header, const ptrdiff_t size, const T value);                                 \
+operation_result name##_shrink_to_fit(name##_header *const header);                                                               \
+operation_result name##_prepare_write(name##_header *const header, const ptrdiff_t index, const ptrdiff_t count);                 \
+operation_result name##_sort_by(name##_header *const header, const sort_compare compare)
+
+#define DECLARE_VECTOR(name, T)    \
+DECLARE_VECTOR_HEADER(name, T);    \
+DECLARE_VECTOR_OPERATIONS(name, T)
+
+#define DEFINE_VECTOR(name, T)                                                                                                   \
+static ptrdiff_t name##_get_capacity(const ptrdiff_t capacity)                                                                   \
+{                                                                                                                                \
+    return capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity;                                                                    \
+}                                                                                                                                \
+                                                                                                                                 \
+static T *name##_get_address(const name##_header *const header, const ptrdiff_t offset)                                          \
+{                                                                                                                                \
+    return header->start_address + offset;                                                                                       \
+}                                                                                                                                \
+                                                                                                                                 \
+static int name##_is_invalid(const name##_header *const header)                                                                  \
+{                                                                                                                                \
+    return !header->is_allocated;                                                                                                \
+}                                                                                                                                \
+                                                                                                                                 \
+static void name##_invalidate(name##_header *const header)                                                                       \
+{                                                                                                                                \
+    header->is_allocated = 0;                                                                                                    \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Gives a copy-on-write allocator the chance to copy out what snapshots                                                         \
+   still see in [index, index + count) before it is overwritten */                                                               \
+static operation_result name##_write_range(const name##_header *const header, const ptrdiff_t index, const ptrdiff_t count)      \
+{                                                                                                                                \
+    if (count <= 0)                                                                                                              \
+    {                                                                                                                            \
+        return OK;                                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return allocator_prepare_write(header->allocator, header->start_address,                                                     \
+                                   index * sizeof(T), count * sizeof(T)) == 0                                                    \
+               ? OK                                                                                                              \
+               : ERR_MALLOC_FAILED;                                                                                              \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Whether values points into the vector's own buffer, which growing or                                                          \
+   shifting the vector would move before values were read */                                                                     \
+static int name##_is_own_buffer(const name##_header *const header, const T *const values)                                        \
+{                                                                                                                                \
+    uintptr_t address = (uintptr_t)values;                                                                                       \
+    uintptr_t start = (uintptr_t)header->start_address;                                                                          \
+                                                                                                                                 \
+    return header->is_allocated && address >= start && address - start < (uintptr_t)header->capacity * sizeof(T);                \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Points *values at a copy of them if they are the vector's own elements;                                                       \
+   *copy is the buffer to free afterwards, NULL if none was needed */                                                            \
+static operation_result name##_copy_own_values(const name##_header *const header, const T **const values,                        \
+                                               const ptrdiff_t count, T **const copy)                                            \
+{                                                                                                                                \
+    *copy = NULL;                                                                                                                \
+                                                                                                                                 \
+    if (count <= 0 || !name##_is_own_buffer(header, *values))                                                                    \
+    {                                                                                                                            \
+        return OK;                                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    *copy = malloc(count * sizeof(T));                                                                                           \
+    if (*copy == NULL)                                                                                                           \
+    {                                                                                                                            \
+        return ERR_MALLOC_FAILED;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    memcpy(*copy, *values, count * sizeof(T));                                                                                   \
+    *values = *copy;                                                                                                             \
+                                                                                                                                 \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Doubles capacity, or takes it to the maximum where doubling would overflow */                                                 \
+static ptrdiff_t name##_double_capacity(const ptrdiff_t capacity)                                                                \
+{                                                                                                                                \
+    return capacity > MAX_CAPACITY_OF(T) / 2 ? MAX_CAPACITY_OF(T) : capacity * 2;                                                \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Every capacity change goes through here, so it is timed in one place */                                                       \
+static T *name##_reallocate_buffer(const name##_header *const header, const ptrdiff_t new_capacity)                              \
+{                                                                                                                                \
+    T *new_start_address;                                                                                                        \
+                                                                                                                                 \
+    STATS_ALLOCATOR_CALL(header->stats,                                                                                          \
+                         new_start_address = allocator_reallocate(header->allocator, header->start_address,                      \
+                                                                  header->capacity * sizeof(T),                                  \
+                                                                  new_capacity * sizeof(T)));                                    \
+                                                                                                                                 \
+    return new_start_address;                                                                                                    \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Takes the buffer to new_capacity, counting it as growth or shrinking */                                                       \
+static operation_result name##_set_capacity(name##_header *const header, const ptrdiff_t new_capacity)                           \
+{                                                                                                                                \
+    T *new_start_address = name##_reallocate_buffer(header, new_capacity);                                                       \
+                                                                                                                                 \
+    if (new_start_address == NULL)                                                                                               \
+    {                                                                                                                            \
+        return ERR_REALLOC_FAILED;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (new_capacity > header->capacity)                                                                                         \
+    {                                                                                                                            \
+        STATS_ADD(header->stats, grows, 1);                                                                                      \
+        STATS_MAX(header->stats, peak_capacity, new_capacity);                                                                   \
+    }                                                                                                                            \
+    else                                                                                                                         \
+    {                                                                                                                            \
+        STATS_ADD(header->stats, shrinks, 1);                                                                                    \
+    }                                                                                                                            \
+                                                                                                                                 \
+    header->start_address = new_start_address;                                                                                   \
+    header->capacity = new_capacity;                                                                                             \
+                                                                                                                                 \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Grows geometrically, but with a single realloc however far below required it is */                                            \
+static operation_result name##_reserve_for(name##_header *const header, const ptrdiff_t required)                                \
+{                                                                                                                                \
+    if (required <= header->capacity)                                                                                            \
+    {                                                                                                                            \
+        return OK;                                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (required > MAX_CAPACITY_OF(T))                                                                                           \
+    {                                                                                                                            \
+        return ERR_INVALID_CAPACITY;                                                                                             \
+    }                                                                                                                            \
+                                                                                                                                 \
+    ptrdiff_t new_capacity = header->capacity;                                                                                   \
+    while (new_capacity < required)                                                                                              \
+    {                                                                                                                            \
+        new_capacity = name##_double_capacity(new_capacity);                                                                     \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_set_capacity(header, new_capacity);                                                                            \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Makes room for count elements at index, shifting the tail once */                                                             \
+static operation_result name##_open_gap(name##_header *const header, const ptrdiff_t index, const ptrdiff_t count)               \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (index < 0 || index > header->size || count < 0)                                                                          \
+    {                                                                                                                            \
+        return ERR_OUT_OF_BOUNDS;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (count > MAX_CAPACITY_OF(T) - header->size)                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_CAPACITY;                                                                                             \
+    }                                                                                                                            \
+                                                                                                                                 \
+    operation_result result = name##_reserve_for(header, header->size + count);                                                  \
+    if (result == OK)                                                                                                            \
+    {                                                                                                                            \
+        result = name##_write_range(header, index, header->size + count - index);                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    memmove(name##_get_address(header, index + count), name##_get_address(header, index),                                        \
+            (header->size - index) * sizeof(T));                                                                                 \
+    STATS_ADD(header->stats, bytes_shifted, (header->size - index) * sizeof(T));                                                 \
+    header->size += count;                                                                                                       \
+                                                                                                                                 \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+/* Shrinking at a quarter rather than at half leaves slack on both sides, so                                                     \
+   alternating push_back/pop_back around a boundary never thrashes realloc */                                                    \
+static void name##_shrink_if_sparse(name##_header *const header)                                                                 \
+{                                                                                                                                \
+    if (!header->auto_shrink)                                                                                                    \
+    {                                                                                                                            \
+        return;                                                                                                                  \
+    }                                                                                                                            \
+                                                                                                                                 \
+    ptrdiff_t new_capacity = header->capacity;                                                                                   \
+    while (new_capacity / 2 >= MIN_CAPACITY && header->size < new_capacity / 4)                                                  \
+    {                                                                                                                            \
+        new_capacity /= 2;                                                                                                       \
+    }                                                                                                                            \
+                                                                                                                                 \
+    /* a failure leaves the larger buffer, which is still perfectly usable */                                                    \
+    if (new_capacity != header->capacity)                                                                                        \
+    {                                                                                                                            \
+        name##_set_capacity(header, new_capacity);                                                                               \
+    }                                                                                                                            \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_free(name##_header *const header)                                                                        \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    STATS_ALLOCATOR_CALL(header->stats,                                                                                          \
+                         allocator_release(header->allocator, name##_get_address(header, 0), header->capacity * sizeof(T)));     \
+    name##_invalidate(header);                                                                                                   \
+                                                                                                                                 \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+name##_header name##_init(const ptrdiff_t capacity)                                                                              \
+{                                                                                                                                \
+    return name##_init_with_allocator(capacity, NULL);                                                                           \
+}                                                                                                                                \
+                                                                                                                                 \
+name##_header name##_init_with_allocator(const ptrdiff_t capacity, const vector_allocator *const allocator)                      \
+{                                                                                                                                \
+    if (capacity <= 0 || capacity > MAX_CAPACITY_OF(T))                                                                          \
+    {                                                                                                                            \
+        return (name##_header){0, NULL, 0, 0, 0, allocator, NULL};                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    ptrdiff_t actual_capacity = name##_get_capacity(capacity);                                                                   \
+                                                                                                                                 \
+    T *start_address = allocator_allocate(allocator, actual_capacity * sizeof(T));                                               \
+                                                                                                                                 \
+    if (start_address == NULL)                                                                                                   \
+    {                                                                                                                            \
+        return (name##_header){0, NULL, 0, 0, 0, allocator, NULL};                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return (name##_header){1, start_address, 0, actual_capacity, 1, allocator, NULL};                                            \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_get(const name##_header *const header, const ptrdiff_t index, T *const value)                            \
+{                                                                                                                                \
+    if (header == NULL || value == NULL)                                                                                         \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (index < 0 || index >= header->size)                                                                                      \
+    {                                                                                                                            \
+        return ERR_OUT_OF_BOUNDS;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    *value = *name##_get_address(header, index);                                                                                 \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_set(name##_header *const header, const ptrdiff_t index, const T value)                                   \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (index < 0 || index >= header->size)                                                                                      \
+    {                                                                                                                            \
+        return ERR_OUT_OF_BOUNDS;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    operation_result result = name##_write_range(header, index, 1);                                                              \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    *name##_get_address(header, index) = value;                                                                                  \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_insert(name##_header *const header, const ptrdiff_t index, const T value)                                \
+{                                                                                                                                \
+    /* inserting at size is pushing the element back */                                                                          \
+    operation_result result = name##_open_gap(header, index, 1);                                                                 \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    *name##_get_address(header, index) = value;                                                                                  \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_push_back(name##_header *const header, const T value)                                                    \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_insert(header, header->size, value);                                                                           \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_erase(name##_header *const header, const ptrdiff_t index)                                                \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (index < 0 || index >= header->size)                                                                                      \
+    {                                                                                                                            \
+        return ERR_OUT_OF_BOUNDS;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_erase_range(header, index, 1);                                                                                 \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_pop_back(name##_header *const header)                                                                    \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_erase(header, header->size - 1);                                                                               \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_insert_range(name##_header *const header, const ptrdiff_t index, const T *values, const ptrdiff_t count) \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (values == NULL && count > 0)                                                                                             \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    T *copy;                                                                                                                     \
+    operation_result result = name##_copy_own_values(header, &values, count, &copy);                                             \
+    if (result == OK)                                                                                                            \
+    {                                                                                                                            \
+        result = name##_open_gap(header, index, count);                                                                          \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (result == OK && count > 0)                                                                                               \
+    {                                                                                                                            \
+        memcpy(name##_get_address(header, index), values, count * sizeof(T));                                                    \
+    }                                                                                                                            \
+                                                                                                                                 \
+    free(copy);                                                                                                                  \
+    return result;                                                                                                               \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_erase_range(name##_header *const header, const ptrdiff_t index, const ptrdiff_t count)                   \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (index < 0 || count < 0 || index > header->size - count)                                                                  \
+    {                                                                                                                            \
+        return ERR_OUT_OF_BOUNDS;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    operation_result result = name##_write_range(header, index, header->size - count - index);                                   \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    memmove(name##_get_address(header, index), name##_get_address(header, index + count),                                        \
+            (header->size - index - count) * sizeof(T));                                                                         \
+    STATS_ADD(header->stats, bytes_shifted, (header->size - index - count) * sizeof(T));                                         \
+    header->size -= count;                                                                                                       \
+                                                                                                                                 \
+    name##_shrink_if_sparse(header);                                                                                             \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_push_back_n(name##_header *const header, const ptrdiff_t count, const T value)                           \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    ptrdiff_t index = header->size;                                                                                              \
+                                                                                                                                 \
+    operation_result result = name##_open_gap(header, index, count);                                                             \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    T *address = name##_get_address(header, index);                                                                              \
+    for (ptrdiff_t i = 0; i < count; ++i)                                                                                        \
+    {                                                                                                                            \
+        address[i] = value;                                                                                                      \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_append_array(name##_header *const header, const T *const values, const ptrdiff_t count)                  \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_insert_range(header, header->size, values, count);                                                             \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_assign(name##_header *const header, const T *values, const ptrdiff_t count)                              \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (values == NULL && count > 0)                                                                                             \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (count < 0)                                                                                                               \
+    {                                                                                                                            \
+        return ERR_OUT_OF_BOUNDS;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    T *copy;                                                                                                                     \
+    operation_result result = name##_copy_own_values(header, &values, count, &copy);                                             \
+    if (result == OK)                                                                                                            \
+    {                                                                                                                            \
+        result = name##_reserve_for(header, count);                                                                              \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (result == OK)                                                                                                            \
+    {                                                                                                                            \
+        result = name##_write_range(header, 0, count);                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (result == OK)                                                                                                            \
+    {                                                                                                                            \
+        if (count > 0)                                                                                                           \
+        {                                                                                                                        \
+            memcpy(name##_get_address(header, 0), values, count * sizeof(T));                                                    \
+        }                                                                                                                        \
+        header->size = count;                                                                                                    \
+    }                                                                                                                            \
+                                                                                                                                 \
+    free(copy);                                                                                                                  \
+    return result;                                                                                                               \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_reserve(name##_header *const header, const ptrdiff_t capacity)                                           \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (capacity <= header->capacity)                                                                                            \
+    {                                                                                                                            \
+        return OK;                                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (capacity > MAX_CAPACITY_OF(T))                                                                                           \
+    {                                                                                                                            \
+        return ERR_INVALID_CAPACITY;                                                                                             \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_set_capacity(header, capacity);                                                                                \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_resize(name##_header *const header, const ptrdiff_t size, const T value)                                 \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (size < 0)                                                                                                                \
+    {                                                                                                                            \
+        return ERR_OUT_OF_BOUNDS;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (size > header->size)                                                                                                     \
+    {                                                                                                                            \
+        return name##_push_back_n(header, size - header->size, value);                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_erase_range(header, size, header->size - size);                                                                \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_shrink_to_fit(name##_header *const header)                                                               \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    ptrdiff_t new_capacity = name##_get_capacity(header->size);                                                                  \
+    if (new_capacity == header->capacity)                                                                                        \
+    {                                                                                                                            \
+        return OK;                                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_set_capacity(header, new_capacity);                                                                            \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_prepare_write(name##_header *const header, const ptrdiff_t index, const ptrdiff_t count)                 \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (index < 0 || count < 0 || index > header->capacity - count)                                                              \
+    {                                                                                                                            \
+        return ERR_OUT_OF_BOUNDS;                                                                                                \
+    }                                                                                                                            \
+                                                                                                                                 \
+    return name##_write_range(header, index, count);                                                                             \
+}                                                                                                                                \
+                                                                                                                                 \
+operation_result name##_sort_by(name##_header *const header, const sort_compare compare)                                         \
+{                                                                                                                                \
+    if (header == NULL)                                                                                                          \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (name##_is_invalid(header))                                                                                               \
+    {                                                                                                                            \
+        return ERR_INVALID_HEADER;                                                                                               \
+    }                                                                                                                            \
+                                                                                                                                 \
+    if (compare == NULL)                                                                                                         \
+    {                                                                                                                            \
+        return ERR_NULL;                                                                                                         \
+    }                                                                                                                            \
+                                                                                                                                 \
+    operation_result result = name##_write_range(header, 0, header->size);                                                       \
+    if (result != OK)                                                                                                            \
+    {                                                                                                                            \
+        return result;                                                                                                           \
+    }                                                                                                                            \
+                                                                                                                                 \
+    sort_elements(name##_get_address(header, 0), header->size, sizeof(T), compare);                                              \
+    return OK;                                                                                                                   \
+}                                                                                                                                \
+                                                                                                                                 \
+/* redeclared so that the instantiation takes the caller's semicolon */                                                          \
+operation_result name##_sort_by(name##_header *const header, const sort_compare compare)
@@ -1,11 +1,29 @@
 #pragma once
 
+#include <stddef.h>
+#include <stdint.h>
+#include "../allocator/header.h"
+#include "../stats/header.h"
+
 #define MIN_CAPACITY 32
+// The most elements of type T whose size in bytes still fits in a ptrdiff_t
+#define MAX_CAPACITY_OF(T) (PTRDIFF_MAX / (ptrdiff_t)sizeof(T))
+#define MAX_CAPACITY MAX_CAPACITY_OF(long)
+
+// The header of a vector of T; generic.h instantiates it for other types.
+//   auto_shrink: halve capacity once size drops below a quarter of it
+//   allocator: NULL for malloc; must outlive the vector
+//   stats: NULL unless counters are attached
+#define DECLARE_VECTOR_HEADER(name, T)      \
+    typedef struct                          \
+    {                                       \
+        int is_allocated;                   \
+        T *start_address;                   \
+        ptrdiff_t size;                     \
+        ptrdiff_t capacity;                 \
+        int auto_shrink;                    \
+        const vector_allocator *allocator;  \
+        vector_stats *stats;                \
+    } name##_header
 
-typedef struct
-{
-    int is_allocated;
-    long *start_address;
-    int size;
-    int capacity;
-} vector_header;
+DECLARE_VECTOR_HEADER(vector, long);
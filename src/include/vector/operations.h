@@ -1,13 +1,38 @@
 #pragma once
 
 #include "header.h"
+#include "generic.h"
+#include "../batch/header.h"
 #include "../operation_result.h"
 
-vector_header init_vector(const int capacity);
+// The long instance of generic.h, which the classic operations below wrap
+DECLARE_VECTOR_OPERATIONS(vector, long);
+
+vector_header init_vector(const ptrdiff_t capacity);
+vector_header init_vector_with_allocator(const ptrdiff_t capacity, const vector_allocator *const allocator);
 operation_result free_vector(vector_header *header);
-long get(const vector_header *header, int index);
-operation_result set(vector_header *const header, const int index, const long value);
-operation_result insert(vector_header *const header, const int index, const long value);
+long get(const vector_header *header, ptrdiff_t index);
+operation_result set(vector_header *const header, const ptrdiff_t index, const long value);
+operation_result insert(vector_header *const header, const ptrdiff_t index, const long value);
 operation_result push_back(vector_header *const header, const long value);
-operation_result erase(vector_header *const header, const int index);
+operation_result erase(vector_header *const header, const ptrdiff_t index);
 operation_result pop_back(vector_header *const header);
+// values may point into the vector itself; such elements are copied out first
+operation_result insert_range(vector_header *const header, const ptrdiff_t index, const long *values, const ptrdiff_t count);
+operation_result erase_range(vector_header *const header, const ptrdiff_t index, const ptrdiff_t count);
+operation_result push_back_n(vector_header *const header, const ptrdiff_t count, const long value);
+operation_result append_array(vector_header *const header, const long *const values, const ptrdiff_t count);
+operation_result assign(vector_header *const header, const long *values, const ptrdiff_t count);
+// Grows capacity to exactly capacity if it is below that; never shrinks.
+// Erasing can still shrink it back unless auto_shrink is off.
+operation_result reserve(vector_header *const header, const ptrdiff_t capacity);
+// Truncates to size, or grows to it filling new elements with value
+operation_result resize(vector_header *const header, const ptrdiff_t size, const long value);
+// Brings capacity down to size, or MIN_CAPACITY for smaller vectors
+operation_result shrink_to_fit(vector_header *const header);
+// Applies count edits as if one after another, but moves each element at most
+// once and grows at most once. Nothing changes if any edit is out of bounds.
+operation_result vector_apply_batch(vector_header *const header, const vector_edit *const edits, const ptrdiff_t count);
+// For code writing [index, index + count) through start_address directly:
+// lets a copy-on-write allocator copy out what snapshots still see there first
+operation_result vector_prepare_write(vector_header *const header, const ptrdiff_t index, const ptrdiff_t count);
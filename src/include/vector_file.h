@@ -0,0 +1,4 @@
+#pragma once
+
+#include "vector_file/header.h"
+#include "vector_file/operations.h"
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "../allocator/header.h"
+
+#define VECTOR_FILE_MAGIC "VECFILE"
+#define VECTOR_FILE_VERSION 1
+#define VECTOR_FILE_LONG 1
+
+// On-disk layout: this header, then capacity raw elements in native byte
+// order. 64 bytes keeps the elements behind it aligned. The checksum is
+// FNV-1a over the first size elements and is only current after a save,
+// sync or close.
+typedef struct
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t element_type;
+    uint32_t element_size;
+    uint32_t flags;
+    uint64_t size;
+    uint64_t capacity;
+    uint64_t checksum;
+    uint64_t reserved[2];
+} vector_file_header;
+
+_Static_assert(sizeof(vector_file_header) == 64, "vector_file_header must stay 64 bytes");
+
+// A vector file mapped into memory. Vectors opened on it use its allocator,
+// so the file must outlive them and must not move.
+typedef struct
+{
+    int fd;
+    char *mapping;
+    size_t length;
+    int writable;
+    vector_allocator allocator;
+} vector_file;
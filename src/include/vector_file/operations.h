@@ -0,0 +1,16 @@
+#pragma once
+
+#include "header.h"
+#include "../vector/header.h"
+#include "../deamortized_vector/header.h"
+#include "../operation_result.h"
+
+operation_result vector_save(const vector_header *const header, const char *const path);
+operation_result vector_open_mmap(vector_file *const file, vector_header *const header, const char *const path);
+operation_result vector_open_file(vector_file *const file, vector_header *const header, const char *const path);
+operation_result vector_sync_file(vector_file *const file, const vector_header *const header);
+operation_result vector_close_file(vector_file *const file, vector_header *const header);
+operation_result vector_verify_file(const vector_file *const file);
+
+operation_result deamortized_vector_save(const deamortized_vector_header *const header, const char *const path);
+operation_result deamortized_vector_load(deamortized_vector_header *const header, const char *const path);
@@ -1,13 +1,81 @@
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
 #include <time.h>
+#include <pthread.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/mman.h>
 #include "include/vector.h"
 #include "include/deamortized_vector.h"
+#include "include/typed_vectors.h"
+#include "include/tiered_vector.h"
+#include "include/allocator.h"
+#include "include/vector_file.h"
+#include "include/concurrent_vector.h"
+#include "include/search.h"
+#include "include/sorted_vector.h"
+#include "include/span.h"
+#include "include/stats.h"
+#include "include/small_vector.h"
+#include "include/segmented_vector.h"
+#include "include/deque.h"
+#include "include/compat.h"
+#include "include/snapshot.h"
+#include "include/batch.h"
+#include "include/sort.h"
+#include "include/packed_vector.h"
 
 #define TEST_CAPACITY 64
 #define TEST_VALUE 42L
 #define STRESS_TEST_SIZE 1000
+#define TEST_FILE "c_vector_test.vec"
+#define CONCURRENT_TEST_THREADS 8
+#define CONCURRENT_TEST_PUSHES 100000
+// Just past INT_MAX, so indices and sizes no longer fit in an int
+#define SPARSE_TEST_CAPACITY ((ptrdiff_t)INT_MAX + 1024)
+// 13 chunks of SNAPSHOT_CHUNK_SIZE
+#define SNAPSHOT_TEST_SIZE 100000
+#define SNAPSHOT_TEST_VIEWS 4
+// ./c_vector --large: 24GB of longs, dense
+#define LARGE_TEST_ELEMENTS (3L << 30)
+
+typedef struct
+{
+    short id;
+    char tag;
+} small_record;
+
+DECLARE_VECTOR(record_vector, small_record);
+DEFINE_VECTOR(record_vector, small_record);
+
+// Reserves address space without committing memory, so a vector can have
+// more than INT_MAX elements while only the pages a test touches are real
+static void *sparse_allocate(void *context, size_t size)
+{
+    (void)context;
+    void *address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+    return address == MAP_FAILED ? NULL : address;
+}
+
+static void *sparse_reallocate(void *context, void *address, size_t old_size, size_t new_size)
+{
+    (void)context;
+    void *moved = mremap(address, old_size, new_size, MREMAP_MAYMOVE);
+
+    return moved == MAP_FAILED ? NULL : moved;
+}
+
+static void sparse_release(void *context, void *address, size_t size)
+{
+    (void)context;
+    munmap(address, size);
+}
+
+static const vector_allocator sparse_allocator = {sparse_allocate, sparse_reallocate, sparse_release, NULL, NULL};
 
 void test_initialization(void)
 {
@@ -140,377 +208,3367 @@ void test_edge_cases(void)
     printf("Passed!\n\n");
 }
 
-void test_stress(void)
+void test_range_operations(void)
 {
-    printf("Testing stress...\n");
+    printf("Testing range operations...\n");
     vector_header h = init_vector(MIN_CAPACITY);
+    long values[100];
 
-    // Stress test push_back
-    for (int i = 0; i < STRESS_TEST_SIZE; i++)
+    for (int i = 0; i < 100; i++)
     {
-        assert(push_back(&h, i) == OK);
+        values[i] = i;
     }
-    assert(h.size == STRESS_TEST_SIZE);
 
-    // Stress test get
-    for (int i = 0; i < STRESS_TEST_SIZE; i++)
+    // Test append_array grows once past several doublings
+    assert(append_array(&h, values, 100) == OK);
+    assert(h.size == 100);
+    assert(h.capacity == 128);
+
+    // Test insert_range in the middle
+    assert(insert_range(&h, 10, values, 5) == OK);
+    assert(h.size == 105);
+    assert(get(&h, 9) == 9);
+    for (int i = 0; i < 5; i++)
+    {
+        assert(get(&h, 10 + i) == i);
+    }
+    assert(get(&h, 15) == 10);
+    assert(get(&h, 104) == 99);
+
+    // Test erase_range restores the original order
+    assert(erase_range(&h, 10, 5) == OK);
+    assert(h.size == 100);
+    for (int i = 0; i < 100; i++)
     {
         assert(get(&h, i) == i);
     }
 
-    // Stress test pop_back
-    for (int i = 0; i < STRESS_TEST_SIZE; i++)
+    // Test push_back_n
+    assert(push_back_n(&h, 3, TEST_VALUE) == OK);
+    assert(h.size == 103);
+    assert(get(&h, 100) == TEST_VALUE && get(&h, 102) == TEST_VALUE);
+
+    // Test assign replaces contents
+    assert(assign(&h, values + 50, 10) == OK);
+    assert(h.size == 10);
+    assert(get(&h, 0) == 50 && get(&h, 9) == 59);
+
+    // Test the vector's own elements as input: appending itself at full
+    // capacity reallocates, and a subrange straddling the insertion point
+    // gets shifted, before the values are read
+    ptrdiff_t full = h.capacity;
+    long expected[] = {53, 54, 54, 55, 56, 55, 56, 57};
+
+    assert(push_back_n(&h, full - h.size, 0) == OK);
+    assert(append_array(&h, h.start_address, h.size) == OK);
+    assert(h.size == 2 * full && get(&h, full) == 50 && get(&h, full + 9) == 59);
+    assert(assign(&h, h.start_address + 3, 5) == OK);
+    assert(insert_range(&h, 2, h.start_address + 1, 3) == OK);
+    assert(h.size == 8);
+    for (int i = 0; i < 8; i++)
     {
-        assert(pop_back(&h) == OK);
+        assert(get(&h, i) == expected[i]);
     }
+    assert(assign(&h, values + 50, 10) == OK);
+
+    // Test invalid ranges
+    assert(erase_range(&h, 5, 6) == ERR_OUT_OF_BOUNDS);
+    assert(erase_range(&h, -1, 1) == ERR_OUT_OF_BOUNDS);
+    assert(insert_range(&h, 11, values, 1) == ERR_OUT_OF_BOUNDS);
+    assert(insert_range(&h, 0, NULL, 1) == ERR_NULL);
+    assert(insert_range(&h, 0, NULL, 0) == OK);
+    assert(erase_range(&h, 0, 10) == OK);
     assert(h.size == 0);
 
     free_vector(&h);
     printf("Passed!\n\n");
 }
 
-void test_deamortized_vector_basic(void)
+void test_shrinking(void)
 {
-    printf("Testing deamortized vector...\n");
-
-    // Test initialization
-    deamortized_vector_header dh = init_deamortized_vector(TEST_CAPACITY);
-    assert(dh.current_vector.capacity == TEST_CAPACITY);
-    assert(dh.current_vector.size == 0);
-    assert(dh.current_vector.is_allocated);
-    assert(dh.next_vector.capacity == TEST_CAPACITY * 2);
-    assert(dh.next_vector.size == 0);
-    assert(dh.next_vector.is_allocated);
-    assert(dh.reallocated_amount == 0);
+    printf("Testing shrinking...\n");
+    vector_header h = init_vector(MIN_CAPACITY);
 
-    // Test push_back
-    for (int i = 0; i < 5; i++)
+    for (int i = 0; i < 1000; i++)
     {
-        assert(deamortized_push_back(&dh, i * 10) == OK);
-        assert(dh.current_vector.size == i + 1);
+        assert(push_back(&h, i) == OK);
     }
+    assert(h.capacity == 1024);
 
-    // Test get
-    for (int i = 0; i < 5; i++)
+    // Test halving happens only below a quarter
+    while (h.size > 256)
     {
-        assert(deamortized_get(&dh, i) == i * 10);
+        assert(pop_back(&h) == OK);
     }
+    assert(h.capacity == 1024);
+    assert(pop_back(&h) == OK);
+    assert(h.capacity == 512);
 
-    // Test set
-    assert(deamortized_set(&dh, 2, TEST_VALUE) == OK);
-    assert(deamortized_get(&dh, 2) == TEST_VALUE);
-
-    // Test insert
-    assert(deamortized_insert(&dh, 2, 100) == OK);
-    assert(deamortized_get(&dh, 2) == 100);
-    assert(deamortized_get(&dh, 3) == TEST_VALUE);
-
-    // Test erase
-    assert(deamortized_erase(&dh, 2) == OK);
-    assert(deamortized_get(&dh, 2) == TEST_VALUE);
+    // Test hysteresis: no reallocation back and forth at the boundary
+    assert(push_back(&h, 255) == OK);
+    assert(pop_back(&h) == OK);
+    assert(h.capacity == 512);
 
-    // Test pop_back
-    assert(deamortized_pop_back(&dh) == OK);
-    assert(dh.current_vector.size == 4);
+    // Test erase_range shrinks by several halvings at once
+    assert(erase_range(&h, 0, h.size - 3) == OK);
+    assert(h.capacity == MIN_CAPACITY);
+    assert(get(&h, 0) == 252 && get(&h, 2) == 254);
 
-    // Test invalid operations
-    assert(deamortized_insert(&dh, 10, 10) == ERR_OUT_OF_BOUNDS);
-    assert(deamortized_erase(&dh, 10) == ERR_OUT_OF_BOUNDS);
-    assert(deamortized_pop_back(&dh) == OK);
-    assert(deamortized_pop_back(&dh) == OK);
-    assert(deamortized_pop_back(&dh) == OK);
-    assert(deamortized_pop_back(&dh) == OK);
-    assert(deamortized_pop_back(&dh) == ERR_OUT_OF_BOUNDS);
+    // Test shrinking can be disabled
+    h.auto_shrink = 0;
+    assert(push_back_n(&h, 200, TEST_VALUE) == OK);
+    assert(erase_range(&h, 0, h.size) == OK);
+    assert(h.capacity == 256);
 
-    free_deamortized_vector(&dh);
+    free_vector(&h);
     printf("Passed!\n\n");
 }
 
-void fuzz_vector_operations(void)
+// Fills edits with count random edits valid against a vector of size elements
+static void random_edits(vector_edit *const edits, const int count, ptrdiff_t size)
 {
-    printf("Fuzz testing vector operations...\n");
-    srand((unsigned int)time(NULL));
-
-    for (int i = 0; i < 1000; i++)
+    for (int i = 0; i < count; i++)
     {
-        vector_header h = init_vector(MIN_CAPACITY);
-        int operations = rand() % 100;
-
-        for (int j = 0; j < operations; j++)
-        {
-            int op = rand() % 5;
-            int index = rand() % (h.size + 1);
-            int value = rand();
+        edit_kind kind = size == 0 ? EDIT_INSERT : (edit_kind)(rand() % 3);
+        ptrdiff_t index = rand() % (size + (kind == EDIT_INSERT));
 
-            switch (op)
-            {
-            case 0: // push_back
-                push_back(&h, value);
-                break;
-            case 1: // insert
-                insert(&h, index, value);
-                break;
-            case 2: // set
-                if (h.size > 0)
-                    set(&h, index % h.size, value);
-                break;
-            case 3: // get
-                if (h.size > 0)
-                    get(&h, index % h.size);
-                break;
-            case 4: // erase
-                if (h.size > 0)
-                    erase(&h, index % h.size);
-                break;
-            }
-        }
-
-        free_vector(&h);
+        edits[i] = (vector_edit){kind, index, rand()};
+        size += kind == EDIT_INSERT ? 1 : kind == EDIT_ERASE ? -1 : 0;
     }
-
-    printf("Fuzz testing passed!\n\n");
 }
 
-void vector_tests(void)
+static void apply_edits_one_by_one(vector_header *const header, const vector_edit *const edits, const int count)
 {
-    test_initialization();
-    test_basic_operations();
-    test_insert_delete();
-    test_capacity_management();
-    test_edge_cases();
-    test_stress();
-    fuzz_vector_operations();
-    printf("All vector tests passed!\n");
+    for (int i = 0; i < count; i++)
+    {
+        switch (edits[i].kind)
+        {
+        case EDIT_INSERT:
+            assert(insert(header, edits[i].index, edits[i].value) == OK);
+            break;
+        case EDIT_ERASE:
+            assert(erase(header, edits[i].index) == OK);
+            break;
+        case EDIT_SET:
+            assert(set(header, edits[i].index, edits[i].value) == OK);
+            break;
+        }
+    }
 }
 
-void test_deamortized_reallocation_process(void)
+void test_reserve_resize(void)
 {
-    printf("Testing deamortized reallocation process...\n");
-
-    // Initialize with small capacity to observe reallocations
-    deamortized_vector_header dh = init_deamortized_vector(4);
-
-    // MIN_CAPACITY thing
-    assert(dh.current_vector.capacity == 32);
-    assert(dh.next_vector.capacity == 64);
+    printf("Testing reserve and resize...\n");
+    vector_header h = init_vector(MIN_CAPACITY);
 
-    // Fill current vector
-    for (int i = 0; i < 4; i++)
+    // Test reserve takes capacity to exactly what was asked, and only up
+    assert(reserve(&h, 1000) == OK && h.capacity == 1000);
+    assert(reserve(&h, 10) == OK && h.capacity == 1000);
+    for (int i = 0; i < 1000; i++)
     {
-        assert(deamortized_push_back(&dh, i) == OK);
-        assert(dh.reallocated_amount == 0); // No reallocation yet
+        assert(push_back(&h, i) == OK);
     }
+    assert(h.capacity == 1000);
+    assert(reserve(&h, MAX_CAPACITY + 1) == ERR_INVALID_CAPACITY);
+
+    // Test resize fills when growing and truncates when shrinking
+    assert(resize(&h, 1500, TEST_VALUE) == OK);
+    assert(h.size == 1500 && get(&h, 999) == 999 && get(&h, 1000) == TEST_VALUE && get(&h, 1499) == TEST_VALUE);
+    assert(resize(&h, 40, 0) == OK);
+    assert(h.size == 40 && get(&h, 39) == 39);
+    assert(resize(&h, -1, 0) == ERR_OUT_OF_BOUNDS);
+
+    // Test shrink_to_fit goes down to the size, but not below MIN_CAPACITY
+    assert(shrink_to_fit(&h) == OK && h.capacity == 40);
+    assert(get(&h, 0) == 0 && get(&h, 39) == 39);
+    assert(resize(&h, 3, 0) == OK && shrink_to_fit(&h) == OK);
+    assert(h.capacity == MIN_CAPACITY && get(&h, 2) == 2);
+
+    assert(reserve(NULL, 1) == ERR_NULL);
+    assert(resize(NULL, 1, 0) == ERR_NULL);
+    assert(shrink_to_fit(NULL) == ERR_NULL);
+    free_vector(&h);
+    assert(shrink_to_fit(&h) == ERR_INVALID_HEADER);
+    printf("Passed!\n\n");
+}
 
-    // Trigger reallocation process
-    assert(deamortized_push_back(&dh, 4) == OK);
-
-    // not the time to reallocate
-    assert(dh.reallocated_amount == 0);
+void test_batch_edits(void)
+{
+    printf("Testing batched edits...\n");
+    vector_header h = init_vector(MIN_CAPACITY);
+    vector_stats stats = {0};
+    vector_edit edits[128];
 
-    // Verify elements exist in both vectors during migration
-    for (int i = 0; i <= dh.reallocated_amount; i++)
+    for (int i = 0; i < 10; i++)
     {
-        assert(deamortized_get(&dh, i) == i);
+        assert(push_back(&h, i) == OK);
     }
 
-    // Complete reallocation
-    while (dh.reallocated_amount < dh.current_vector.size)
+    // Test each index refers to the vector as the edits before it left it
+    edits[0] = (vector_edit){EDIT_INSERT, 0, -1};
+    edits[1] = (vector_edit){EDIT_ERASE, 5, 0};
+    edits[2] = (vector_edit){EDIT_SET, 9, 90};
+    edits[3] = (vector_edit){EDIT_INSERT, 10, 100};
+    edits[4] = (vector_edit){EDIT_SET, 0, -2};
+    assert(vector_apply_batch(&h, edits, 5) == OK);
+
+    long expected[] = {-2, 0, 1, 2, 3, 5, 6, 7, 8, 90, 100};
+    assert(h.size == 11);
+    for (int i = 0; i < h.size; i++)
     {
-        int prev_realloc = dh.reallocated_amount;
-        assert(deamortized_push_back(&dh, dh.current_vector.size) == OK);
-        assert(dh.reallocated_amount >= prev_realloc);
+        assert(get(&h, i) == expected[i]);
     }
 
-    // Verify final state after full reallocation
-    assert(dh.current_vector.capacity == 32);
-    assert(dh.next_vector.capacity == 64);
+    // Test a bad edit anywhere in the batch leaves the vector untouched
+    edits[0] = (vector_edit){EDIT_ERASE, 0, 0};
+    edits[1] = (vector_edit){EDIT_SET, 10, 0};
+    assert(vector_apply_batch(&h, edits, 2) == ERR_OUT_OF_BOUNDS);
+    assert(h.size == 11 && get(&h, 0) == -2 && get(&h, 10) == 100);
+    assert(vector_apply_batch(&h, NULL, 1) == ERR_NULL);
+    assert(vector_apply_batch(&h, NULL, 0) == OK);
+    assert(vector_apply_batch(NULL, edits, 1) == ERR_NULL);
+
+    // Test a batch outgrowing capacity several times over grows once
+    assert(vector_attach_stats(&h, &stats) == OK);
+    for (int i = 0; i < 100; i++)
+    {
+        edits[i] = (vector_edit){EDIT_INSERT, i % 2 == 0 ? h.size + i : 0, i};
+    }
+    assert(vector_apply_batch(&h, edits, 100) == OK);
+    assert(h.size == 111 && h.capacity == 128);
+    assert(get(&h, 0) == 99 && get(&h, 50) == -2 && get(&h, 110) == 98);
+#ifdef VECTOR_STATS
+    assert(stats.grows == 1);
+#endif
+    free_vector(&h);
 
-    // Verify all elements
-    for (int i = 0; i < 8; i++)
+    // Test batches match the same edits made one at a time
+    for (int i = 0; i < 500; i++)
     {
-        assert(deamortized_get(&dh, i) == i);
+        h = init_vector(MIN_CAPACITY);
+        vector_header reference = init_vector(MIN_CAPACITY);
+        int size = rand() % 200;
+        int count = rand() % 128;
+
+        for (int j = 0; j < size; j++)
+        {
+            long value = rand();
+            assert(push_back(&h, value) == OK);
+            assert(push_back(&reference, value) == OK);
+        }
+
+        random_edits(edits, count, size);
+        apply_edits_one_by_one(&reference, edits, count);
+        assert(vector_apply_batch(&h, edits, count) == OK);
+
+        assert(h.size == reference.size);
+        for (int j = 0; j < h.size; j++)
+        {
+            assert(get(&h, j) == get(&reference, j));
+        }
+
+        free_vector(&reference);
+        free_vector(&h);
     }
 
-    free_deamortized_vector(&dh);
     printf("Passed!\n\n");
 }
 
-void test_deamortized_complex_operations(void)
+void test_typed_vectors(void)
 {
-    printf("Testing complex deamortized operations...\n");
-    deamortized_vector_header dh = init_deamortized_vector(8);
+    printf("Testing typed vectors...\n");
 
-    // Fill initial vector
-    for (int i = 0; i < 10; i++)
+    // Test elements keep their real size
+    int32_vector_header ih = int32_vector_init(MIN_CAPACITY);
+    assert(ih.is_allocated && ih.capacity == MIN_CAPACITY);
+    assert(sizeof(*ih.start_address) == sizeof(int32_t));
+
+    for (int i = 0; i < 100; i++)
     {
-        assert(deamortized_push_back(&dh, i) == OK);
+        assert(int32_vector_push_back(&ih, i) == OK);
     }
+    assert(int32_vector_insert(&ih, 0, -1) == OK);
+    assert(int32_vector_erase(&ih, 50) == OK);
+
+    int32_t value = 0;
+    assert(int32_vector_get(&ih, 0, &value) == OK && value == -1);
+    assert(int32_vector_get(&ih, 50, &value) == OK && value == 50);
+    assert(int32_vector_get(&ih, 99, &value) == OK && value == 99);
+    assert(int32_vector_get(&ih, 100, &value) == ERR_OUT_OF_BOUNDS);
+    assert(int32_vector_get(&ih, 0, NULL) == ERR_NULL);
+    int32_vector_free(&ih);
+
+    // Test floating point and bulk operations
+    double_vector_header dh = double_vector_init(MIN_CAPACITY);
+    double doubles[] = {0.5, 1.5, 2.5};
+    assert(double_vector_append_array(&dh, doubles, 3) == OK);
+    assert(double_vector_set(&dh, 1, 3.25) == OK);
+
+    double d = 0;
+    assert(double_vector_get(&dh, 1, &d) == OK && d == 3.25);
+    assert(double_vector_erase_range(&dh, 0, 3) == OK && dh.size == 0);
+    double_vector_free(&dh);
+
+    // Test struct elements
+    record_vector_header rh = record_vector_init(MIN_CAPACITY);
+    assert(record_vector_push_back_n(&rh, 40, (small_record){7, 'x'}) == OK);
+    assert(record_vector_set(&rh, 39, (small_record){8, 'y'}) == OK);
+
+    small_record record;
+    assert(record_vector_get(&rh, 0, &record) == OK && record.id == 7 && record.tag == 'x');
+    assert(record_vector_get(&rh, 39, &record) == OK && record.id == 8 && record.tag == 'y');
+    assert(record_vector_pop_back(&rh) == OK && rh.size == 39);
+    record_vector_free(&rh);
+
+    // Test the allocator, capacity and self-aliasing paths are shared with long
+    vector_arena arena = init_arena(1 << 16);
+    double_vector_header ah = double_vector_init_with_allocator(MIN_CAPACITY, arena_allocator(&arena));
+    assert(ah.is_allocated && ah.allocator == arena_allocator(&arena));
+    assert(double_vector_reserve(&ah, 1000) == OK && ah.capacity == 1000);
+    assert(arena.used == 1000 * sizeof(double));
+    assert(double_vector_resize(&ah, 3, 1.5) == OK && ah.size == 3);
+    assert(double_vector_append_array(&ah, ah.start_address, 3) == OK && ah.size == 6);
+    assert(double_vector_get(&ah, 5, &d) == OK && d == 1.5);
+    assert(double_vector_shrink_to_fit(&ah) == OK && ah.capacity == MIN_CAPACITY);
+    double_vector_free(&ah);
+    free_arena(&arena);
+
+    // Test sizes are checked against each element type's own limit
+    assert(MAX_CAPACITY_OF(int32_t) > MAX_CAPACITY);
+    assert(!int32_vector_init(MAX_CAPACITY_OF(int32_t) + 1).is_allocated);
+    ih = int32_vector_init(MIN_CAPACITY);
+    assert(int32_vector_push_back(&ih, 1) == OK);
+    assert(int32_vector_push_back_n(&ih, MAX_CAPACITY_OF(int32_t), 0) == ERR_INVALID_CAPACITY);
+    assert(int32_vector_reserve(&ih, MAX_CAPACITY_OF(int32_t) + 1) == ERR_INVALID_CAPACITY);
+    assert(ih.size == 1 && ih.capacity == MIN_CAPACITY);
+    int32_vector_free(&ih);
+
+    int32_deamortized_vector_header idh = int32_deamortized_vector_init(MIN_CAPACITY);
+    assert(int32_deamortized_vector_push_back_n(&idh, MAX_CAPACITY_OF(int32_t), 0) == ERR_INVALID_CAPACITY);
+    assert(int32_deamortized_vector_reserve(&idh, MAX_CAPACITY_OF(int32_t) / 4 + 1) == ERR_INVALID_CAPACITY);
+    assert(int32_deamortized_vector_size(&idh) == 0);
+    int32_deamortized_vector_free(&idh);
+
+    // Test invalid header
+    int32_vector_header invalid = {0};
+    assert(int32_vector_push_back(&invalid, 1) == ERR_INVALID_HEADER);
+    assert(int32_vector_free(&invalid) == ERR_INVALID_HEADER);
 
-    // Interleave insertions during reallocation
-    assert(deamortized_insert(&dh, 5, 100) == OK);
-    assert(deamortized_get(&dh, 5) == 100);
-    assert(deamortized_get(&dh, 6) == 5); // Subsequent elements shifted
+    printf("Passed!\n\n");
+}
 
-    // Modify elements during reallocation
-    for (int i = 0; i < 5; i++)
-    {
-        assert(deamortized_set(&dh, i, i * 2) == OK);
-    }
+void test_arena_allocator(void)
+{
+    printf("Testing arena allocator...\n");
+    vector_arena arena = init_arena(1 << 16);
+    assert(arena.start_address != NULL);
 
-    // Verify mixed access
-    for (int i = 0; i < 5; i++)
-    {
-        assert(deamortized_get(&dh, i) == i * 2);
-    }
-    for (int i = 5; i < get_size(&dh); i++)
+    // Test growth of the newest block happens in place
+    vector_header h = init_vector_with_allocator(MIN_CAPACITY, arena_allocator(&arena));
+    assert(h.is_allocated);
+    long *start_address = h.start_address;
+
+    for (int i = 0; i < 1000; i++)
     {
-        assert(deamortized_get(&dh, i) == (i < 6 ? 100 : i - 1));
+        assert(push_back(&h, i) == OK);
     }
+    assert(h.start_address == start_address);
+    assert(arena.used == h.capacity * sizeof(long));
 
-    // Force multiple reallocations
+    // Test an older block is copied when it grows
+    vector_header other = init_vector_with_allocator(MIN_CAPACITY, arena_allocator(&arena));
+    assert(other.is_allocated);
     for (int i = 0; i < 1000; i++)
     {
-        assert(deamortized_push_back(&dh, i) == OK);
+        assert(push_back(&h, i) == OK);
     }
-    assert(get_size(&dh) == 1011);
-
-    // Verify capacity growth pattern
-    assert(dh.current_vector.capacity >= 1024);
+    assert(h.start_address != start_address);
+    assert(get(&h, 999) == 999 && get(&h, 1999) == 999);
 
-    // Test front/middle/back deletions during reallocation
-    assert(deamortized_erase(&dh, 0) == OK);
-    assert(deamortized_erase(&dh, 500) == OK);
-    assert(deamortized_erase(&dh, get_size(&dh) - 1) == OK);
+    // Test exhaustion is reported, not crashed on
+    assert(push_back_n(&other, 1 << 16, 0) == ERR_REALLOC_FAILED);
+    assert(init_vector_with_allocator(1 << 16, arena_allocator(&arena)).is_allocated == 0);
 
-    free_deamortized_vector(&dh);
+    free_vector(&other);
+    free_vector(&h);
+    reset_arena(&arena);
+    assert(arena.used == 0);
+    free_arena(&arena);
     printf("Passed!\n\n");
 }
 
-void test_deamortized_edge_cases(void)
+void test_mmap_allocator(void)
 {
-    printf("Testing deamortized edge cases...\n");
+    printf("Testing mmap allocator...\n");
+    vector_mmap mapping = init_mmap(4096, 1 << 21, 1);
 
-    // Test empty vector operations
-    deamortized_vector_header dh = init_deamortized_vector(4);
-    assert(deamortized_pop_back(&dh) == ERR_OUT_OF_BOUNDS);
-    assert(deamortized_erase(&dh, 0) == ERR_OUT_OF_BOUNDS);
+    // Test buffers cross from malloc to mmap and then grow by remapping
+    vector_header h = init_vector_with_allocator(MIN_CAPACITY, mmap_allocator(&mapping));
+    assert(h.is_allocated);
+    for (int i = 0; i < 1000000; i++)
+    {
+        assert(push_back(&h, i) == OK);
+    }
+    assert(mapping.remaps > 0);
+    for (int i = 0; i < 1000000; i += 997)
+    {
+        assert(get(&h, i) == i);
+    }
 
-    // Test partial reallocation access
-    for (int i = 0; i < 5; i++)
+    // Test shrinking remaps down and back below the threshold
+    assert(erase_range(&h, 10, h.size - 10) == OK);
+    assert(h.capacity * sizeof(long) < mapping.mmap_threshold);
+    for (int i = 0; i < 10; i++)
     {
-        deamortized_push_back(&dh, i);
+        assert(get(&h, i) == i);
     }
-    assert(deamortized_get(&dh, 4) == 4);
-    assert(deamortized_get(&dh, 5) == ERR_OUT_OF_BOUNDS);
+    free_vector(&h);
+
+    // Test a deamortized vector keeps both buffers mapped
+    deamortized_vector_header dh = init_deamortized_vector_with_allocator(MIN_CAPACITY, mmap_allocator(&mapping));
+    for (int i = 0; i < 100000; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+    }
+    for (int i = 0; i < 100000; i += 101)
+    {
+        assert(deamortized_get(&dh, i) == i);
+    }
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_vector_file(void)
+{
+    printf("Testing vector files...\n");
+    vector_header h = init_vector(MIN_CAPACITY);
+    for (int i = 0; i < 10000; i++)
+    {
+        assert(push_back(&h, i * 3) == OK);
+    }
+    assert(vector_save(&h, TEST_FILE) == OK);
+
+    // Test a saved vector maps back read-only with the same contents
+    vector_file file;
+    vector_header mapped;
+    assert(vector_open_mmap(&file, &mapped, TEST_FILE) == OK);
+    assert(vector_verify_file(&file) == OK);
+    assert(mapped.size == h.size);
+    for (int i = 0; i < mapped.size; i++)
+    {
+        assert(get(&mapped, i) == get(&h, i));
+    }
+
+    // Test writes stay private and growth is refused
+    assert(set(&mapped, 0, -1) == OK);
+    assert(push_back(&mapped, 0) == ERR_REALLOC_FAILED);
+    assert(vector_close_file(&file, &mapped) == OK);
+    assert(!mapped.is_allocated);
+    assert(vector_open_mmap(&file, &mapped, TEST_FILE) == OK);
+    assert(get(&mapped, 0) == 0);
+    assert(vector_close_file(&file, &mapped) == OK);
+
+    // Test a writable file grows with push_back and keeps it after closing
+    assert(vector_open_file(&file, &mapped, TEST_FILE) == OK);
+    for (int i = 0; i < 50000; i++)
+    {
+        assert(push_back(&mapped, i) == OK);
+    }
+    assert(erase_range(&mapped, 0, 5000) == OK);
+    assert(vector_close_file(&file, &mapped) == OK);
+
+    assert(vector_open_mmap(&file, &mapped, TEST_FILE) == OK);
+    assert(vector_verify_file(&file) == OK);
+    assert(mapped.size == 55000);
+    assert(get(&mapped, 0) == 15000 && get(&mapped, 4999) == 29997);
+    assert(get(&mapped, 5000) == 0 && get(&mapped, 54999) == 49999);
+    assert(vector_close_file(&file, &mapped) == OK);
+
+    // Test a new file is created empty
+    remove(TEST_FILE);
+    assert(vector_open_file(&file, &mapped, TEST_FILE) == OK);
+    assert(mapped.size == 0 && mapped.capacity == MIN_CAPACITY);
+    assert(vector_close_file(&file, &mapped) == OK);
+
+    // Test anything but a vector file is rejected
+    FILE *stream = fopen(TEST_FILE, "wb");
+    fputs("definitely not a vector file, but long enough to hold the header......", stream);
+    fclose(stream);
+    assert(vector_open_mmap(&file, &mapped, TEST_FILE) == ERR_INVALID_FILE);
+    assert(vector_open_mmap(&file, &mapped, "no/such/dir/file.vec") == ERR_IO);
+
+    remove(TEST_FILE);
+    free_vector(&h);
+    printf("Passed!\n\n");
+}
+
+void test_search_kernels(void)
+{
+    printf("Testing search kernels at every SIMD level...\n");
+    const search_kernels *scalar = get_search_kernels(SIMD_SCALAR);
+    long extremes[] = {LONG_MIN, LONG_MAX, -1, 0, 1, (long)1 << 32, -((long)1 << 32), 0xFFFFFFFFL};
+    long values[300];
+
+    for (int level = SIMD_SCALAR; level <= (int)get_simd_level(); level++)
+    {
+        const search_kernels *kernels = get_search_kernels(level);
+        assert(kernels != NULL);
+
+        // Test every length around the vector widths, with values that trip up
+        // 64-bit compares built from 32-bit halves
+        for (int count = 0; count < 300; count++)
+        {
+            for (int i = 0; i < count; i++)
+            {
+                long magnitude = (long)((unsigned long)rand() << (rand() % 32));
+                values[i] = rand() % 3 == 0 ? extremes[rand() % 8] : rand() % 2 ? magnitude : -magnitude;
+            }
+
+            long key = count > 0 ? values[rand() % count] : 0;
+            assert(kernels->find(values, count, key) == scalar->find(values, count, key));
+            assert(kernels->find(values, count, 12345) == scalar->find(values, count, 12345));
+            assert(kernels->count(values, count, key) == scalar->count(values, count, key));
+            assert(kernels->sum(values, count) == scalar->sum(values, count));
+            if (count > 0)
+            {
+                assert(kernels->min(values, count) == scalar->min(values, count));
+                assert(kernels->max(values, count) == scalar->max(values, count));
+            }
+        }
+    }
+
+    assert(get_search_kernels(get_simd_level() + 1) == NULL);
+    assert(set_simd_level(get_simd_level() + 1) == ERR_OUT_OF_BOUNDS);
+    printf("Passed!\n\n");
+}
+
+void test_search(void)
+{
+    printf("Testing vector search and reductions...\n");
+    vector_header h = init_vector(MIN_CAPACITY);
+    ptrdiff_t index, count;
+    int found;
+    long value;
+
+    // Test the empty vector
+    assert(vector_find(&h, 1, &index) == OK && index == -1);
+    assert(vector_sum(&h, &value) == OK && value == 0);
+    assert(vector_min(&h, &value) == ERR_OUT_OF_BOUNDS);
+    assert(vector_argmin(&h, &index) == ERR_OUT_OF_BOUNDS);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(push_back(&h, (i * 37) % 101 - 50) == OK);
+    }
+
+    assert(vector_find(&h, -50, &index) == OK && index == 0);
+    assert(vector_find(&h, 1000, &index) == OK && index == -1);
+    assert(vector_count(&h, 0, &count) == OK && count == 10);
+    assert(vector_contains(&h, 50, &found) == OK && found);
+    assert(vector_contains(&h, 51, &found) == OK && !found);
+    assert(vector_min(&h, &value) == OK && value == -50);
+    assert(vector_max(&h, &value) == OK && value == 50);
+
+    long expected = 0;
+    for (int i = 0; i < 1000; i++)
+    {
+        expected += get(&h, i);
+    }
+    assert(vector_sum(&h, &value) == OK && value == expected);
+
+    assert(set(&h, 700, -100) == OK);
+    assert(vector_argmin(&h, &index) == OK && index == 700);
+
+    // Test every level gives the same answers through the public API
+    simd_level level = get_simd_level();
+    assert(set_simd_level(SIMD_SCALAR) == OK);
+    assert(vector_argmin(&h, &index) == OK && index == 700);
+    assert(vector_count(&h, 0, &count) == OK && count == 10);
+    assert(set_simd_level(level) == OK);
+
+    assert(vector_find(NULL, 0, &index) == ERR_NULL);
+    assert(vector_sum(&h, NULL) == ERR_NULL);
+    free_vector(&h);
+    assert(vector_find(&h, 0, &index) == ERR_INVALID_HEADER);
+    printf("Passed!\n\n");
+}
+
+static int compare_longs(const void *a, const void *b)
+{
+    long x = *(const long *)a;
+    long y = *(const long *)b;
+
+    return (x > y) - (x < y);
+}
+
+void test_sorted_vector(void)
+{
+    printf("Testing sorted vector operations...\n");
+    vector_header h = init_vector(MIN_CAPACITY);
+    ptrdiff_t index, erased;
+    int found;
+
+    assert(sorted_lower_bound(&h, 5, &index) == OK && index == 0);
+    assert(sorted_contains(&h, 5, &found) == OK && !found);
+
+    // Test bounds against a linear scan for every key around the contents
+    for (int i = 0; i < 200; i++)
+    {
+        assert(sorted_insert(&h, rand() % 100) == OK);
+    }
+    for (int i = 1; i < h.size; i++)
+    {
+        assert(get(&h, i - 1) <= get(&h, i));
+    }
+    for (long key = -1; key <= 100; key++)
+    {
+        ptrdiff_t lower = 0, upper = 0;
+        while (lower < h.size && get(&h, lower) < key)
+        {
+            lower++;
+        }
+        while (upper < h.size && get(&h, upper) <= key)
+        {
+            upper++;
+        }
+
+        assert(sorted_lower_bound(&h, key, &index) == OK && index == lower);
+        assert(sorted_upper_bound(&h, key, &index) == OK && index == upper);
+        assert(sorted_contains(&h, key, &found) == OK && found == (lower != upper));
+    }
+
+    // Test erase by key removes every copy
+    assert(sorted_upper_bound(&h, 42, &index) == OK);
+    int copies = index;
+    assert(sorted_lower_bound(&h, 42, &index) == OK);
+    copies -= index;
+    assert(sorted_erase(&h, 42, &erased) == OK && erased == copies);
+    assert(sorted_contains(&h, 42, &found) == OK && !found);
+    assert(sorted_erase(&h, 42, NULL) == OK);
+
+    // Test a batch merges in order, interleaved with and around the contents
+    long batch[1000];
+    for (int i = 0; i < 1000; i++)
+    {
+        batch[i] = rand() % 300 - 100;
+    }
+    qsort(batch, 1000, sizeof(long), compare_longs);
+
+    int size = h.size;
+    long expected = 0;
+    for (int i = 0; i < h.size; i++)
+    {
+        expected += get(&h, i);
+    }
+    for (int i = 0; i < 1000; i++)
+    {
+        expected += batch[i];
+    }
+
+    assert(sorted_merge_insert(&h, batch, 1000) == OK);
+    assert(h.size == size + 1000);
+
+    long sum = get(&h, 0);
+    for (int i = 1; i < h.size; i++)
+    {
+        assert(get(&h, i - 1) <= get(&h, i));
+        sum += get(&h, i);
+    }
+    assert(sum == expected);
+
+    assert(sorted_merge_insert(&h, NULL, 0) == OK);
+    assert(sorted_merge_insert(&h, NULL, 1) == ERR_NULL);
+    assert(sorted_lower_bound(NULL, 0, &index) == ERR_NULL);
+    assert(sorted_lower_bound(&h, 0, NULL) == ERR_NULL);
+    free_vector(&h);
+    assert(sorted_insert(&h, 0) == ERR_INVALID_HEADER);
+    printf("Passed!\n\n");
+}
+
+static int compare_longs_descending(const void *left, const void *right)
+{
+    return compare_longs(right, left);
+}
+
+static int compare_floats(const void *left, const void *right)
+{
+    float first = *(const float *)left;
+    float second = *(const float *)right;
+
+    return (first > second) - (first < second);
+}
+
+static int compare_int32s(const void *left, const void *right)
+{
+    int32_t first = *(const int32_t *)left;
+    int32_t second = *(const int32_t *)right;
+
+    return (first > second) - (first < second);
+}
+
+// Random, few distinct, ascending, descending, extremes and a sawtooth
+static long sort_test_value(const int pattern, const long i)
+{
+    switch (pattern)
+    {
+    case 0:
+        return (long)(((unsigned long)rand() << 42) ^ ((unsigned long)rand() << 21) ^ (unsigned long)rand());
+    case 1:
+        return rand() % 16 - 8;
+    case 2:
+        return i;
+    case 3:
+        return -i;
+    case 4:
+        return i % 3 == 0 ? LONG_MIN : i % 3 == 1 ? LONG_MAX : 0;
+    default:
+        return i % 100;
+    }
+}
+
+void test_sort(void)
+{
+    printf("Testing sort...\n");
+    const ptrdiff_t sizes[] = {0, 1, 2, 100, RADIX_SORT_MIN_SIZE, 5000, RADIX_WIDE_DIGIT_SIZE + 3};
+    const ptrdiff_t parallel_size = PARALLEL_SORT_MIN_SIZE + 7;
+    long *expected = malloc(parallel_size * sizeof(long));
+    assert(expected != NULL);
+
+    // Test radix and comparison sorts against qsort(), with the radix scratch
+    // buffer both from spare capacity and from the heap
+    for (int i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++)
+    {
+        for (int pattern = 0; pattern < 6; pattern++)
+        {
+            vector_header h = init_vector(MIN_CAPACITY);
+            vector_header by = init_vector(MIN_CAPACITY);
+
+            for (long j = 0; j < sizes[i]; j++)
+            {
+                expected[j] = sort_test_value(pattern, j);
+                assert(push_back(&h, expected[j]) == OK && push_back(&by, expected[j]) == OK);
+            }
+            qsort(expected, sizes[i], sizeof(long), compare_longs);
+
+            assert(vector_sort(&h) == OK);
+            assert(vector_sort_by(&by, compare_longs) == OK);
+            assert(h.size == sizes[i]);
+            for (long j = 0; j < sizes[i]; j++)
+            {
+                assert(get(&h, j) == expected[j] && get(&by, j) == expected[j]);
+            }
+
+            free_vector(&h);
+            free_vector(&by);
+        }
+    }
+
+    // Test a custom order and a typed vector
+    vector_header h = init_vector(MIN_CAPACITY);
+    float_vector_header floats = float_vector_init(MIN_CAPACITY);
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(push_back(&h, rand() % 500) == OK);
+        assert(float_vector_push_back(&floats, (float)rand() / RAND_MAX - 0.5f) == OK);
+    }
+    assert(vector_sort_by(&h, compare_longs_descending) == OK);
+    assert(float_vector_sort_by(&floats, compare_floats) == OK);
+    for (int i = 1; i < 1000; i++)
+    {
+        assert(get(&h, i - 1) >= get(&h, i));
+        assert(floats.start_address[i - 1] <= floats.start_address[i]);
+    }
+    float_vector_free(&floats);
+
+    assert(vector_sort(NULL) == ERR_NULL);
+    assert(vector_sort_by(&h, NULL) == ERR_NULL);
+    assert(vector_sort_parallel(&h, 0) == ERR_OUT_OF_BOUNDS);
+    assert(vector_sort_parallel(&h, SORT_MAX_THREADS + 1) == ERR_OUT_OF_BOUNDS);
+    free_vector(&h);
+    assert(vector_sort(&h) == ERR_INVALID_HEADER);
+
+    // Test the parallel sort for a few thread counts
+    const int thread_counts[] = {2, 3, 8};
+    for (int i = 0; i < 3; i++)
+    {
+        h = init_vector(MIN_CAPACITY);
+        for (long j = 0; j < parallel_size; j++)
+        {
+            expected[j] = sort_test_value(i == 2 ? 1 : 0, j);
+            assert(push_back(&h, expected[j]) == OK);
+        }
+        qsort(expected, parallel_size, sizeof(long), compare_longs);
+
+        assert(vector_sort_parallel(&h, thread_counts[i]) == OK);
+        for (long j = 0; j < parallel_size; j++)
+        {
+            assert(get(&h, j) == expected[j]);
+        }
+        free_vector(&h);
+    }
+
+    // Test a snapshot keeps the order it saw, scratch space included
+    vector_cow cow = init_cow();
+    snapshot_header snapshot;
+    h = init_vector_with_allocator(MIN_CAPACITY, cow_allocator(&cow));
+    for (long i = 0; i < SNAPSHOT_TEST_SIZE; i++)
+    {
+        assert(push_back(&h, SNAPSHOT_TEST_SIZE - i) == OK);
+    }
+    assert(vector_snapshot(&h, &snapshot) == OK);
+    assert(vector_sort(&h) == OK);
+    for (long i = 0; i < SNAPSHOT_TEST_SIZE; i++)
+    {
+        assert(get(&h, i) == i + 1 && snapshot_get(&snapshot, i) == SNAPSHOT_TEST_SIZE - i);
+    }
+    assert(release_snapshot(&snapshot) == OK);
+    free_vector(&h);
+    assert(free_cow(&cow) == OK);
+
+    free(expected);
+    printf("Passed!\n\n");
+}
+
+void test_spans(void)
+{
+    printf("Testing spans and cursors...\n");
+    vector_header h = init_vector(MIN_CAPACITY);
+    vector_span spans[MAX_SPANS];
+    vector_cursor cursor;
+    vector_span span;
+    int count;
+    long value;
+
+    // Test an empty vector has no spans
+    assert(vector_get_spans(&h, spans, &count) == OK && count == 0);
+    assert(init_vector_cursor(&cursor, &h) == OK);
+    assert(!cursor_next(&cursor, &value));
+    assert(!cursor_next_span(&cursor, &span));
+
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(push_back(&h, i) == OK);
+    }
+
+    // Test the span is the buffer itself, not a copy
+    assert(vector_get_spans(&h, spans, &count) == OK && count == 1);
+    assert(spans[0].start_address == h.start_address && spans[0].length == 1000);
+
+    // Test element-wise walking, then handing off the rest as a span
+    assert(init_vector_cursor(&cursor, &h) == OK);
+    for (int i = 0; i < 10; i++)
+    {
+        assert(cursor_next(&cursor, &value) && value == i);
+    }
+    assert(cursor_next_span(&cursor, &span));
+    assert(span.start_address == h.start_address + 10 && span.length == 990);
+    assert(!cursor_next_span(&cursor, &span));
+    assert(!cursor_next(&cursor, &value));
+
+    assert(vector_get_spans(NULL, spans, &count) == ERR_NULL);
+    assert(init_vector_cursor(NULL, &h) == ERR_NULL);
+    free_vector(&h);
+    assert(vector_get_spans(&h, spans, &count) == ERR_INVALID_HEADER);
+    printf("Passed!\n\n");
+}
+
+// What a snapshot's reader thread sums, against what it should come to
+typedef struct
+{
+    const snapshot_header *snapshot;
+    long expected;
+} snapshot_test_reader;
+
+static void *sum_snapshot(void *argument)
+{
+    snapshot_test_reader *reader = argument;
+
+    for (int round = 0; round < 20; round++)
+    {
+        long sum = 0;
+        for (ptrdiff_t i = 0; i < reader->snapshot->size; i++)
+        {
+            sum += reader->snapshot->start_address[i];
+        }
+        assert(sum == reader->expected);
+    }
+
+    return NULL;
+}
+
+void test_snapshots(void)
+{
+    printf("Testing copy-on-write snapshots...\n");
+    vector_cow cow = init_cow();
+    vector_header h = init_vector_with_allocator(MIN_CAPACITY, cow_allocator(&cow));
+    const ptrdiff_t chunk = SNAPSHOT_CHUNK_SIZE / sizeof(long);
+    snapshot_header first, second, third, empty;
+
+    assert(cow.chunk_fd >= 0 && h.is_allocated);
+    for (long i = 0; i < SNAPSHOT_TEST_SIZE; i++)
+    {
+        assert(push_back(&h, i) == OK);
+    }
+
+    // Test taking a snapshot copies nothing
+    assert(vector_snapshot(&h, &first) == OK);
+    assert(first.size == SNAPSHOT_TEST_SIZE && cow.chunks_copied == 0);
+    assert(snapshot_get(&first, SNAPSHOT_TEST_SIZE - 1) == SNAPSHOT_TEST_SIZE - 1);
+
+    // Test a write copies out only the chunk it touches, and only once
+    assert(set(&h, 5, -1) == OK && set(&h, 6, -2) == OK);
+    assert(cow.chunks_copied == 1);
+    assert(first.start_address[5] == 5 && snapshot_get(&first, 6) == 6 && get(&h, 5) == -1);
+    assert(set(&h, 3 * chunk, -3) == OK && cow.chunks_copied == 2);
+
+    // Test a chunk both snapshots still see is copied once for the two of them
+    assert(vector_snapshot(&h, &second) == OK);
+    assert(set(&h, 5, -4) == OK && cow.chunks_copied == 3);
+    assert(first.start_address[5] == 5 && second.start_address[5] == -1 && get(&h, 5) == -4);
+    assert(set(&h, 7 * chunk, -5) == OK && cow.chunks_copied == 4);
+    assert(first.start_address[7 * chunk] == 7 * chunk && second.start_address[7 * chunk] == 7 * chunk);
+
+    // Test shifting, growing and shrinking the vector leaves both views as they were
+    assert(insert(&h, 0, -6) == OK);
+    assert(push_back_n(&h, 4 * SNAPSHOT_TEST_SIZE, 1) == OK);
+    assert(erase_range(&h, 0, h.size - 10) == OK && h.size == 10);
+    for (long i = 0; i < SNAPSHOT_TEST_SIZE; i++)
+    {
+        long changed = i == 5 ? -1 : i == 6 ? -2 : i == 3 * chunk ? -3 : i;
+        assert(first.start_address[i] == i && second.start_address[i] == changed);
+    }
+
+    // Test a reader thread sees a stable snapshot while the writer keeps going
+    pthread_t thread;
+    snapshot_test_reader reader = {&first, (long)SNAPSHOT_TEST_SIZE * (SNAPSHOT_TEST_SIZE - 1) / 2};
+    assert(pthread_create(&thread, NULL, sum_snapshot, &reader) == 0);
+    for (long i = 0; i < SNAPSHOT_TEST_SIZE; i++)
+    {
+        assert(push_back(&h, -i) == OK);
+    }
+    assert(pthread_join(thread, NULL) == 0);
+
+    // Test snapshots outlive the vector, and the allocator waits for both
+    assert(vector_snapshot(&h, &third) == OK && third.size == h.size);
+    assert(free_vector(&h) == OK);
+    assert(free_cow(&cow) == ERR_INVALID_HEADER);
+    assert(snapshot_get(&third, 0) == 1 && snapshot_get(&third, 11) == -1);
+    assert(first.start_address[SNAPSHOT_TEST_SIZE - 1] == SNAPSHOT_TEST_SIZE - 1);
+    assert(release_snapshot(&first) == OK && release_snapshot(&first) == ERR_INVALID_HEADER);
+    assert(release_snapshot(&second) == OK && release_snapshot(&third) == OK);
+
+    // Test an empty vector and one from another allocator
+    h = init_vector_with_allocator(MIN_CAPACITY, cow_allocator(&cow));
+    assert(vector_snapshot(&h, &empty) == OK && empty.size == 0);
+    assert(snapshot_get(&empty, 0) == ERR_OUT_OF_BOUNDS);
+    assert(push_back(&h, TEST_VALUE) == OK && empty.size == 0);
+    assert(release_snapshot(&empty) == OK);
+    free_vector(&h);
+    // every copied chunk went back once its last snapshot did
+    assert(cow.chunk_slots > 0 && cow.free_count == cow.chunk_slots);
+    assert(free_cow(&cow) == OK);
+
+    h = init_vector(MIN_CAPACITY);
+    assert(vector_snapshot(&h, &empty) == ERR_INVALID_HEADER);
+    assert(vector_snapshot(NULL, &empty) == ERR_NULL && release_snapshot(NULL) == ERR_NULL);
+    free_vector(&h);
+    printf("Passed!\n\n");
+}
+
+void test_vector_stats(void)
+{
+    printf("Testing vector stats...\n");
+    vector_header h = init_vector(MIN_CAPACITY);
+    vector_stats stats = {0};
+    char output[4096] = {0};
+
+    assert(vector_attach_stats(&h, &stats) == OK);
+    assert(register_vector_stats(&stats, "test_vector") == OK);
+
+    for (int i = 0; i < 100; i++)
+    {
+        assert(push_back(&h, i) == OK);
+    }
+    assert(insert(&h, 0, -1) == OK);
+    assert(erase_range(&h, 0, 90) == OK);
+
+#ifdef VECTOR_STATS
+    // Test growth 32 -> 64 -> 128, one shift of 100 elements, then a shrink
+    assert(stats.grows == 2 && stats.peak_capacity == 128);
+    assert(stats.bytes_shifted == (100 + 11) * sizeof(long));
+    assert(stats.shrinks == 1 && stats.allocator_calls == 3);
+#else
+    // Test the counters are compiled out
+    assert(stats.grows == 0 && stats.bytes_shifted == 0 && stats.allocator_calls == 0);
+#endif
+
+    // Test both dump formats list the registered vector
+    FILE *stream = tmpfile();
+    assert(stream != NULL);
+    assert(dump_vector_stats(stream, STATS_TEXT) == OK);
+    assert(dump_vector_stats(stream, STATS_JSON) == OK);
+    rewind(stream);
+    assert(fread(output, 1, sizeof(output) - 1, stream) > 0);
+    fclose(stream);
+    assert(strstr(output, "test_vector: grows=") != NULL);
+    assert(strstr(output, "[{\"name\":\"test_vector\",\"grows\":") != NULL);
+
+    assert(reset_vector_stats(&stats) == OK);
+    assert(stats.grows == 0 && strcmp(stats.name, "test_vector") == 0);
+
+    assert(unregister_vector_stats(&stats) == OK);
+    assert(unregister_vector_stats(&stats) == ERR_OUT_OF_BOUNDS);
+    assert(dump_vector_stats(NULL, STATS_TEXT) == ERR_NULL);
+    assert(vector_attach_stats(NULL, &stats) == ERR_NULL);
+    free_vector(&h);
+    assert(vector_attach_stats(&h, &stats) == ERR_INVALID_HEADER);
+    printf("Passed!\n\n");
+}
+
+void test_size_overflow(void)
+{
+    printf("Testing size overflow...\n");
+    vector_header h = init_vector(MAX_CAPACITY + 1);
+    long value = TEST_VALUE;
+
+    // Test capacities past MAX_CAPACITY are refused up front
+    assert(!h.is_allocated);
+    h = init_vector(MAX_CAPACITY);
+    assert(!h.is_allocated);
+
+    // Test counts whose byte size would overflow fail before any allocation
+    h = init_vector(MIN_CAPACITY);
+    assert(push_back(&h, 1) == OK);
+    assert(insert_range(&h, 0, &value, MAX_CAPACITY) == ERR_INVALID_CAPACITY);
+    assert(push_back_n(&h, PTRDIFF_MAX, 0) == ERR_INVALID_CAPACITY);
+    assert(append_array(&h, &value, MAX_CAPACITY) == ERR_INVALID_CAPACITY);
+    assert(h.size == 1 && h.capacity == MIN_CAPACITY && get(&h, 0) == 1);
+    free_vector(&h);
+
+    deamortized_vector_header dh = init_deamortized_vector(MAX_CAPACITY + 1);
+    assert(!dh.current_vector.is_allocated);
+    dh = init_deamortized_vector(MIN_CAPACITY);
+    assert(deamortized_push_back_n(&dh, PTRDIFF_MAX, 0) == ERR_INVALID_CAPACITY);
+    assert(deamortized_insert_range(&dh, 0, &value, MAX_CAPACITY) == ERR_INVALID_CAPACITY);
+    assert(get_size(&dh) == 0);
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_sparse_large_vector(void)
+{
+    printf("Testing a vector past INT_MAX elements...\n");
+    vector_header h = init_vector_with_allocator(SPARSE_TEST_CAPACITY, &sparse_allocator);
+    const ptrdiff_t last = SPARSE_TEST_CAPACITY - 1;
+    ptrdiff_t index;
+    int narrow;
+
+    assert(h.is_allocated && h.capacity == SPARSE_TEST_CAPACITY);
+
+    // Test a vector declared full, whose untouched pages read as zeros
+    h.size = SPARSE_TEST_CAPACITY;
+    assert(get(&h, last) == 0);
+    assert(set(&h, last, TEST_VALUE) == OK && get(&h, last) == TEST_VALUE);
+    assert(set(&h, (ptrdiff_t)INT_MAX + 1, 7) == OK && get(&h, (ptrdiff_t)INT_MAX + 1) == 7);
+    assert(get(&h, SPARSE_TEST_CAPACITY) == ERR_OUT_OF_BOUNDS && set(&h, SPARSE_TEST_CAPACITY, 1) == ERR_OUT_OF_BOUNDS);
+
+    // Test growing past 2^31 elements doubles without overflowing
+    assert(push_back(&h, 9) == OK);
+    assert(h.size == SPARSE_TEST_CAPACITY + 1 && h.capacity == 2 * SPARSE_TEST_CAPACITY);
+    assert(get(&h, last) == TEST_VALUE && get(&h, last + 1) == 9);
+
+    // Test shifting near the end, at indices an int can't hold
+    assert(insert(&h, last, -1) == OK);
+    assert(get(&h, last) == -1 && get(&h, last + 1) == TEST_VALUE && get(&h, last + 2) == 9);
+    assert(erase(&h, last) == OK && get(&h, last) == TEST_VALUE);
+    assert(pop_back(&h) == OK && h.size == SPARSE_TEST_CAPACITY);
+
+    // Test search and the compat shim over the tail only
+    vector_header tail = h;
+    tail.start_address += last - 16;
+    tail.size = 17;
+    assert(vector_find(&tail, TEST_VALUE, &index) == OK && index == 16);
+    assert(vector_get_size_int(&h, &narrow) == ERR_INVALID_CAPACITY);
+    assert(vector_get_size_int(&tail, &narrow) == OK && narrow == 17);
+
+    free_vector(&h);
+
+    // Test a deamortized vector the same way, declared half full so migration
+    // into the second sparse buffer starts from the front and stays small
+    deamortized_vector_header dh = init_deamortized_vector_with_allocator(2 * SPARSE_TEST_CAPACITY, &sparse_allocator);
+    assert(dh.current_vector.is_allocated);
+    dh.current_vector.size = SPARSE_TEST_CAPACITY;
+    assert(deamortized_set(&dh, last, TEST_VALUE) == OK);
+    for (int i = 0; i < 4; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+    }
+    assert(dh.next_vector.is_allocated && deamortized_pending_migration(&dh) > INT_MAX);
+    assert(get_size(&dh) == SPARSE_TEST_CAPACITY + 4);
+    assert(deamortized_get(&dh, last) == TEST_VALUE && deamortized_get(&dh, last + 4) == 3);
+    assert(deamortized_get_size_int(&dh, &narrow) == ERR_INVALID_CAPACITY);
+    assert(deamortized_pop_back(&dh) == OK && get_size(&dh) == SPARSE_TEST_CAPACITY + 3);
+    free_deamortized_vector(&dh);
+
+    // Test a typed vector indexes and grows past INT_MAX the same way
+    int32_vector_header ih = int32_vector_init_with_allocator(SPARSE_TEST_CAPACITY, &sparse_allocator);
+    int32_t value;
+    assert(ih.is_allocated && ih.capacity == SPARSE_TEST_CAPACITY);
+    ih.size = SPARSE_TEST_CAPACITY;
+    assert(int32_vector_set(&ih, last, 5) == OK);
+    assert(int32_vector_push_back(&ih, 9) == OK && ih.capacity == 2 * SPARSE_TEST_CAPACITY);
+    assert(int32_vector_insert(&ih, last, -1) == OK);
+    assert(int32_vector_get(&ih, last + 1, &value) == OK && value == 5);
+    assert(int32_vector_get(&ih, last + 2, &value) == OK && value == 9);
+    int32_vector_free(&ih);
+    printf("Passed!\n\n");
+}
+
+void test_compat_shim(void)
+{
+    printf("Testing int compatibility shim...\n");
+    vector_header h = init_vector(MIN_CAPACITY);
+    deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
+    int index, count, size;
+
+    for (int i = 0; i < 10; i++)
+    {
+        assert(push_back(&h, i / 2) == OK);
+        assert(deamortized_push_back(&dh, 9 - i) == OK);
+    }
+
+    assert(vector_get_size_int(&h, &size) == OK && size == 10);
+    assert(deamortized_get_size_int(&dh, &size) == OK && size == 10);
+    assert(vector_find_int(&h, 3, &index) == OK && index == 6);
+    assert(vector_find_int(&h, 99, &index) == OK && index == -1);
+    assert(vector_count_int(&h, 4, &count) == OK && count == 2);
+    assert(vector_argmin_int(&h, &index) == OK && index == 0);
+    assert(deamortized_find_int(&dh, 7, &index) == OK && index == 2);
+    assert(deamortized_count_int(&dh, 7, &count) == OK && count == 1);
+    assert(deamortized_argmin_int(&dh, &index) == OK && index == 9);
+    assert(sorted_lower_bound_int(&h, 2, &index) == OK && index == 4);
+    assert(sorted_upper_bound_int(&h, 2, &index) == OK && index == 6);
+    assert(sorted_erase_int(&h, 2, &count) == OK && count == 2 && h.size == 8);
+    assert(sorted_erase_int(&h, 0, NULL) == OK && h.size == 6);
+
+    assert(vector_find_int(&h, 0, NULL) == ERR_NULL);
+    assert(vector_get_size_int(NULL, &size) == ERR_NULL);
+    free_vector(&h);
+    assert(vector_get_size_int(&h, &size) == ERR_INVALID_HEADER);
+    assert(vector_count_int(&h, 0, &count) == ERR_INVALID_HEADER);
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_stress(void)
+{
+    printf("Testing stress...\n");
+    vector_header h = init_vector(MIN_CAPACITY);
+
+    // Stress test push_back
+    for (int i = 0; i < STRESS_TEST_SIZE; i++)
+    {
+        assert(push_back(&h, i) == OK);
+    }
+    assert(h.size == STRESS_TEST_SIZE);
+
+    // Stress test get
+    for (int i = 0; i < STRESS_TEST_SIZE; i++)
+    {
+        assert(get(&h, i) == i);
+    }
+
+    // Stress test pop_back
+    for (int i = 0; i < STRESS_TEST_SIZE; i++)
+    {
+        assert(pop_back(&h) == OK);
+    }
+    assert(h.size == 0);
+
+    free_vector(&h);
+    printf("Passed!\n\n");
+}
+
+void test_deamortized_vector_basic(void)
+{
+    printf("Testing deamortized vector...\n");
+
+    // Test initialization
+    deamortized_vector_header dh = init_deamortized_vector(TEST_CAPACITY);
+    assert(dh.current_vector.capacity == TEST_CAPACITY);
+    assert(dh.current_vector.size == 0);
+    assert(dh.current_vector.is_allocated);
+    // next_vector is only allocated once migration begins
+    assert(!dh.next_vector.is_allocated);
+    assert(dh.reallocated_amount == 0);
+
+    // Test push_back
+    for (int i = 0; i < 5; i++)
+    {
+        assert(deamortized_push_back(&dh, i * 10) == OK);
+        assert(dh.current_vector.size == i + 1);
+    }
+
+    // Test get
+    for (int i = 0; i < 5; i++)
+    {
+        assert(deamortized_get(&dh, i) == i * 10);
+    }
+
+    // Test set
+    assert(deamortized_set(&dh, 2, TEST_VALUE) == OK);
+    assert(deamortized_get(&dh, 2) == TEST_VALUE);
+
+    // Test insert
+    assert(deamortized_insert(&dh, 2, 100) == OK);
+    assert(deamortized_get(&dh, 2) == 100);
+    assert(deamortized_get(&dh, 3) == TEST_VALUE);
+
+    // Test erase
+    assert(deamortized_erase(&dh, 2) == OK);
+    assert(deamortized_get(&dh, 2) == TEST_VALUE);
+
+    // Test pop_back
+    assert(deamortized_pop_back(&dh) == OK);
+    assert(dh.current_vector.size == 4);
+
+    // Test invalid operations
+    assert(deamortized_insert(&dh, 10, 10) == ERR_OUT_OF_BOUNDS);
+    assert(deamortized_erase(&dh, 10) == ERR_OUT_OF_BOUNDS);
+    assert(deamortized_pop_back(&dh) == OK);
+    assert(deamortized_pop_back(&dh) == OK);
+    assert(deamortized_pop_back(&dh) == OK);
+    assert(deamortized_pop_back(&dh) == OK);
+    assert(deamortized_pop_back(&dh) == ERR_OUT_OF_BOUNDS);
+
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void fuzz_vector_operations(void)
+{
+    printf("Fuzz testing vector operations...\n");
+    srand((unsigned int)time(NULL));
+
+    for (int i = 0; i < 1000; i++)
+    {
+        vector_header h = init_vector(MIN_CAPACITY);
+        int operations = rand() % 100;
+
+        for (int j = 0; j < operations; j++)
+        {
+            int op = rand() % 5;
+            int index = rand() % (h.size + 1);
+            int value = rand();
+
+            switch (op)
+            {
+            case 0: // push_back
+                push_back(&h, value);
+                break;
+            case 1: // insert
+                insert(&h, index, value);
+                break;
+            case 2: // set
+                if (h.size > 0)
+                    set(&h, index % h.size, value);
+                break;
+            case 3: // get
+                if (h.size > 0)
+                    get(&h, index % h.size);
+                break;
+            case 4: // erase
+                if (h.size > 0)
+                    erase(&h, index % h.size);
+                break;
+            }
+        }
+
+        free_vector(&h);
+    }
+
+    printf("Fuzz testing passed!\n\n");
+}
+
+void vector_tests(void)
+{
+    test_initialization();
+    test_basic_operations();
+    test_insert_delete();
+    test_capacity_management();
+    test_edge_cases();
+    test_range_operations();
+    test_shrinking();
+    test_reserve_resize();
+    test_batch_edits();
+    test_typed_vectors();
+    test_arena_allocator();
+    test_mmap_allocator();
+    test_vector_file();
+    test_search_kernels();
+    test_search();
+    test_sorted_vector();
+    test_sort();
+    test_spans();
+    test_snapshots();
+    test_vector_stats();
+    test_size_overflow();
+    test_sparse_large_vector();
+    test_compat_shim();
+    test_stress();
+    fuzz_vector_operations();
+    printf("All vector tests passed!\n");
+}
+
+void test_deamortized_reallocation_process(void)
+{
+    printf("Testing deamortized reallocation process...\n");
+
+    // Initialize with small capacity to observe reallocations
+    deamortized_vector_header dh = init_deamortized_vector(4);
+
+    // MIN_CAPACITY thing
+    assert(dh.current_vector.capacity == 32);
+    assert(!dh.next_vector.is_allocated);
+
+    // Fill current vector
+    for (int i = 0; i < 4; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+        assert(dh.reallocated_amount == 0); // No reallocation yet
+    }
+
+    // Trigger reallocation process
+    assert(deamortized_push_back(&dh, 4) == OK);
+
+    // not the time to reallocate
+    assert(dh.reallocated_amount == 0);
+
+    // Verify elements exist in both vectors during migration
+    for (int i = 0; i <= dh.reallocated_amount; i++)
+    {
+        assert(deamortized_get(&dh, i) == i);
+    }
+
+    // Complete reallocation
+    while (dh.reallocated_amount < dh.current_vector.size)
+    {
+        int prev_realloc = dh.reallocated_amount;
+        assert(deamortized_push_back(&dh, dh.current_vector.size) == OK);
+        assert(dh.reallocated_amount >= prev_realloc);
+    }
+
+    // Verify final state after full reallocation
+    assert(dh.current_vector.capacity == 32);
+    assert(dh.next_vector.capacity == 64);
+
+    // Verify all elements
+    for (int i = 0; i < 8; i++)
+    {
+        assert(deamortized_get(&dh, i) == i);
+    }
+
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_deamortized_complex_operations(void)
+{
+    printf("Testing complex deamortized operations...\n");
+    deamortized_vector_header dh = init_deamortized_vector(8);
+
+    // Fill initial vector
+    for (int i = 0; i < 10; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+    }
+
+    // Interleave insertions during reallocation
+    assert(deamortized_insert(&dh, 5, 100) == OK);
+    assert(deamortized_get(&dh, 5) == 100);
+    assert(deamortized_get(&dh, 6) == 5); // Subsequent elements shifted
+
+    // Modify elements during reallocation
+    for (int i = 0; i < 5; i++)
+    {
+        assert(deamortized_set(&dh, i, i * 2) == OK);
+    }
+
+    // Verify mixed access
+    for (int i = 0; i < 5; i++)
+    {
+        assert(deamortized_get(&dh, i) == i * 2);
+    }
+    for (int i = 5; i < get_size(&dh); i++)
+    {
+        assert(deamortized_get(&dh, i) == (i < 6 ? 100 : i - 1));
+    }
+
+    // Force multiple reallocations
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+    }
+    assert(get_size(&dh) == 1011);
+
+    // Verify capacity growth pattern
+    assert(dh.current_vector.capacity >= 1024);
+
+    // Test front/middle/back deletions during reallocation
+    assert(deamortized_erase(&dh, 0) == OK);
+    assert(deamortized_erase(&dh, 500) == OK);
+    assert(deamortized_erase(&dh, get_size(&dh) - 1) == OK);
+
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_deamortized_edge_cases(void)
+{
+    printf("Testing deamortized edge cases...\n");
+
+    // Test empty vector operations
+    deamortized_vector_header dh = init_deamortized_vector(4);
+    assert(deamortized_pop_back(&dh) == ERR_OUT_OF_BOUNDS);
+    assert(deamortized_erase(&dh, 0) == ERR_OUT_OF_BOUNDS);
+
+    // Test partial reallocation access
+    for (int i = 0; i < 5; i++)
+    {
+        deamortized_push_back(&dh, i);
+    }
+    assert(deamortized_get(&dh, 4) == 4);
+    assert(deamortized_get(&dh, 5) == ERR_OUT_OF_BOUNDS);
 
     // Test invalid header operations
     deamortized_vector_header invalid = {0};
     assert(deamortized_push_back(&invalid, 5) == ERR_INVALID_HEADER);
     assert(free_deamortized_vector(&invalid) == ERR_INVALID_HEADER);
 
-    // Test null pointer handling
-    assert(deamortized_push_back(NULL, 5) == ERR_NULL);
-    assert(deamortized_get(NULL, 0) == ERR_NULL);
+    // Test null pointer handling
+    assert(deamortized_push_back(NULL, 5) == ERR_NULL);
+    assert(deamortized_get(NULL, 0) == ERR_NULL);
+
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_deamortized_capacity_management(void)
+{
+    printf("Testing deamortized capacity management...\n");
+    deamortized_vector_header dh = init_deamortized_vector(2);
+
+    // Verify initial capacity progression
+    assert(dh.current_vector.capacity == 32);
+    assert(!dh.next_vector.is_allocated);
+
+    // Migration doesn't begin below half capacity
+    deamortized_push_back(&dh, 1);
+    deamortized_push_back(&dh, 2);
+    deamortized_push_back(&dh, 3);
+    assert(!dh.next_vector.is_allocated);
+
+    // Complete reallocation
+    while (dh.reallocated_amount > 0)
+    {
+        deamortized_push_back(&dh, dh.current_vector.size);
+    }
+    assert(dh.current_vector.capacity == 32);
+    assert(!dh.next_vector.is_allocated);
+
+    // next_vector appears once migration begins
+    while (get_size(&dh) < 16)
+    {
+        deamortized_push_back(&dh, dh.current_vector.size);
+    }
+    assert(dh.next_vector.capacity == 64);
+    assert(dh.reallocated_amount > 0);
+
+    // Verify size/capacity ratio after multiple reallocations
+    for (int i = 0; i < 100; i++)
+    {
+        deamortized_push_back(&dh, i);
+    }
+    assert(dh.current_vector.capacity == 128);
+    assert(dh.next_vector.capacity == 256);
+
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_deamortized_range_operations(void)
+{
+    printf("Testing deamortized range operations...\n");
+    deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
+    long values[100];
+
+    for (int i = 0; i < 100; i++)
+    {
+        values[i] = i;
+    }
+
+    // Test append_array past next_vector's capacity
+    assert(deamortized_append_array(&dh, values, 100) == OK);
+    assert(get_size(&dh) == 100);
+    for (int i = 0; i < 100; i++)
+    {
+        assert(deamortized_get(&dh, i) == i);
+    }
+
+    // Test insert_range and erase_range
+    assert(deamortized_insert_range(&dh, 1, values, 3) == OK);
+    assert(deamortized_get(&dh, 0) == 0);
+    assert(deamortized_get(&dh, 1) == 0 && deamortized_get(&dh, 3) == 2);
+    assert(deamortized_get(&dh, 4) == 1);
+    assert(deamortized_erase_range(&dh, 1, 3) == OK);
+    for (int i = 0; i < 100; i++)
+    {
+        assert(deamortized_get(&dh, i) == i);
+    }
+
+    // Test push_back_n
+    assert(deamortized_push_back_n(&dh, 5, TEST_VALUE) == OK);
+    assert(get_size(&dh) == 105);
+    assert(deamortized_get(&dh, 104) == TEST_VALUE);
+
+    // Test assign
+    assert(deamortized_assign(&dh, values, 3) == OK);
+    assert(get_size(&dh) == 3);
+    assert(dh.reallocated_amount == 0);
+    assert(deamortized_get(&dh, 2) == 2);
+
+    // Test the vector's own elements as input, with growth swapping buffers
+    // and migration under way
+    for (int i = 0; i < 6; i++)
+    {
+        assert(deamortized_append_array(&dh, dh.current_vector.start_address, get_size(&dh)) == OK);
+    }
+    assert(get_size(&dh) == 3 << 6);
+    for (int i = 0; i < 3 << 6; i++)
+    {
+        assert(deamortized_get(&dh, i) == i % 3);
+    }
+    assert(deamortized_insert_range(&dh, 1, dh.current_vector.start_address, 4) == OK);
+    assert(deamortized_get(&dh, 0) == 0 && deamortized_get(&dh, 1) == 0 && deamortized_get(&dh, 4) == 0);
+    assert(deamortized_get(&dh, 5) == 1);
+    assert(deamortized_assign(&dh, dh.current_vector.start_address + 5, 3) == OK);
+    assert(deamortized_get(&dh, 0) == 1 && deamortized_get(&dh, 2) == 0);
+    assert(deamortized_assign(&dh, values, 3) == OK);
+
+    // Test invalid ranges
+    assert(deamortized_erase_range(&dh, 2, 2) == ERR_OUT_OF_BOUNDS);
+    assert(deamortized_insert_range(&dh, 4, values, 1) == ERR_OUT_OF_BOUNDS);
+    assert(deamortized_insert_range(NULL, 0, values, 1) == ERR_NULL);
+
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void fuzz_deamortized_against_reference(void)
+{
+    printf("Fuzz testing deamortized vector against reference...\n");
+
+    for (int i = 0; i < 200; i++)
+    {
+        deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
+        vector_header reference = init_vector(MIN_CAPACITY);
+        long values[16];
+
+        assert(deamortized_set_migration_rate(&dh, MIN_MIGRATION_RATE + i % 8) == OK);
+        assert(deamortized_set_deferred_migration(&dh, i % 5 == 0) == OK);
+
+        for (int j = 0; j < 500; j++)
+        {
+            // grow first, then drain to exercise shrinking
+            int op = j < 300 ? rand() % 10 : (int[]){1, 2, 2, 4, 4, 6, 9}[rand() % 7];
+            int index = rand() % (reference.size + 1);
+            int count = rand() % 16;
+
+            for (int k = 0; k < count; k++)
+            {
+                values[k] = rand();
+            }
+
+            switch (op)
+            {
+            case 0: // push_back
+                assert(deamortized_push_back(&dh, values[0]) == push_back(&reference, values[0]));
+                break;
+            case 1: // insert
+                assert(deamortized_insert(&dh, index, values[0]) == insert(&reference, index, values[0]));
+                break;
+            case 2: // erase
+                if (reference.size > 0)
+                    assert(deamortized_erase(&dh, index % reference.size) == erase(&reference, index % reference.size));
+                break;
+            case 3: // insert_range
+                assert(deamortized_insert_range(&dh, index, values, count) == insert_range(&reference, index, values, count));
+                break;
+            case 4: // erase_range
+                count = count > reference.size - index ? reference.size - index : count;
+                assert(deamortized_erase_range(&dh, index, count) == erase_range(&reference, index, count));
+                break;
+            case 5: // push_back_n
+                assert(deamortized_push_back_n(&dh, count, values[0]) == push_back_n(&reference, count, values[0]));
+                break;
+            case 6: // set
+                if (reference.size > 0)
+                    assert(deamortized_set(&dh, index % reference.size, values[0]) == set(&reference, index % reference.size, values[0]));
+                break;
+            case 7: // reserve
+                assert(deamortized_reserve(&dh, reference.size + rand() % 2000) == OK);
+                break;
+            case 8: // resize
+                assert(deamortized_resize(&dh, index + count, values[0]) == resize(&reference, index + count, values[0]));
+                break;
+            case 9: // shrink_to_fit
+                assert(deamortized_shrink_to_fit(&dh) == shrink_to_fit(&reference));
+                break;
+            }
+
+            if (dh.deferred_migration && j % 3 == 0)
+            {
+                assert(deamortized_make_progress(&dh, rand() % 8) == OK);
+            }
+
+            assert(get_size(&dh) == reference.size);
+            assert(dh.reallocated_amount <= get_size(&dh));
+            assert(get_size(&dh) < dh.current_vector.capacity);
+            assert(get_size(&dh) <= dh.next_vector.capacity || get_size(&dh) <= dh.current_vector.capacity / 2);
+            assert(dh.reallocated_amount == 0 || dh.next_vector.is_allocated);
+        }
+
+        for (int j = 0; j < reference.size; j++)
+        {
+            assert(deamortized_get(&dh, j) == get(&reference, j));
+        }
+        for (int j = 0; j < dh.reallocated_amount; j++)
+        {
+            assert(get(&dh.next_vector, j) == get(&reference, j));
+        }
+
+        free_vector(&reference);
+        free_deamortized_vector(&dh);
+    }
+
+    printf("Fuzz testing passed!\n\n");
+}
+
+void fuzz_deamortized_batch_against_reference(void)
+{
+    printf("Fuzz testing deamortized batches against reference...\n");
+    vector_edit edits[64];
+    long values[64];
+
+    for (int i = 0; i < 200; i++)
+    {
+        deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
+        vector_header reference = init_vector(MIN_CAPACITY);
+
+        assert(deamortized_set_deferred_migration(&dh, i % 5 == 0) == OK);
+
+        for (int j = 0; j < 200; j++)
+        {
+            // grow first, then drain to exercise shrinking mid-migration
+            int count = rand() % 64;
+            int op = rand() % 3;
+
+            if (op == 0 && j < 120)
+            {
+                for (int k = 0; k < count; k++)
+                {
+                    values[k] = rand();
+                }
+                assert(deamortized_append_array(&dh, values, count) == append_array(&reference, values, count));
+            }
+            else if (op == 0)
+            {
+                count = count > reference.size ? reference.size : count;
+                assert(deamortized_erase_range(&dh, 0, count) == erase_range(&reference, 0, count));
+            }
+            else
+            {
+                random_edits(edits, count, reference.size);
+                apply_edits_one_by_one(&reference, edits, count);
+                assert(deamortized_apply_batch(&dh, edits, count) == OK);
+
+                // Test the batch itself caught the rewound migration up far
+                // enough that following operations stay at the usual rate
+                if (dh.next_vector.is_allocated && !dh.deferred_migration)
+                {
+                    ptrdiff_t target = dh.next_vector.capacity < dh.current_vector.capacity ? dh.next_vector.capacity : dh.current_vector.capacity;
+                    assert(get_size(&dh) - dh.reallocated_amount <= target - get_size(&dh) ||
+                           get_size(&dh) < dh.current_vector.capacity / 2);
+                }
+            }
+
+            if (dh.deferred_migration && j % 3 == 0)
+            {
+                assert(deamortized_make_progress(&dh, rand() % 64) == OK);
+            }
+
+            assert(get_size(&dh) == reference.size);
+            assert(dh.reallocated_amount <= get_size(&dh));
+            assert(get_size(&dh) < dh.current_vector.capacity);
+            assert(get_size(&dh) <= dh.next_vector.capacity || get_size(&dh) <= dh.current_vector.capacity / 2);
+            for (int k = 0; k < dh.reallocated_amount; k++)
+            {
+                assert(get(&dh.next_vector, k) == get(&reference, k));
+            }
+        }
+
+        for (int j = 0; j < reference.size; j++)
+        {
+            assert(deamortized_get(&dh, j) == get(&reference, j));
+        }
+
+        // Test an out of bounds batch changes nothing
+        edits[0] = (vector_edit){EDIT_INSERT, reference.size + 1, 0};
+        assert(deamortized_apply_batch(&dh, edits, 1) == ERR_OUT_OF_BOUNDS);
+        assert(get_size(&dh) == reference.size);
+
+        free_vector(&reference);
+        free_deamortized_vector(&dh);
+    }
+
+    printf("Fuzz testing passed!\n\n");
+}
+
+void test_deamortized_shrinking(void)
+{
+    printf("Testing deamortized shrinking...\n");
+    deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+    }
+    int peak_capacity = dh.current_vector.capacity;
+
+    // Test pop_back migrates down a few elements at a time
+    while (get_size(&dh) > 10)
+    {
+        assert(deamortized_pop_back(&dh) == OK);
+        assert(dh.reallocated_amount <= get_size(&dh));
+        assert(dh.next_vector.capacity <= 2 * dh.current_vector.capacity);
+    }
+    assert(dh.current_vector.capacity < peak_capacity / 8);
+
+    for (int i = 0; i < 10; i++)
+    {
+        assert(deamortized_get(&dh, i) == i);
+    }
+
+    // Test erase in the middle of a shrink
+    assert(deamortized_insert_range(&dh, 10, (long[]){10, 11, 12}, 3) == OK);
+    assert(deamortized_erase(&dh, 0) == OK);
+    assert(deamortized_get(&dh, 0) == 1 && deamortized_get(&dh, 11) == 12);
+
+    // Test growing back after shrinking
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+    }
+    assert(get_size(&dh) == 1012);
+    assert(deamortized_get(&dh, 11) == 12 && deamortized_get(&dh, 1011) == 999);
+
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_deamortized_reserve_resize(void)
+{
+    printf("Testing deamortized reserve and resize...\n");
+    deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
+
+    // Test a small vector moves straight into a buffer it fills at most half
+    for (int i = 0; i < 100; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+    }
+    assert(deamortized_reserve(&dh, 10000) == OK);
+    assert(dh.current_vector.capacity >= 20000 && !dh.next_vector.is_allocated);
+    ptrdiff_t capacity = dh.current_vector.capacity;
+
+    // Test filling up to the reservation never migrates
+    for (int i = 100; i < 10000; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+        assert(!dh.next_vector.is_allocated);
+    }
+    assert(dh.current_vector.capacity == capacity);
+
+    // Test a larger vector migrates into the reservation as it goes
+    assert(deamortized_reserve(&dh, 100000) == OK);
+    assert(dh.reserving && dh.next_vector.capacity >= 200000);
+    assert(deamortized_pending_migration(&dh) == 10000);
+    capacity = dh.next_vector.capacity;
+
+    int operations = 0;
+    for (int i = 10000; dh.reserving; i++, operations++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+    }
+    // each push_back adds one element to migrate and migrates DEFAULT_MIGRATION_RATE
+    assert(operations <= 10000 / (DEFAULT_MIGRATION_RATE - 1));
+    assert(dh.current_vector.capacity == capacity && !dh.next_vector.is_allocated);
+    for (int i = get_size(&dh); i < 100000; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+        assert(!dh.next_vector.is_allocated);
+    }
+    for (int i = 0; i < 100000; i++)
+    {
+        assert(deamortized_get(&dh, i) == i);
+    }
+
+    // Test resize, then a migrating shrink_to_fit that make_progress completes
+    assert(deamortized_resize(&dh, 100010, TEST_VALUE) == OK);
+    assert(get_size(&dh) == 100010 && deamortized_get(&dh, 100009) == TEST_VALUE);
+    assert(deamortized_resize(&dh, 6000, 0) == OK);
+    assert(get_size(&dh) == 6000 && deamortized_get(&dh, 5999) == 5999);
+    assert(deamortized_shrink_to_fit(&dh) == OK);
+    assert(dh.next_vector.is_allocated && dh.next_vector.capacity == 16384);
+    assert(deamortized_make_progress(&dh, deamortized_pending_migration(&dh)) == OK);
+    assert(dh.current_vector.capacity == 16384 && !dh.next_vector.is_allocated);
+
+    // Test a small vector shrinks to fit directly
+    assert(deamortized_resize(&dh, 100, 0) == OK);
+    assert(deamortized_shrink_to_fit(&dh) == OK);
+    assert(dh.current_vector.capacity == 256 && !dh.next_vector.is_allocated);
+    for (int i = 0; i < 100; i++)
+    {
+        assert(deamortized_get(&dh, i) == i);
+    }
+
+    assert(deamortized_resize(&dh, -1, 0) == ERR_OUT_OF_BOUNDS);
+    assert(deamortized_reserve(&dh, MAX_CAPACITY) == ERR_INVALID_CAPACITY);
+    assert(deamortized_reserve(NULL, 1) == ERR_NULL);
+    assert(deamortized_shrink_to_fit(NULL) == ERR_NULL);
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_deamortized_release_next(void)
+{
+    printf("Testing deamortized release of next_vector...\n");
+    deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
+
+    // Test a swap leaves no next_vector behind
+    for (int i = 0; i < MIN_CAPACITY; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+    }
+    assert(dh.current_vector.capacity == MIN_CAPACITY * 2);
+    assert(!dh.next_vector.is_allocated);
+
+    // Test release is refused while migration is due
+    assert(deamortized_push_back(&dh, MIN_CAPACITY) == OK);
+    assert(dh.next_vector.is_allocated && dh.reallocated_amount > 0);
+    assert(deamortized_release_next(&dh) == OK);
+    assert(dh.next_vector.is_allocated);
+
+    // Test an idle next_vector is given back
+    for (int i = 0; i < 2; i++)
+    {
+        assert(deamortized_pop_back(&dh) == OK);
+    }
+    assert(dh.next_vector.is_allocated);
+    assert(deamortized_release_next(&dh) == OK);
+    assert(!dh.next_vector.is_allocated && dh.reallocated_amount == 0);
+
+    // Test migration restarts from scratch afterwards
+    for (int i = get_size(&dh); i < 1000; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+    }
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(deamortized_get(&dh, i) == i);
+    }
+
+    assert(deamortized_release_next(NULL) == ERR_NULL);
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_deamortized_migration_rate(void)
+{
+    printf("Testing deamortized migration rate...\n");
+    deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
+    assert(dh.migration_rate == DEFAULT_MIGRATION_RATE);
+
+    // Test rates too slow to finish migration in time are refused
+    assert(deamortized_set_migration_rate(&dh, MIN_MIGRATION_RATE - 1) == ERR_OUT_OF_BOUNDS);
+    assert(deamortized_set_migration_bytes(&dh, sizeof(long)) == ERR_OUT_OF_BOUNDS);
+    assert(dh.migration_rate == DEFAULT_MIGRATION_RATE);
+
+    // Test a higher rate migrates the whole half in one operation
+    assert(deamortized_set_migration_rate(&dh, MIN_CAPACITY / 2) == OK);
+    for (int i = 0; i < MIN_CAPACITY / 2; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+    }
+    assert(dh.reallocated_amount == MIN_CAPACITY / 2);
+
+    // Test the byte budget is converted to elements
+    assert(deamortized_set_migration_bytes(&dh, 64 * sizeof(long)) == OK);
+    assert(dh.migration_rate == 64);
+
+    for (int i = get_size(&dh); i < 5000; i++)
+    {
+        assert(deamortized_insert(&dh, i / 2, i) == OK);
+        assert(dh.reallocated_amount <= get_size(&dh));
+    }
+    while (get_size(&dh) > 10)
+    {
+        assert(deamortized_erase(&dh, get_size(&dh) / 3) == OK);
+    }
+    assert(dh.current_vector.capacity < 5000);
+
+    assert(deamortized_set_migration_rate(NULL, DEFAULT_MIGRATION_RATE) == ERR_NULL);
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_deamortized_make_progress(void)
+{
+    printf("Testing deamortized deferred migration...\n");
+    deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
+    assert(deamortized_set_deferred_migration(&dh, 1) == OK);
+
+    // Test next_vector shows up early and inserts leave migration alone
+    for (int i = 0; i < MIN_CAPACITY / 2; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+        assert(dh.next_vector.is_allocated == (i + 1 >= MIN_CAPACITY / 2 - MIN_CAPACITY / 8));
+    }
+    assert(dh.reallocated_amount == 0);
+    assert(deamortized_pending_migration(&dh) == MIN_CAPACITY / 2);
+
+    // Test explicit progress respects its budget
+    assert(deamortized_make_progress(&dh, 5) == OK);
+    assert(dh.reallocated_amount == 5);
+    assert(deamortized_make_progress(&dh, 1000) == OK);
+    assert(deamortized_pending_migration(&dh) == 0);
+    assert(deamortized_make_progress(&dh, 1000) == OK);
+    assert(deamortized_make_progress(&dh, -1) == ERR_OUT_OF_BOUNDS);
+
+    // Test inserts catch up on their own when nobody makes progress
+    for (int i = get_size(&dh); i < 10000; i++)
+    {
+        assert(deamortized_insert(&dh, i / 3, i) == OK);
+        assert(deamortized_pending_migration(&dh) <= dh.current_vector.capacity - get_size(&dh));
+    }
+
+    // Test progress can complete a shrink
+    while (get_size(&dh) > 100)
+    {
+        assert(deamortized_pop_back(&dh) == OK);
+    }
+    int capacity = dh.current_vector.capacity;
+    while (deamortized_pending_migration(&dh) > 0)
+    {
+        assert(deamortized_make_progress(&dh, 7) == OK);
+    }
+    assert(dh.current_vector.capacity < capacity);
+    for (int i = 0; i < 100; i++)
+    {
+        assert(deamortized_get(&dh, i) == get(&dh.current_vector, i));
+    }
+
+    assert(deamortized_make_progress(NULL, 1) == ERR_NULL);
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_deamortized_vector_file(void)
+{
+    printf("Testing deamortized vector files...\n");
+    deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
+
+    // Test the logical contents are saved even mid-migration
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+    }
+    assert(dh.next_vector.is_allocated && dh.reallocated_amount > 0);
+    assert(deamortized_vector_save(&dh, TEST_FILE) == OK);
+
+    deamortized_vector_header loaded = init_deamortized_vector(MIN_CAPACITY);
+    assert(deamortized_vector_load(&loaded, TEST_FILE) == OK);
+    assert(get_size(&loaded) == 1000);
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(deamortized_get(&loaded, i) == i);
+    }
+
+    remove(TEST_FILE);
+    assert(deamortized_vector_load(&loaded, TEST_FILE) == ERR_IO);
+    free_deamortized_vector(&loaded);
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_deamortized_search(void)
+{
+    printf("Testing deamortized search during migration...\n");
+    deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
+    ptrdiff_t index, count;
+    long value;
+
+    for (int i = 0; i < 100; i++)
+    {
+        assert(deamortized_push_back(&dh, i % 10) == OK);
+    }
+    assert(dh.reallocated_amount > 0 && dh.reallocated_amount < get_size(&dh));
+
+    // Test elements on both sides of the migration point are seen exactly once
+    assert(deamortized_count(&dh, 3, &count) == OK && count == 10);
+    assert(deamortized_find(&dh, 9, &index) == OK && index == 9);
+    assert(deamortized_sum(&dh, &value) == OK && value == 450);
+    assert(deamortized_set(&dh, 99, -5) == OK);
+    assert(deamortized_min(&dh, &value) == OK && value == -5);
+    assert(deamortized_argmin(&dh, &index) == OK && index == 99);
+    assert(deamortized_max(&dh, &value) == OK && value == 9);
+
+    assert(deamortized_sum(NULL, &value) == ERR_NULL);
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_deamortized_sort(void)
+{
+    printf("Testing deamortized sort...\n");
+
+    for (int finish = 0; finish < 2; finish++)
+    {
+        deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
+        vector_header reference = init_vector(MIN_CAPACITY);
+
+        // Test sorting mid-migration, close enough to capacity that little
+        // room is left to re-migrate the sorted contents in
+        for (int i = 0; i < 1000; i++)
+        {
+            long value = rand() % 10000 - 5000;
+            assert(deamortized_push_back(&dh, value) == OK && push_back(&reference, value) == OK);
+        }
+        assert(dh.next_vector.is_allocated && get_size(&dh) > dh.current_vector.capacity - dh.current_vector.capacity / 8);
+
+        assert(deamortized_sort(&dh, finish) == OK);
+        assert(vector_sort(&reference) == OK);
+        if (finish)
+        {
+            assert(dh.reallocated_amount == 0);
+            assert(!dh.next_vector.is_allocated && dh.current_vector.capacity >= 2 * reference.size);
+        }
+        for (int i = 0; i < reference.size; i++)
+        {
+            assert(deamortized_get(&dh, i) == get(&reference, i));
+        }
+        for (int i = 0; i < dh.reallocated_amount; i++)
+        {
+            assert(get(&dh.next_vector, i) == get(&reference, i));
+        }
+
+        // Test the sort caught migration up itself, so the operations after it
+        // still only migrate migration_rate elements each
+        for (int i = 0; i < 20; i++)
+        {
+            ptrdiff_t migrated = dh.reallocated_amount;
+            assert(deamortized_push_back(&dh, i) == OK && push_back(&reference, i) == OK);
+            assert(dh.reallocated_amount - migrated <= dh.migration_rate);
+        }
+
+        // Test migration picks up again from the sorted contents
+        for (int i = 0; i < 3000; i++)
+        {
+            assert(deamortized_push_back(&dh, i) == OK && push_back(&reference, i) == OK);
+        }
+        for (int i = 0; i < reference.size; i++)
+        {
+            assert(deamortized_get(&dh, i) == get(&reference, i));
+        }
+        for (int i = 0; i < dh.reallocated_amount; i++)
+        {
+            assert(get(&dh.next_vector, i) == get(&reference, i));
+        }
+
+        free_vector(&reference);
+        free_deamortized_vector(&dh);
+    }
+
+    assert(deamortized_sort(NULL, 1) == ERR_NULL);
+    printf("Passed!\n\n");
+}
+
+void test_deamortized_spans(void)
+{
+    printf("Testing deamortized spans during migration...\n");
+    deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
+    vector_span spans[MAX_SPANS];
+    vector_cursor cursor;
+    int count;
+    long value;
+
+    for (int i = 0; i < 100; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+    }
+    assert(dh.reallocated_amount > 0 && dh.reallocated_amount < get_size(&dh));
+
+    // Test the spans cover every element exactly once, in order
+    assert(deamortized_get_spans(&dh, spans, &count) == OK);
+    int total = 0;
+    for (int i = 0; i < count; i++)
+    {
+        for (int j = 0; j < spans[i].length; j++)
+        {
+            assert(spans[i].start_address[j] == total++);
+        }
+    }
+    assert(total == 100);
+
+    assert(init_deamortized_cursor(&cursor, &dh) == OK);
+    for (int i = 0; i < 100; i++)
+    {
+        assert(cursor_next(&cursor, &value) && value == i);
+    }
+    assert(!cursor_next(&cursor, &value));
+
+    assert(deamortized_get_spans(NULL, spans, &count) == ERR_NULL);
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_deamortized_stats(void)
+{
+    printf("Testing deamortized stats...\n");
+    deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
+    vector_stats stats = {0};
+
+    assert(deamortized_attach_stats(&dh, &stats) == OK);
+
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+    }
+
+#ifdef VECTOR_STATS
+    // Test every swap followed a full migration, and the gauges track the header
+    assert(stats.swaps > 0 && stats.grows >= stats.swaps);
+    assert(stats.bytes_migrated >= stats.swaps * MIN_CAPACITY * sizeof(long));
+    assert(stats.migrated == (uint64_t)dh.reallocated_amount && stats.size == 1000);
+    assert(stats.peak_capacity >= (uint64_t)dh.current_vector.capacity);
+    assert(stats.allocator_calls > 0);
+#else
+    assert(stats.swaps == 0 && stats.bytes_migrated == 0);
+#endif
+
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(deamortized_get(&dh, i) == i);
+    }
+
+    assert(deamortized_attach_stats(NULL, &stats) == ERR_NULL);
+    free_deamortized_vector(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_deamortized_snapshots(void)
+{
+    printf("Testing deamortized snapshots...\n");
+    vector_cow cow = init_cow();
+    deamortized_vector_header dh = init_deamortized_vector_with_allocator(MIN_CAPACITY, cow_allocator(&cow));
+    vector_header reference = init_vector(MIN_CAPACITY);
+    snapshot_header views[SNAPSHOT_TEST_VIEWS] = {0};
+    long *expected[SNAPSHOT_TEST_VIEWS] = {0};
+    int mid_migration = 0;
+
+    // grow through a few migrations, then drain through shrinks, snapshotting
+    // along the way and checking every view against what it was given
+    for (int i = 0; i < 4 * SNAPSHOT_TEST_SIZE; i++)
+    {
+        int op = i < 5 * SNAPSHOT_TEST_SIZE / 2 ? rand() % 6 : (int[]){2, 3, 3, 4}[rand() % 4];
+        ptrdiff_t index = rand() % (reference.size + 1);
+        long value = rand();
+
+        switch (op)
+        {
+        case 0:
+        case 1:
+            assert(deamortized_push_back(&dh, value) == OK && push_back(&reference, value) == OK);
+            break;
+        case 2:
+            assert(deamortized_insert(&dh, index, value) == OK && insert(&reference, index, value) == OK);
+            break;
+        case 3:
+            if (reference.size > 0)
+            {
+                assert(deamortized_pop_back(&dh) == OK && pop_back(&reference) == OK);
+            }
+            break;
+        case 4:
+            if (reference.size > 0)
+            {
+                assert(deamortized_erase(&dh, index % reference.size) == OK && erase(&reference, index % reference.size) == OK);
+            }
+            break;
+        default:
+            if (reference.size > 0)
+            {
+                assert(deamortized_set(&dh, index % reference.size, value) == OK && set(&reference, index % reference.size, value) == OK);
+            }
+            break;
+        }
+
+        if (i % 2500 == 0)
+        {
+            int slot = i / 2500 % SNAPSHOT_TEST_VIEWS;
+            if (expected[slot] != NULL)
+            {
+                assert(views[slot].size == 0 || memcmp(views[slot].start_address, expected[slot], views[slot].size * sizeof(long)) == 0);
+                assert(release_snapshot(&views[slot]) == OK);
+                free(expected[slot]);
+            }
+
+            mid_migration += deamortized_pending_migration(&dh) > 0;
+            assert(deamortized_snapshot(&dh, &views[slot]) == OK && views[slot].size == reference.size);
+            expected[slot] = malloc((reference.size + 1) * sizeof(long));
+            memcpy(expected[slot], reference.start_address, reference.size * sizeof(long));
+        }
+    }
+    assert(mid_migration > 0);
+
+    // Test the views survive the vector
+    free_deamortized_vector(&dh);
+    for (int slot = 0; slot < SNAPSHOT_TEST_VIEWS; slot++)
+    {
+        assert(views[slot].size == 0 || memcmp(views[slot].start_address, expected[slot], views[slot].size * sizeof(long)) == 0);
+        assert(release_snapshot(&views[slot]) == OK);
+        free(expected[slot]);
+    }
+
+    assert(deamortized_snapshot(NULL, &views[0]) == ERR_NULL);
+    free_vector(&reference);
+    assert(cow.free_count == cow.chunk_slots);
+    assert(free_cow(&cow) == OK);
+    printf("Passed!\n\n");
+}
+
+void test_typed_deamortized_vectors(void)
+{
+    printf("Testing typed deamortized vectors...\n");
+    int32_deamortized_vector_header dh = int32_deamortized_vector_init(MIN_CAPACITY);
+    deamortized_vector_header reference = init_deamortized_vector(MIN_CAPACITY);
+
+    // Test it tracks the long implementation through growth and shrinking
+    for (int i = 0; i < 2000; i++)
+    {
+        int index = rand() % (get_size(&reference) + 1);
+        int32_t value = rand() % 1000;
+
+        if (i < 1200 || rand() % 4 == 0)
+        {
+            assert(int32_deamortized_vector_insert(&dh, index, value) == deamortized_insert(&reference, index, value));
+        }
+        else if (get_size(&reference) > 0)
+        {
+            index %= get_size(&reference);
+            assert(int32_deamortized_vector_erase(&dh, index) == deamortized_erase(&reference, index));
+        }
+
+        assert(int32_deamortized_vector_size(&dh) == get_size(&reference));
+        assert(dh.current_vector.capacity == reference.current_vector.capacity);
+    }
+
+    // Test deferred migration matches too
+    assert(int32_deamortized_vector_set_deferred_migration(&dh, 1) == OK);
+    assert(deamortized_set_deferred_migration(&reference, 1) == OK);
+    for (int i = 0; i < 500; i++)
+    {
+        int32_t value = rand() % 1000;
+        assert(int32_deamortized_vector_push_back(&dh, value) == deamortized_push_back(&reference, value));
+        assert(int32_deamortized_vector_make_progress(&dh, i % 4) == deamortized_make_progress(&reference, i % 4));
+        assert(int32_deamortized_vector_pending_migration(&dh) == deamortized_pending_migration(&reference));
+    }
+
+    for (int i = 0; i < get_size(&reference); i++)
+    {
+        int32_t value = 0;
+        assert(int32_deamortized_vector_get(&dh, i, &value) == OK);
+        assert(value == deamortized_get(&reference, i));
+    }
+
+    // Test sorting and reserving restart migration the same way too
+    assert(int32_deamortized_vector_sort_by(&dh, compare_int32s, 0) == OK);
+    assert(deamortized_sort(&reference, 0) == OK);
+    assert(int32_deamortized_vector_pending_migration(&dh) == deamortized_pending_migration(&reference));
+    assert(int32_deamortized_vector_reserve(&dh, 50000) == deamortized_reserve(&reference, 50000));
+    assert(dh.next_vector.capacity == reference.next_vector.capacity);
+    for (int i = 0; i < get_size(&reference); i++)
+    {
+        int32_t value = 0;
+        assert(int32_deamortized_vector_get(&dh, i, &value) == OK);
+        assert(value == deamortized_get(&reference, i));
+    }
+
+    free_deamortized_vector(&reference);
+    int32_deamortized_vector_free(&dh);
+    printf("Passed!\n\n");
+}
+
+void test_deamortized_pool_allocator(void)
+{
+    printf("Testing deamortized vector with pool allocator...\n");
+    vector_pool pool = init_pool(4);
+
+    // Test buffers released by one vector are reused by the next
+    for (int round = 0; round < 3; round++)
+    {
+        deamortized_vector_header dh = init_deamortized_vector_with_allocator(MIN_CAPACITY, pool_allocator(&pool));
+        assert(dh.current_vector.allocator == pool_allocator(&pool));
+
+        for (int i = 0; i < 5000; i++)
+        {
+            assert(deamortized_push_back(&dh, i) == OK);
+        }
+        assert(dh.next_vector.allocator == pool_allocator(&pool));
+
+        while (get_size(&dh) > 0)
+        {
+            assert(deamortized_pop_back(&dh) == OK);
+        }
+        for (int i = 0; i < 100; i++)
+        {
+            assert(deamortized_push_back(&dh, i) == OK);
+            assert(deamortized_get(&dh, i) == i);
+        }
+
+        free_deamortized_vector(&dh);
+    }
+    assert(pool.hits > pool.misses);
+
+    free_pool(&pool);
+    for (int i = 0; i < POOL_CLASSES; i++)
+    {
+        assert(pool.free_lists[i] == NULL && pool.cached[i] == 0);
+    }
+    printf("Passed!\n\n");
+}
+
+void fuzz_deamortized_vector_operations(void)
+{
+    printf("Fuzz testing deamortized vector operations...\n");
+    srand((unsigned int)time(NULL));
+
+    for (int i = 0; i < 1000; i++)
+    {
+        deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
+        int operations = rand() % 100;
+
+        for (int j = 0; j < operations; j++)
+        {
+            int op = rand() % 5;
+            int index = rand() % (dh.current_vector.size + 1);
+            int value = rand();
+
+            switch (op)
+            {
+            case 0: // push_back
+                deamortized_push_back(&dh, value);
+                break;
+            case 1: // insert
+                deamortized_insert(&dh, index, value);
+                break;
+            case 2: // set
+                if (dh.current_vector.size > 0)
+                    deamortized_set(&dh, index % dh.current_vector.size, value);
+                break;
+            case 3: // get
+                if (dh.current_vector.size > 0)
+                    deamortized_get(&dh, index % dh.current_vector.size);
+                break;
+            case 4: // erase
+                if (dh.current_vector.size > 0)
+                    deamortized_erase(&dh, index % dh.current_vector.size);
+                break;
+            }
+        }
+
+        free_deamortized_vector(&dh);
+    }
+
+    printf("Fuzz testing passed!\n\n");
+}
+
+void deamortized_vector_tests(void)
+{
+    test_deamortized_vector_basic();
+    test_deamortized_reallocation_process();
+    test_deamortized_complex_operations();
+    test_deamortized_edge_cases();
+    test_deamortized_capacity_management();
+    test_deamortized_range_operations();
+    test_deamortized_shrinking();
+    test_deamortized_reserve_resize();
+    test_deamortized_release_next();
+    test_deamortized_migration_rate();
+    test_deamortized_make_progress();
+    test_deamortized_vector_file();
+    test_deamortized_search();
+    test_deamortized_sort();
+    test_deamortized_spans();
+    test_deamortized_stats();
+    test_deamortized_snapshots();
+    test_typed_deamortized_vectors();
+    test_deamortized_pool_allocator();
+    fuzz_deamortized_vector_operations();
+    fuzz_deamortized_against_reference();
+    fuzz_deamortized_batch_against_reference();
+    printf("All deamortized vector tests passed!\n");
+}
+
+void test_tiered_vector_basic(void)
+{
+    printf("Testing tiered vector...\n");
+
+    // Test initialization
+    tiered_vector_header th = init_tiered_vector(TEST_CAPACITY);
+    assert(th.is_allocated);
+    assert(th.block_shift == MIN_BLOCK_SHIFT);
+    assert(tiered_get_size(&th) == 0);
+    assert(init_tiered_vector(-1).is_allocated == 0);
+
+    // Test push_back and get
+    for (int i = 0; i < 5; i++)
+    {
+        assert(tiered_push_back(&th, i * 10) == OK);
+    }
+    for (int i = 0; i < 5; i++)
+    {
+        assert(tiered_get(&th, i) == i * 10);
+    }
+
+    // Test set, insert and erase
+    assert(tiered_set(&th, 2, TEST_VALUE) == OK);
+    assert(tiered_insert(&th, 2, 100) == OK);
+    assert(tiered_get(&th, 2) == 100 && tiered_get(&th, 3) == TEST_VALUE);
+    assert(tiered_erase(&th, 2) == OK);
+    assert(tiered_get(&th, 2) == TEST_VALUE);
+    assert(tiered_pop_back(&th) == OK);
+    assert(tiered_get_size(&th) == 4);
+
+    // Test invalid operations
+    assert(tiered_get(&th, 4) == ERR_OUT_OF_BOUNDS);
+    assert(tiered_insert(&th, 10, 10) == ERR_OUT_OF_BOUNDS);
+    assert(tiered_erase(&th, -1) == ERR_OUT_OF_BOUNDS);
+    assert(tiered_push_back(NULL, 1) == ERR_NULL);
+
+    tiered_vector_header invalid = {0};
+    assert(tiered_push_back(&invalid, 1) == ERR_INVALID_HEADER);
+    assert(free_tiered_vector(&invalid) == ERR_INVALID_HEADER);
+
+    // Test blocks grow with size and shrink back
+    for (int i = 0; i < 10000; i++)
+    {
+        assert(tiered_insert(&th, tiered_get_size(&th) / 2, i) == OK);
+    }
+    assert(th.block_shift > MIN_BLOCK_SHIFT);
+    assert(th.block_count <= 2 << th.block_shift);
+
+    while (tiered_get_size(&th) > 0)
+    {
+        assert(tiered_erase(&th, tiered_get_size(&th) / 3) == OK);
+    }
+    assert(th.block_shift == MIN_BLOCK_SHIFT);
+    assert(th.block_count <= 1);
+
+    free_tiered_vector(&th);
+    printf("Passed!\n\n");
+}
+
+void fuzz_tiered_against_reference(void)
+{
+    printf("Fuzz testing tiered vector against reference...\n");
+
+    for (int i = 0; i < 100; i++)
+    {
+        tiered_vector_header th = init_tiered_vector(rand() % 1000 + 1);
+        vector_header reference = init_vector(MIN_CAPACITY);
+
+        for (int j = 0; j < 3000; j++)
+        {
+            // grow first, then drain to exercise rebuilding both ways
+            int op = j < 2000 ? rand() % 4 : rand() % 4 + 2;
+            int index = rand() % (reference.size + 1);
+            long value = rand();
+
+            switch (op)
+            {
+            case 0: // push_back
+                assert(tiered_push_back(&th, value) == push_back(&reference, value));
+                break;
+            case 1: // insert
+                assert(tiered_insert(&th, index, value) == insert(&reference, index, value));
+                break;
+            case 2: // set
+                if (reference.size > 0)
+                    assert(tiered_set(&th, index % reference.size, value) == set(&reference, index % reference.size, value));
+                break;
+            default: // erase
+                if (reference.size > 0)
+                    assert(tiered_erase(&th, index % reference.size) == erase(&reference, index % reference.size));
+                break;
+            }
+
+            assert(tiered_get_size(&th) == reference.size);
+        }
+
+        for (int j = 0; j < reference.size; j++)
+        {
+            assert(tiered_get(&th, j) == get(&reference, j));
+        }
+
+        free_vector(&reference);
+        free_tiered_vector(&th);
+    }
+
+    printf("Fuzz testing passed!\n\n");
+}
+
+void tiered_vector_tests(void)
+{
+    test_tiered_vector_basic();
+    fuzz_tiered_against_reference();
+    printf("All tiered vector tests passed!\n");
+}
+
+void test_concurrent_vector_basic(void)
+{
+    printf("Testing concurrent vector basic operations...\n");
+    concurrent_vector_header ch = init_concurrent_vector();
+    assert(ch.is_allocated);
+    assert(concurrent_get_size(&ch) == 0);
+
+    // Test values survive crossing several segments
+    for (int i = 0; i < 10000; i++)
+    {
+        assert(concurrent_push_back(&ch, i) == OK);
+    }
+    assert(concurrent_get_size(&ch) == 10000);
+
+    long value;
+    for (int i = 0; i < 10000; i++)
+    {
+        assert(concurrent_get(&ch, i, &value) == OK && value == i);
+    }
+
+    assert(concurrent_set(&ch, 5000, TEST_VALUE) == OK);
+    assert(concurrent_get(&ch, 5000, &value) == OK && value == TEST_VALUE);
+
+    // Test bounds and invalid headers
+    assert(concurrent_get(&ch, -1, &value) == ERR_OUT_OF_BOUNDS);
+    assert(concurrent_get(&ch, 10000, &value) == ERR_OUT_OF_BOUNDS);
+    assert(concurrent_set(&ch, 10000, 0) == ERR_OUT_OF_BOUNDS);
+    assert(concurrent_get(NULL, 0, &value) == ERR_NULL);
+
+    assert(free_concurrent_vector(&ch) == OK);
+    assert(free_concurrent_vector(&ch) == ERR_INVALID_HEADER);
+    assert(concurrent_push_back(&ch, 0) == ERR_INVALID_HEADER);
+    printf("Passed!\n\n");
+}
+
+typedef struct
+{
+    concurrent_vector_header *vector;
+    long thread;
+} concurrent_test_worker;
+
+static void *push_from_thread(void *argument)
+{
+    concurrent_test_worker *worker = argument;
+
+    for (long i = 0; i < CONCURRENT_TEST_PUSHES; i++)
+    {
+        assert(concurrent_push_back(worker->vector, worker->thread * CONCURRENT_TEST_PUSHES + i) == OK);
+    }
+
+    return NULL;
+}
+
+static void *read_while_pushing(void *argument)
+{
+    concurrent_vector_header *vector = argument;
+    long value;
+
+    // published elements must be readable and never torn, however far growth got
+    for (int round = 0; round < 100; round++)
+    {
+        int size = concurrent_get_size(vector);
+        for (int i = 0; i < size; i += 97)
+        {
+            if (concurrent_get(vector, i, &value) == OK)
+            {
+                assert(value >= 0 && value < CONCURRENT_TEST_THREADS * CONCURRENT_TEST_PUSHES);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+void test_concurrent_vector_threads(void)
+{
+    printf("Testing concurrent vector with %d threads...\n", CONCURRENT_TEST_THREADS);
+    concurrent_vector_header ch = init_concurrent_vector();
+    pthread_t threads[CONCURRENT_TEST_THREADS];
+    concurrent_test_worker workers[CONCURRENT_TEST_THREADS];
+    pthread_t reader;
+
+    assert(pthread_create(&reader, NULL, read_while_pushing, &ch) == 0);
+    for (int i = 0; i < CONCURRENT_TEST_THREADS; i++)
+    {
+        workers[i] = (concurrent_test_worker){&ch, i};
+        assert(pthread_create(&threads[i], NULL, push_from_thread, &workers[i]) == 0);
+    }
+    for (int i = 0; i < CONCURRENT_TEST_THREADS; i++)
+    {
+        assert(pthread_join(threads[i], NULL) == 0);
+    }
+    assert(pthread_join(reader, NULL) == 0);
+
+    // Test every value landed exactly once, in order per thread
+    int total = CONCURRENT_TEST_THREADS * CONCURRENT_TEST_PUSHES;
+    long next[CONCURRENT_TEST_THREADS] = {0};
+    assert(concurrent_get_size(&ch) == total);
+
+    for (int i = 0; i < total; i++)
+    {
+        long value;
+        assert(concurrent_get(&ch, i, &value) == OK);
+
+        long thread = value / CONCURRENT_TEST_PUSHES;
+        assert(value % CONCURRENT_TEST_PUSHES == next[thread]);
+        next[thread]++;
+    }
+
+    free_concurrent_vector(&ch);
+    printf("Passed!\n\n");
+}
+
+void concurrent_vector_tests(void)
+{
+    test_concurrent_vector_basic();
+    test_concurrent_vector_threads();
+    printf("All concurrent vector tests passed!\n");
+}
+
+void test_small_vector_basic(void)
+{
+    printf("Testing small vector basic operations...\n");
+    vector_arena arena = init_arena(1 << 16);
+    small_vector_header sh = init_small_vector_with_allocator(arena_allocator(&arena));
+
+    // Test elements stay inline, without allocating, up to SMALL_VECTOR_CAPACITY
+    for (int i = 0; i < SMALL_VECTOR_CAPACITY; i++)
+    {
+        assert(small_push_back(&sh, i) == OK);
+    }
+    assert(!sh.is_spilled && arena.used == 0);
+    assert(small_insert(&sh, SMALL_VECTOR_CAPACITY + 1, 0) == ERR_OUT_OF_BOUNDS);
+    assert(small_get(&sh, SMALL_VECTOR_CAPACITY) == ERR_OUT_OF_BOUNDS);
+
+    // Test a copy of the header is a vector of its own while inline
+    small_vector_header copy = sh;
+    assert(small_set(&copy, 0, TEST_VALUE) == OK);
+    assert(small_get(&sh, 0) == 0 && small_get(&copy, 0) == TEST_VALUE);
+
+    // Test the next insert spills to the allocator, keeping order
+    assert(small_insert(&sh, 0, -1) == OK);
+    assert(sh.is_spilled && arena.used > 0);
+    assert(small_get_size(&sh) == SMALL_VECTOR_CAPACITY + 1);
+    for (int i = 0; i <= SMALL_VECTOR_CAPACITY; i++)
+    {
+        assert(small_get(&sh, i) == i - 1);
+    }
+
+    assert(small_erase(&sh, 0) == OK);
+    assert(small_pop_back(&sh) == OK);
+    assert(small_get_size(&sh) == SMALL_VECTOR_CAPACITY - 1 && small_get(&sh, 0) == 0);
+
+    assert(small_push_back(NULL, 0) == ERR_NULL);
+    assert(free_small_vector(&sh) == OK);
+    assert(small_get(&sh, 0) == ERR_INVALID_HEADER);
+    assert(free_small_vector(&sh) == ERR_INVALID_HEADER);
+    free_arena(&arena);
+    printf("Passed!\n\n");
+}
+
+void test_small_deamortized_vector(void)
+{
+    printf("Testing small deamortized vector...\n");
+    small_deamortized_vector_header sh = init_small_deamortized_vector();
+
+    for (int i = 0; i < SMALL_VECTOR_CAPACITY; i++)
+    {
+        assert(small_deamortized_push_back(&sh, i) == OK);
+    }
+    assert(!sh.is_spilled);
+
+    // Test spilling allocates current_vector only, with no migration under way
+    assert(small_deamortized_push_back(&sh, SMALL_VECTOR_CAPACITY) == OK);
+    assert(sh.is_spilled && !sh.storage.heap.next_vector.is_allocated);
+    assert(deamortized_pending_migration(&sh.storage.heap) == 0);
+
+    for (int i = SMALL_VECTOR_CAPACITY + 1; i < 1000; i++)
+    {
+        assert(small_deamortized_push_back(&sh, i) == OK);
+    }
+    for (int i = 0; i < 1000; i++)
+    {
+        assert(small_deamortized_get(&sh, i) == i);
+    }
+
+    assert(small_deamortized_set(&sh, 999, TEST_VALUE) == OK);
+    assert(small_deamortized_get(&sh, 999) == TEST_VALUE);
+    assert(small_deamortized_erase(&sh, 0) == OK && small_deamortized_get(&sh, 0) == 1);
+    assert(small_deamortized_get_size(&sh) == 999);
 
-    free_deamortized_vector(&dh);
+    assert(free_small_deamortized_vector(&sh) == OK);
+    assert(small_deamortized_get(&sh, 0) == ERR_INVALID_HEADER);
     printf("Passed!\n\n");
 }
 
-void test_deamortized_capacity_management(void)
+void fuzz_small_against_reference(void)
 {
-    printf("Testing deamortized capacity management...\n");
-    deamortized_vector_header dh = init_deamortized_vector(2);
+    printf("Fuzz testing small vectors against reference...\n");
 
-    // Verify initial capacity progression
-    assert(dh.current_vector.capacity == 32);
-    assert(dh.next_vector.capacity == 64);
+    for (int i = 0; i < 100; i++)
+    {
+        small_vector_header sh = init_small_vector();
+        small_deamortized_vector_header sdh = init_small_deamortized_vector();
+        vector_header reference = init_vector(MIN_CAPACITY);
+        // mostly around the inline capacity, sometimes well past it
+        int limit = i % 10 == 0 ? 200 : SMALL_VECTOR_CAPACITY + 2;
 
-    // Trigger first reallocation
-    deamortized_push_back(&dh, 1);
-    deamortized_push_back(&dh, 2);
-    deamortized_push_back(&dh, 3); // Trigger realloc
-    assert(dh.next_vector.capacity == 64);
+        for (int j = 0; j < 500; j++)
+        {
+            int op = reference.size < limit ? rand() % 4 : rand() % 2 + 2;
+            int index = rand() % (reference.size + 1);
+            long value = rand();
 
-    // Complete reallocation
-    while (dh.reallocated_amount > 0)
+            switch (op)
+            {
+            case 0: // push_back
+                assert(small_push_back(&sh, value) == push_back(&reference, value));
+                assert(small_deamortized_push_back(&sdh, value) == OK);
+                break;
+            case 1: // insert
+                assert(small_insert(&sh, index, value) == insert(&reference, index, value));
+                assert(small_deamortized_insert(&sdh, index, value) == OK);
+                break;
+            case 2: // set
+                if (reference.size > 0)
+                {
+                    assert(small_set(&sh, index % reference.size, value) == set(&reference, index % reference.size, value));
+                    assert(small_deamortized_set(&sdh, index % reference.size, value) == OK);
+                }
+                break;
+            default: // erase
+                if (reference.size > 0)
+                {
+                    assert(small_deamortized_erase(&sdh, index % reference.size) == OK);
+                    assert(small_erase(&sh, index % reference.size) == erase(&reference, index % reference.size));
+                }
+                break;
+            }
+
+            assert(small_get_size(&sh) == reference.size);
+            assert(small_deamortized_get_size(&sdh) == reference.size);
+        }
+
+        for (int j = 0; j < reference.size; j++)
+        {
+            assert(small_get(&sh, j) == get(&reference, j));
+            assert(small_deamortized_get(&sdh, j) == get(&reference, j));
+        }
+
+        free_vector(&reference);
+        free_small_vector(&sh);
+        free_small_deamortized_vector(&sdh);
+    }
+
+    printf("Fuzz testing passed!\n\n");
+}
+
+void small_vector_tests(void)
+{
+    test_small_vector_basic();
+    test_small_deamortized_vector();
+    fuzz_small_against_reference();
+    printf("All small vector tests passed!\n");
+}
+
+void test_segmented_vector_basic(void)
+{
+    printf("Testing segmented vector basic operations...\n");
+    segmented_vector_header sh = init_segmented_vector(0);
+    long *addresses[100];
+
+    assert(sh.is_allocated && sh.block_count == 1);
+    assert(segmented_pop_back(&sh) == ERR_OUT_OF_BOUNDS);
+
+    // Test addresses taken early survive every later growth
+    for (int i = 0; i < 100000; i++)
     {
-        deamortized_push_back(&dh, dh.current_vector.size);
+        assert(segmented_push_back(&sh, i) == OK);
+        if (i < 100)
+        {
+            assert(segmented_get_address(&sh, i, &addresses[i]) == OK);
+        }
+    }
+    for (int i = 0; i < 100; i++)
+    {
+        assert(*addresses[i] == i);
+    }
+    for (int i = 0; i < 100000; i++)
+    {
+        assert(segmented_get(&sh, i) == i);
     }
-    assert(dh.current_vector.capacity == 32);
-    assert(dh.next_vector.capacity == 64);
 
-    // Verify size/capacity ratio after multiple reallocations
+    // Test writes through an address and through set() meet
+    *addresses[7] = TEST_VALUE;
+    assert(segmented_get(&sh, 7) == TEST_VALUE);
+    assert(segmented_set(&sh, 8, -TEST_VALUE) == OK && *addresses[8] == -TEST_VALUE);
+
+    // Test popping releases trailing blocks, keeping one spare
+    int block_count = sh.block_count;
+    while (segmented_get_size(&sh) > 40)
+    {
+        assert(segmented_pop_back(&sh) == OK);
+    }
+    assert(sh.block_count < block_count && sh.block_count == 3);
+    assert(*addresses[7] == TEST_VALUE && segmented_get(&sh, 39) == 39);
+
+    long *address;
+    assert(segmented_get(&sh, 40) == ERR_OUT_OF_BOUNDS);
+    assert(segmented_get_address(&sh, 40, &address) == ERR_OUT_OF_BOUNDS);
+    assert(segmented_get_address(&sh, 0, NULL) == ERR_NULL);
+    assert(segmented_push_back(NULL, 0) == ERR_NULL);
+
+    free_segmented_vector(&sh);
+    assert(segmented_get(&sh, 0) == ERR_INVALID_HEADER);
+    assert(free_segmented_vector(&sh) == ERR_INVALID_HEADER);
+
+    // Test initial capacity is allocated up front
+    sh = init_segmented_vector(1000);
+    assert(sh.block_count == 6);
+    free_segmented_vector(&sh);
+    printf("Passed!\n\n");
+}
+
+void fuzz_segmented_against_reference(void)
+{
+    printf("Fuzz testing segmented vector against reference...\n");
+
     for (int i = 0; i < 100; i++)
     {
-        deamortized_push_back(&dh, i);
+        vector_arena arena = init_arena(1 << 20);
+        segmented_vector_header sh = init_segmented_vector_with_allocator(rand() % 100, arena_allocator(&arena));
+        vector_header reference = init_vector(MIN_CAPACITY);
+
+        for (int j = 0; j < 3000; j++)
+        {
+            // grow first, then drain to release blocks again
+            int op = j < 2000 ? rand() % 3 : rand() % 3 + 1;
+            long value = rand();
+
+            switch (op)
+            {
+            case 0: // push_back
+                assert(segmented_push_back(&sh, value) == push_back(&reference, value));
+                break;
+            case 1: // set
+                if (reference.size > 0)
+                {
+                    int index = rand() % reference.size;
+                    assert(segmented_set(&sh, index, value) == set(&reference, index, value));
+                }
+                break;
+            default: // pop_back
+                assert(segmented_pop_back(&sh) == (reference.size > 0 ? pop_back(&reference) : ERR_OUT_OF_BOUNDS));
+                break;
+            }
+
+            assert(segmented_get_size(&sh) == reference.size);
+        }
+
+        for (int j = 0; j < reference.size; j++)
+        {
+            assert(segmented_get(&sh, j) == get(&reference, j));
+        }
+
+        free_vector(&reference);
+        free_segmented_vector(&sh);
+        free_arena(&arena);
     }
-    assert(dh.current_vector.capacity == 128);
-    assert(dh.next_vector.capacity == 256);
 
-    free_deamortized_vector(&dh);
+    printf("Fuzz testing passed!\n\n");
+}
+
+void segmented_vector_tests(void)
+{
+    test_segmented_vector_basic();
+    fuzz_segmented_against_reference();
+    printf("All segmented vector tests passed!\n");
+}
+
+void test_deque_basic(void)
+{
+    printf("Testing deque basic operations...\n");
+    deque_header dq = init_deque(MIN_CAPACITY);
+    vector_span spans[MAX_SPANS];
+    vector_cursor cursor;
+    int count;
+    long value;
+
+    assert(deque_pop_front(&dq) == ERR_OUT_OF_BOUNDS);
+    assert(deque_pop_back(&dq) == ERR_OUT_OF_BOUNDS);
+
+    // Test FIFO use keeps going round the same ring without growing; stopping
+    // with head near the end, so what follows wraps
+    for (int i = 0; i < 10010; i++)
+    {
+        assert(deque_push_back(&dq, i) == OK);
+        assert(deque_get(&dq, 0) == i);
+        assert(deque_pop_front(&dq) == OK);
+    }
+    assert(deque_get_size(&dq) == 0 && dq.current.capacity == MIN_CAPACITY);
+
+    // Test both ends, with the ring wrapped around its end
+    for (int i = 0; i < 10; i++)
+    {
+        assert(deque_push_back(&dq, i) == OK);
+        assert(deque_push_front(&dq, -i - 1) == OK);
+    }
+    for (int i = 0; i < 20; i++)
+    {
+        assert(deque_get(&dq, i) == i - 10);
+    }
+    assert(deque_set(&dq, 0, TEST_VALUE) == OK && deque_get(&dq, 0) == TEST_VALUE);
+    assert(deque_get(&dq, 20) == ERR_OUT_OF_BOUNDS);
+
+    // Test the spans cover the wrapped ring in order
+    assert(dq.current.head + 20 > dq.current.capacity);
+    assert(deque_get_spans(&dq, spans, &count) == OK && count == 2);
+    assert(spans[0].length + spans[1].length == 20 && spans[1].start_address[0] == spans[0].start_address[spans[0].length - 1] + 1);
+    assert(init_deque_cursor(&cursor, &dq) == OK);
+    assert(cursor_next(&cursor, &value) && value == TEST_VALUE);
+    for (int i = 1; i < 20; i++)
+    {
+        assert(cursor_next(&cursor, &value) && value == i - 10);
+    }
+    assert(!cursor_next(&cursor, &value));
+
+    assert(deque_pop_back(&dq) == OK && deque_pop_front(&dq) == OK);
+    assert(deque_get(&dq, 0) == -9 && deque_get(&dq, deque_get_size(&dq) - 1) == 8);
+
+    assert(deque_push_front(NULL, 0) == ERR_NULL);
+    assert(free_deque(&dq) == OK);
+    assert(deque_get(&dq, 0) == ERR_INVALID_HEADER);
+    assert(free_deque(&dq) == ERR_INVALID_HEADER);
     printf("Passed!\n\n");
 }
 
-void fuzz_deamortized_vector_operations(void)
+void test_deque_migration(void)
 {
-    printf("Fuzz testing deamortized vector operations...\n");
-    srand((unsigned int)time(NULL));
+    printf("Testing deque incremental growth...\n");
+    deque_header dq = init_deque(MIN_CAPACITY);
 
-    for (int i = 0; i < 1000; i++)
+    // Test growth copies a few elements per push, never the whole ring at once
+    for (int i = 0; i < 100000; i++)
     {
-        deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
-        int operations = rand() % 100;
+        int capacity = dq.current.capacity;
+        int migrated = dq.migrated_back - dq.migrated_front;
+        int was_migrating = dq.next.start_address != NULL;
 
-        for (int j = 0; j < operations; j++)
+        assert((i % 2 ? deque_push_front(&dq, i) : deque_push_back(&dq, i)) == OK);
+
+        if (dq.current.capacity == capacity)
         {
-            int op = rand() % 5;
-            int index = rand() % (dh.current_vector.size + 1);
-            int value = rand();
+            assert(!was_migrating || dq.migrated_back - dq.migrated_front <= migrated + DEQUE_MIGRATION_RATE + 1);
+        }
+        else
+        {
+            // swapped in by migration catching up, not by a full ring
+            assert(was_migrating && migrated >= dq.size - DEQUE_MIGRATION_RATE - 1);
+        }
+    }
+
+    // Test the order survived every ring swap
+    for (int i = 0; i < 50000; i++)
+    {
+        assert(deque_get(&dq, 49999 - i) == 2 * i + 1);
+        assert(deque_get(&dq, 50000 + i) == 2 * i);
+    }
+
+    free_deque(&dq);
+    printf("Passed!\n\n");
+}
+
+void fuzz_deque_against_reference(void)
+{
+    printf("Fuzz testing deque against reference...\n");
+
+    for (int i = 0; i < 100; i++)
+    {
+        deque_header dq = init_deque(rand() % 100);
+        vector_header reference = init_vector(MIN_CAPACITY);
+
+        for (int j = 0; j < 3000; j++)
+        {
+            // grow first, then drain from both ends
+            int op = j < 2000 ? rand() % 6 : rand() % 6 + 1;
+            long value = rand();
 
             switch (op)
             {
             case 0: // push_back
-                deamortized_push_back(&dh, value);
+                assert(deque_push_back(&dq, value) == push_back(&reference, value));
                 break;
-            case 1: // insert
-                deamortized_insert(&dh, index, value);
+            case 1: // push_front
+                assert(deque_push_front(&dq, value) == insert(&reference, 0, value));
                 break;
             case 2: // set
-                if (dh.current_vector.size > 0)
-                    deamortized_set(&dh, index % dh.current_vector.size, value);
+                if (reference.size > 0)
+                {
+                    int index = rand() % reference.size;
+                    assert(deque_set(&dq, index, value) == set(&reference, index, value));
+                }
                 break;
-            case 3: // get
-                if (dh.current_vector.size > 0)
-                    deamortized_get(&dh, index % dh.current_vector.size);
+            case 3:
+            case 4: // pop_front
+                assert(deque_pop_front(&dq) == (reference.size > 0 ? erase(&reference, 0) : ERR_OUT_OF_BOUNDS));
                 break;
-            case 4: // erase
-                if (dh.current_vector.size > 0)
-                    deamortized_erase(&dh, index % dh.current_vector.size);
+            default: // pop_back
+                assert(deque_pop_back(&dq) == (reference.size > 0 ? pop_back(&reference) : ERR_OUT_OF_BOUNDS));
                 break;
             }
+
+            assert(deque_get_size(&dq) == reference.size);
         }
 
-        free_deamortized_vector(&dh);
+        for (int j = 0; j < reference.size; j++)
+        {
+            assert(deque_get(&dq, j) == get(&reference, j));
+        }
+
+        free_vector(&reference);
+        free_deque(&dq);
     }
 
     printf("Fuzz testing passed!\n\n");
 }
 
-void deamortized_vector_tests(void)
+void deque_tests(void)
 {
-    test_deamortized_vector_basic();
-    test_deamortized_reallocation_process();
-    test_deamortized_complex_operations();
-    test_deamortized_edge_cases();
-    test_deamortized_capacity_management();
-    fuzz_deamortized_vector_operations();
-    printf("All deamortized vector tests passed!\n");
+    test_deque_basic();
+    test_deque_migration();
+    fuzz_deque_against_reference();
+    printf("All deque tests passed!\n");
+}
+
+void test_packed_vector_basic(void)
+{
+    printf("Testing packed vector basic operations...\n");
+    packed_vector_header ph = init_packed_vector(0);
+    long values[300];
+    ptrdiff_t index;
+    ptrdiff_t count;
+    long sum;
+
+    assert(packed_get_size(&ph) == 0);
+    assert(packed_pop_back(&ph) == ERR_OUT_OF_BOUNDS);
+    assert(packed_find(&ph, 0, &index) == OK && index == -1);
+
+    // Test timestamps a few seconds apart pack into narrow blocks
+    for (int i = 0; i < 300; i++)
+    {
+        assert(packed_push_back(&ph, 1700000000L + 3 * i) == OK);
+    }
+    assert(ph.block_count == 2 && ph.blocks[0].base == 1700000000L && ph.blocks[0].bit_width == 9);
+    assert(packed_get(&ph, 0) == 1700000000L && packed_get(&ph, 299) == 1700000897L);
+
+    // Test a set within the frame stays in place, one outside widens the block
+    assert(packed_set(&ph, 5, 1700000001L) == OK && ph.blocks[0].bit_width == 9);
+    assert(packed_set(&ph, 6, -1) == OK && ph.blocks[0].base == -1 && ph.blocks[0].bit_width == 31);
+    assert(packed_set(&ph, 290, TEST_VALUE) == OK);
+    assert(packed_get(&ph, 5) == 1700000001L && packed_get(&ph, 6) == -1 && packed_get(&ph, 7) == 1700000021L);
+
+    // Test the full range of long in one block
+    assert(packed_set(&ph, 130, LONG_MIN) == OK && packed_set(&ph, 131, LONG_MAX) == OK);
+    assert(ph.blocks[1].bit_width == 64);
+    assert(packed_get(&ph, 130) == LONG_MIN && packed_get(&ph, 131) == LONG_MAX && packed_get(&ph, 132) == 1700000396L);
+
+    // Test decoding a range that starts and ends mid-block
+    assert(packed_decode(&ph, 3, 290, values) == OK);
+    for (int i = 0; i < 290; i++)
+    {
+        assert(values[i] == packed_get(&ph, i + 3));
+    }
+    assert(packed_decode(&ph, 10, 291, values) == ERR_OUT_OF_BOUNDS);
+
+    assert(packed_find(&ph, LONG_MAX, &index) == OK && index == 131);
+    assert(packed_find(&ph, TEST_VALUE, &index) == OK && index == 290);
+    assert(packed_find(&ph, 1700000001L, &index) == OK && index == 5);
+    assert(packed_count(&ph, 1700000003L, &count) == OK && count == 1);
+    assert(packed_sum(&ph, &sum) == OK);
+
+    // Test pop_back unpacks the last block back into the tail
+    while (packed_get_size(&ph) > 200)
+    {
+        assert(packed_pop_back(&ph) == OK);
+    }
+    assert(ph.block_count == 1 && packed_get(&ph, 199) == 1700000597L && packed_get(&ph, 131) == LONG_MAX);
+
+    assert(packed_get(&ph, 200) == ERR_OUT_OF_BOUNDS);
+    assert(packed_set(&ph, -1, 0) == ERR_OUT_OF_BOUNDS);
+    assert(packed_sum(&ph, NULL) == ERR_NULL);
+    assert(packed_push_back(NULL, 0) == ERR_NULL);
+    free_packed_vector(&ph);
+    assert(packed_get(&ph, 0) == ERR_INVALID_HEADER);
+    assert(free_packed_vector(&ph) == ERR_INVALID_HEADER);
+    printf("Passed!\n\n");
+}
+
+void test_packed_vector_widths(void)
+{
+    printf("Testing packed vector bit widths...\n");
+    simd_level level = get_simd_level();
+    long values[PACKED_BLOCK_SIZE];
+
+    // Test each width with its largest offset, on both decoders
+    for (int width = 0; width <= 64; width++)
+    {
+        packed_vector_header ph = init_packed_vector(PACKED_BLOCK_SIZE);
+        unsigned long mask = width == 64 ? ~0UL : (1UL << width) - 1;
+        long base = width == 64 ? LONG_MIN : -TEST_VALUE;
+
+        for (int i = 0; i < PACKED_BLOCK_SIZE; i++)
+        {
+            unsigned long offset = i == 77 ? mask : (((unsigned long)rand() << 33) ^ rand()) & mask;
+            assert(packed_push_back(&ph, (long)((unsigned long)base + (i == 0 ? 0 : offset))) == OK);
+        }
+        assert(ph.block_count == 1 && ph.blocks[0].bit_width == width && ph.blocks[0].base == base);
+
+        for (int pass = 0; pass < 2; pass++)
+        {
+            assert(set_simd_level(pass == 0 ? SIMD_SCALAR : level) == OK);
+            assert(packed_decode(&ph, 0, PACKED_BLOCK_SIZE, values) == OK);
+
+            for (int i = 0; i < PACKED_BLOCK_SIZE; i++)
+            {
+                assert(values[i] == packed_get(&ph, i));
+            }
+        }
+        assert(packed_get(&ph, 77) == (long)((unsigned long)base + mask));
+
+        free_packed_vector(&ph);
+    }
+
+    assert(set_simd_level(level) == OK);
+    printf("Passed!\n\n");
+}
+
+void test_packed_vector_memory(void)
+{
+    printf("Testing packed vector memory usage...\n");
+    packed_vector_header ph = init_packed_vector(100000);
+    long id = 1L << 40;
+
+    // Test ids growing by under 1000 at a time take 16 bits a block instead of 64
+    for (int i = 0; i < 100000; i++)
+    {
+        id += rand() % 1000;
+        assert(packed_push_back(&ph, id) == OK);
+    }
+    assert(packed_get(&ph, 99999) == id);
+    assert(packed_get_memory(&ph) < 100000 * sizeof(long) / 3);
+
+    // Test equal elements take no words at all
+    packed_vector_header constant = init_packed_vector(0);
+    for (int i = 0; i < 1024; i++)
+    {
+        assert(packed_push_back(&constant, TEST_VALUE) == OK);
+    }
+    assert(constant.blocks[7].bit_width == 0 && constant.blocks[7].words == NULL);
+    assert(packed_get(&constant, 1000) == TEST_VALUE);
+
+    free_packed_vector(&constant);
+    free_packed_vector(&ph);
+    printf("Passed!\n\n");
+}
+
+// Values from a narrow frame most of the time, so blocks stay packed tight
+// and sets keep crossing their frames
+static long packed_test_value(void)
+{
+    switch (rand() % 4)
+    {
+    case 0:
+        return 1000 + rand() % 16;
+    case 1:
+        return -(long)(rand() % 100000);
+    case 2:
+        return (long)(((unsigned long)rand() << 33) ^ rand());
+    default:
+        return 1000 + rand() % 64;
+    }
+}
+
+void fuzz_packed_against_reference(void)
+{
+    printf("Fuzz testing packed vector against reference...\n");
+    simd_level level = get_simd_level();
+
+    for (int i = 0; i < 100; i++)
+    {
+        // every other round on the scalar decoder
+        assert(set_simd_level(i % 2 ? SIMD_SCALAR : level) == OK);
+
+        vector_arena arena = init_arena(1 << 20);
+        packed_vector_header ph = init_packed_vector_with_allocator(rand() % 1000, arena_allocator(&arena));
+        vector_header reference = init_vector(MIN_CAPACITY);
+
+        for (int j = 0; j < 3000; j++)
+        {
+            // grow first, then drain to unpack blocks again
+            int op = j < 2000 ? rand() % 3 : rand() % 3 + 1;
+            long value = rand() % 8 == 0 ? packed_test_value() : 1000 + j;
+
+            switch (op)
+            {
+            case 0: // push_back
+                assert(packed_push_back(&ph, value) == push_back(&reference, value));
+                break;
+            case 1: // set
+                if (reference.size > 0)
+                {
+                    ptrdiff_t index = rand() % reference.size;
+                    assert(packed_set(&ph, index, value) == set(&reference, index, value));
+                }
+                break;
+            default: // pop_back
+                assert(packed_pop_back(&ph) == (reference.size > 0 ? pop_back(&reference) : ERR_OUT_OF_BOUNDS));
+                break;
+            }
+
+            assert(packed_get_size(&ph) == reference.size);
+        }
+
+        long *values = malloc((reference.size + 1) * sizeof(long));
+        assert(values != NULL);
+        assert(packed_decode(&ph, 0, reference.size, values) == OK);
+
+        for (ptrdiff_t j = 0; j < reference.size; j++)
+        {
+            assert(packed_get(&ph, j) == get(&reference, j) && values[j] == get(&reference, j));
+        }
+
+        long probe = reference.size > 0 ? get(&reference, rand() % reference.size) : 0;
+        ptrdiff_t expected, actual;
+        long expected_sum, actual_sum;
+
+        assert(packed_find(&ph, probe, &actual) == OK && vector_find(&reference, probe, &expected) == OK);
+        assert(actual == expected);
+        assert(packed_count(&ph, probe, &actual) == OK && vector_count(&reference, probe, &expected) == OK);
+        assert(actual == expected);
+        assert(packed_find(&ph, LONG_MIN, &actual) == OK && actual == -1);
+        assert(packed_sum(&ph, &actual_sum) == OK && vector_sum(&reference, &expected_sum) == OK);
+        assert(actual_sum == expected_sum);
+
+        free(values);
+        free_vector(&reference);
+        free_packed_vector(&ph);
+        free_arena(&arena);
+    }
+
+    assert(set_simd_level(level) == OK);
+    printf("Fuzz testing passed!\n\n");
+}
+
+void packed_vector_tests(void)
+{
+    test_packed_vector_basic();
+    test_packed_vector_widths();
+    test_packed_vector_memory();
+    fuzz_packed_against_reference();
+    printf("All packed vector tests passed!\n");
+}
+
+// Dense, so it needs the memory for real: elements longs for the vector, then
+// about twice that while the deamortized vector migrates
+void large_tests(const ptrdiff_t elements)
+{
+    printf("Testing %td elements (%td MB)...\n", elements, elements * (ptrdiff_t)sizeof(long) >> 20);
+    const ptrdiff_t stride = elements / 4096 + 1;
+    ptrdiff_t index;
+    long sum;
+
+    vector_header h = init_vector(MIN_CAPACITY);
+    for (ptrdiff_t i = 0; i < elements; i++)
+    {
+        assert(push_back(&h, i) == OK);
+    }
+    assert(h.size == elements);
+    for (ptrdiff_t i = 0; i < elements; i += stride)
+    {
+        assert(get(&h, i) == i);
+    }
+    assert(vector_sum(&h, &sum) == OK && sum == elements * (elements - 1) / 2);
+    assert(vector_find(&h, elements - 1, &index) == OK && index == elements - 1);
+    assert(insert(&h, elements - 2, -1) == OK && get(&h, elements) == elements - 1);
+    assert(erase(&h, elements - 2) == OK && get(&h, elements - 2) == elements - 2);
+    free_vector(&h);
+
+    deamortized_vector_header dh = init_deamortized_vector(MIN_CAPACITY);
+    for (ptrdiff_t i = 0; i < elements; i++)
+    {
+        assert(deamortized_push_back(&dh, i) == OK);
+    }
+    assert(get_size(&dh) == elements);
+    for (ptrdiff_t i = 0; i < elements; i += stride)
+    {
+        assert(deamortized_get(&dh, i) == i);
+    }
+    assert(deamortized_sum(&dh, &sum) == OK && sum == elements * (elements - 1) / 2);
+    while (get_size(&dh) > elements / 2)
+    {
+        assert(deamortized_pop_back(&dh) == OK);
+    }
+    assert(deamortized_get(&dh, elements / 2 - 1) == elements / 2 - 1);
+    free_deamortized_vector(&dh);
+    printf("All large tests passed!\n");
 }
 
-int main(void)
+int main(int argc, char **argv)
 {
+    // ./c_vector --large [elements] runs only the multi-GB tier
+    if (argc > 1 && strcmp(argv[1], "--large") == 0)
+    {
+        large_tests(argc > 2 ? atol(argv[2]) : LARGE_TEST_ELEMENTS);
+        return 0;
+    }
+
     vector_tests();
     deamortized_vector_tests();
+    tiered_vector_tests();
+    concurrent_vector_tests();
+    small_vector_tests();
+    segmented_vector_tests();
+    deque_tests();
+    packed_vector_tests();
 
     printf("All tests passed successfully!\n");
     return 0;
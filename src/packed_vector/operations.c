@@ -0,0 +1,643 @@
+#include <stdbool.h>
+#include <string.h>
+#include "../include/packed_vector/header.h"
+#include "../include/packed_vector/operations.h"
+#include "../include/allocator/operations.h"
+#include "../include/search/operations.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define HAS_X86_KERNELS 1
+#endif
+
+static int is_invalid(const packed_vector_header *const header)
+{
+    return !header->is_allocated;
+}
+
+static uint64_t get_mask(const int width)
+{
+    return width == 64 ? ~UINT64_C(0) : (UINT64_C(1) << width) - 1;
+}
+
+// Bits needed for every offset in [0, range]
+static int get_width(const uint64_t range)
+{
+    return range == 0 ? 0 : 64 - __builtin_clzll(range);
+}
+
+static size_t get_words_size(const int width)
+{
+    return width == 0 ? 0 : (PACKED_BLOCK_WORDS(width) + 2) * sizeof(uint64_t);
+}
+
+static ptrdiff_t get_tail_count(const packed_vector_header *const header)
+{
+    return header->size - header->block_count * PACKED_BLOCK_SIZE;
+}
+
+static uint64_t read_offset(const packed_block *const block, const ptrdiff_t position)
+{
+    if (block->bit_width == 0)
+    {
+        return 0;
+    }
+
+    uint64_t bit = (uint64_t)position * block->bit_width;
+    const uint64_t *word = block->words + bit / 64;
+    int shift = bit % 64;
+    uint64_t offset = word[0] >> shift;
+
+    if (shift + block->bit_width > 64)
+    {
+        offset |= word[1] << (64 - shift);
+    }
+
+    return offset & get_mask(block->bit_width);
+}
+
+static void write_offset(packed_block *const block, const ptrdiff_t position, const uint64_t offset)
+{
+    if (block->bit_width == 0)
+    {
+        return;
+    }
+
+    uint64_t mask = get_mask(block->bit_width);
+    uint64_t bit = (uint64_t)position * block->bit_width;
+    uint64_t *word = block->words + bit / 64;
+    int shift = bit % 64;
+
+    word[0] = (word[0] & ~(mask << shift)) | (offset << shift);
+
+    if (shift + block->bit_width > 64)
+    {
+        word[1] = (word[1] & ~(mask >> (64 - shift))) | (offset >> (64 - shift));
+    }
+}
+
+static void scalar_decode(const packed_block *const block, long *const values)
+{
+    for (ptrdiff_t i = 0; i < PACKED_BLOCK_SIZE; ++i)
+    {
+        values[i] = (long)((uint64_t)block->base + read_offset(block, i));
+    }
+}
+
+// Up to 56 bits, an offset and its bit shift fit in the 8 bytes from the
+// byte it starts in, one unaligned load each
+static void scalar_decode_narrow(const packed_block *const block, long *const values)
+{
+    const unsigned char *bytes = (const unsigned char *)block->words;
+    uint64_t mask = get_mask(block->bit_width);
+    uint64_t bit = 0;
+
+    for (ptrdiff_t i = 0; i < PACKED_BLOCK_SIZE; ++i, bit += block->bit_width)
+    {
+        uint64_t word;
+        memcpy(&word, bytes + bit / 8, sizeof(word));
+        values[i] = (long)((uint64_t)block->base + ((word >> bit % 8) & mask));
+    }
+}
+
+#ifdef HAS_X86_KERNELS
+// Four offsets per step: gather the word each one starts in and the word
+// after it, shift both into place and merge. A left shift by 64 yields 0, so
+// offsets that fit in their first word need no special case.
+__attribute__((target("avx2"))) static void avx2_decode(const packed_block *const block, long *const values)
+{
+    long long width = block->bit_width;
+    const long long *words = (const long long *)block->words;
+    __m256i base = _mm256_set1_epi64x(block->base);
+    __m256i mask = _mm256_set1_epi64x((long long)get_mask(block->bit_width));
+    __m256i low_bits = _mm256_set1_epi64x(63);
+    __m256i word_bits = _mm256_set1_epi64x(64);
+    __m256i step = _mm256_set1_epi64x(4 * width);
+    __m256i bits = _mm256_setr_epi64x(0, width, 2 * width, 3 * width);
+
+    for (ptrdiff_t i = 0; i < PACKED_BLOCK_SIZE; i += 4)
+    {
+        __m256i index = _mm256_srli_epi64(bits, 6);
+        __m256i shift = _mm256_and_si256(bits, low_bits);
+        __m256i low = _mm256_i64gather_epi64(words, index, 8);
+        __m256i high = _mm256_i64gather_epi64(words + 1, index, 8);
+        __m256i offset = _mm256_or_si256(_mm256_srlv_epi64(low, shift),
+                                         _mm256_sllv_epi64(high, _mm256_sub_epi64(word_bits, shift)));
+
+        _mm256_storeu_si256((__m256i *)(values + i), _mm256_add_epi64(base, _mm256_and_si256(offset, mask)));
+        bits = _mm256_add_epi64(bits, step);
+    }
+}
+
+// Two offsets per 128-bit lane, loaded from the byte the first one starts
+// in; pshufb moves the second one's 8 bytes into its own qword
+__attribute__((target("avx2"))) static void avx2_decode_narrow(const packed_block *const block, long *const values)
+{
+    long long width = block->bit_width;
+    const unsigned char *bytes = (const unsigned char *)block->words;
+    __m256i base = _mm256_set1_epi64x(block->base);
+    __m256i mask = _mm256_set1_epi64x((long long)get_mask(block->bit_width));
+    __m256i low_bits = _mm256_set1_epi64x(7);
+    __m256i byte_order = _mm256_set1_epi64x(0x0706050403020100LL);
+    __m256i spread = _mm256_setr_epi64x(0, 0x0808080808080808LL, 0, 0x0808080808080808LL);
+    __m256i step = _mm256_set1_epi64x(4 * width);
+    __m256i bits = _mm256_setr_epi64x(0, width, 2 * width, 3 * width);
+    uint64_t bit = 0;
+
+    for (ptrdiff_t i = 0; i < PACKED_BLOCK_SIZE; i += 4, bit += 4 * width)
+    {
+        __m256i first = _mm256_srli_epi64(bits, 3);
+        __m256i relative = _mm256_sub_epi64(first, _mm256_shuffle_epi32(first, 0x44));
+        __m256i control = _mm256_add_epi8(byte_order, _mm256_shuffle_epi8(relative, spread));
+        __m256i lanes = _mm256_loadu2_m128i((const __m128i *)(bytes + (bit + 2 * width) / 8),
+                                            (const __m128i *)(bytes + bit / 8));
+        __m256i word = _mm256_shuffle_epi8(lanes, control);
+        __m256i offset = _mm256_srlv_epi64(word, _mm256_and_si256(bits, low_bits));
+
+        _mm256_storeu_si256((__m256i *)(values + i), _mm256_add_epi64(base, _mm256_and_si256(offset, mask)));
+        bits = _mm256_add_epi64(bits, step);
+    }
+}
+#endif
+
+static void decode_block(const packed_block *const block, long *const values)
+{
+    if (block->bit_width == 0)
+    {
+        for (ptrdiff_t i = 0; i < PACKED_BLOCK_SIZE; ++i)
+        {
+            values[i] = block->base;
+        }
+
+        return;
+    }
+
+#ifdef HAS_X86_KERNELS
+    if (get_simd_level() >= SIMD_AVX2)
+    {
+        if (block->bit_width <= 56)
+        {
+            avx2_decode_narrow(block, values);
+        }
+        else
+        {
+            avx2_decode(block, values);
+        }
+
+        return;
+    }
+#endif
+
+    if (block->bit_width <= 56)
+    {
+        scalar_decode_narrow(block, values);
+        return;
+    }
+
+    scalar_decode(block, values);
+}
+
+// Narrowest frame holding every value
+static operation_result pack_block(const vector_allocator *const allocator, const long *const values, packed_block *const block)
+{
+    long min = values[0];
+    long max = values[0];
+
+    for (ptrdiff_t i = 1; i < PACKED_BLOCK_SIZE; ++i)
+    {
+        min = values[i] < min ? values[i] : min;
+        max = values[i] > max ? values[i] : max;
+    }
+
+    int width = get_width((uint64_t)max - (uint64_t)min);
+    uint64_t *words = NULL;
+
+    if (width > 0)
+    {
+        words = allocator_allocate(allocator, get_words_size(width));
+        if (words == NULL)
+        {
+            return ERR_MALLOC_FAILED;
+        }
+
+        memset(words, 0, get_words_size(width));
+    }
+
+    *block = (packed_block){min, width, words};
+
+    for (ptrdiff_t i = 0; i < PACKED_BLOCK_SIZE; ++i)
+    {
+        write_offset(block, i, (uint64_t)values[i] - (uint64_t)min);
+    }
+
+    return OK;
+}
+
+static void release_block(const packed_vector_header *const header, packed_block *const block)
+{
+    if (block->words != NULL)
+    {
+        allocator_release(header->allocator, block->words, get_words_size(block->bit_width));
+        block->words = NULL;
+    }
+}
+
+static int fits_block(const packed_block *const block, const long value)
+{
+    return value >= block->base && (uint64_t)value - (uint64_t)block->base <= get_mask(block->bit_width);
+}
+
+static operation_result grow_blocks(packed_vector_header *const header)
+{
+    if (header->block_capacity > PTRDIFF_MAX / 2 / (ptrdiff_t)sizeof(packed_block))
+    {
+        return ERR_INVALID_CAPACITY;
+    }
+
+    ptrdiff_t block_capacity = header->block_capacity * 2;
+    packed_block *blocks = allocator_reallocate(header->allocator,
+                                                header->blocks,
+                                                header->block_capacity * sizeof(packed_block),
+                                                block_capacity * sizeof(packed_block));
+    if (blocks == NULL)
+    {
+        return ERR_REALLOC_FAILED;
+    }
+
+    header->blocks = blocks;
+    header->block_capacity = block_capacity;
+
+    return OK;
+}
+
+packed_vector_header init_packed_vector(const ptrdiff_t capacity)
+{
+    return init_packed_vector_with_allocator(capacity, NULL);
+}
+
+packed_vector_header init_packed_vector_with_allocator(const ptrdiff_t capacity, const vector_allocator *const allocator)
+{
+    packed_vector_header header = {0};
+    header.allocator = allocator;
+
+    if (capacity < 0 || capacity / PACKED_BLOCK_SIZE >= PTRDIFF_MAX / (ptrdiff_t)sizeof(packed_block))
+    {
+        return header;
+    }
+
+    header.tail = allocator_allocate(allocator, PACKED_BLOCK_SIZE * sizeof(long));
+    if (header.tail == NULL)
+    {
+        return header;
+    }
+
+    header.block_capacity = capacity / PACKED_BLOCK_SIZE + 1;
+    header.blocks = allocator_allocate(allocator, header.block_capacity * sizeof(packed_block));
+    if (header.blocks == NULL)
+    {
+        allocator_release(allocator, header.tail, PACKED_BLOCK_SIZE * sizeof(long));
+        return (packed_vector_header){false, NULL, 0, 0, NULL, 0, allocator};
+    }
+
+    header.is_allocated = true;
+    return header;
+}
+
+operation_result free_packed_vector(packed_vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    for (ptrdiff_t i = 0; i < header->block_count; ++i)
+    {
+        release_block(header, &header->blocks[i]);
+    }
+
+    allocator_release(header->allocator, header->blocks, header->block_capacity * sizeof(packed_block));
+    allocator_release(header->allocator, header->tail, PACKED_BLOCK_SIZE * sizeof(long));
+
+    *header = (packed_vector_header){false, NULL, 0, 0, NULL, 0, header->allocator};
+    return OK;
+}
+
+long packed_get(const packed_vector_header *const header, const ptrdiff_t index)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (index < 0 || index >= header->size)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    ptrdiff_t block = index / PACKED_BLOCK_SIZE;
+
+    if (block == header->block_count)
+    {
+        return header->tail[index % PACKED_BLOCK_SIZE];
+    }
+
+    return (long)((uint64_t)header->blocks[block].base + read_offset(&header->blocks[block], index % PACKED_BLOCK_SIZE));
+}
+
+operation_result packed_set(packed_vector_header *const header, const ptrdiff_t index, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (index < 0 || index >= header->size)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    ptrdiff_t position = index % PACKED_BLOCK_SIZE;
+
+    if (index / PACKED_BLOCK_SIZE == header->block_count)
+    {
+        header->tail[position] = value;
+        return OK;
+    }
+
+    packed_block *block = &header->blocks[index / PACKED_BLOCK_SIZE];
+
+    if (fits_block(block, value))
+    {
+        write_offset(block, position, (uint64_t)value - (uint64_t)block->base);
+        return OK;
+    }
+
+    long values[PACKED_BLOCK_SIZE];
+    packed_block repacked;
+
+    decode_block(block, values);
+    values[position] = value;
+
+    operation_result result = pack_block(header->allocator, values, &repacked);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    release_block(header, block);
+    *block = repacked;
+
+    return OK;
+}
+
+operation_result packed_push_back(packed_vector_header *const header, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    ptrdiff_t tail_count = get_tail_count(header);
+    header->tail[tail_count] = value;
+
+    if (tail_count < PACKED_BLOCK_SIZE - 1)
+    {
+        header->size++;
+        return OK;
+    }
+
+    // value completes the tail, which becomes the next block
+    operation_result result = header->block_count == header->block_capacity ? grow_blocks(header) : OK;
+    if (result != OK)
+    {
+        return result;
+    }
+
+    result = pack_block(header->allocator, header->tail, &header->blocks[header->block_count]);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    header->block_count++;
+    header->size++;
+
+    return OK;
+}
+
+// Popping into an empty tail unpacks the last block back into it, so the
+// next PACKED_BLOCK_SIZE pops and pushes are plain loads and stores
+operation_result packed_pop_back(packed_vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (header->size == 0)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    if (get_tail_count(header) == 0)
+    {
+        packed_block *last = &header->blocks[--header->block_count];
+
+        decode_block(last, header->tail);
+        release_block(header, last);
+    }
+
+    header->size--;
+    return OK;
+}
+
+ptrdiff_t packed_get_size(const packed_vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    return header->size;
+}
+
+size_t packed_get_memory(const packed_vector_header *const header)
+{
+    if (header == NULL || is_invalid(header))
+    {
+        return 0;
+    }
+
+    size_t memory = header->block_capacity * sizeof(packed_block) + PACKED_BLOCK_SIZE * sizeof(long);
+
+    for (ptrdiff_t i = 0; i < header->block_count; ++i)
+    {
+        memory += get_words_size(header->blocks[i].bit_width);
+    }
+
+    return memory;
+}
+
+static operation_result check(const packed_vector_header *const header, const void *const result)
+{
+    if (header == NULL || result == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return is_invalid(header) ? ERR_INVALID_HEADER : OK;
+}
+
+operation_result packed_decode(const packed_vector_header *const header, const ptrdiff_t index, const ptrdiff_t count, long *const values)
+{
+    operation_result result = check(header, values);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    if (index < 0 || count < 0 || index > header->size - count)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    long buffer[PACKED_BLOCK_SIZE];
+    ptrdiff_t done = 0;
+
+    while (done < count)
+    {
+        ptrdiff_t block = (index + done) / PACKED_BLOCK_SIZE;
+        ptrdiff_t position = (index + done) % PACKED_BLOCK_SIZE;
+        ptrdiff_t length = PACKED_BLOCK_SIZE - position < count - done ? PACKED_BLOCK_SIZE - position : count - done;
+
+        if (block == header->block_count)
+        {
+            memcpy(values + done, header->tail + position, length * sizeof(long));
+        }
+        else if (length == PACKED_BLOCK_SIZE)
+        {
+            decode_block(&header->blocks[block], values + done);
+        }
+        else
+        {
+            decode_block(&header->blocks[block], buffer);
+            memcpy(values + done, buffer + position, length * sizeof(long));
+        }
+
+        done += length;
+    }
+
+    return OK;
+}
+
+operation_result packed_find(const packed_vector_header *const header, const long value, ptrdiff_t *const index)
+{
+    operation_result result = check(header, index);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    const search_kernels *kernels = get_search_kernels(get_simd_level());
+    long buffer[PACKED_BLOCK_SIZE];
+
+    for (ptrdiff_t i = 0; i < header->block_count; ++i)
+    {
+        if (!fits_block(&header->blocks[i], value))
+        {
+            continue;
+        }
+
+        decode_block(&header->blocks[i], buffer);
+        long position = kernels->find(buffer, PACKED_BLOCK_SIZE, value);
+
+        if (position >= 0)
+        {
+            *index = i * PACKED_BLOCK_SIZE + position;
+            return OK;
+        }
+    }
+
+    long position = kernels->find(header->tail, get_tail_count(header), value);
+    *index = position < 0 ? -1 : header->block_count * PACKED_BLOCK_SIZE + position;
+
+    return OK;
+}
+
+operation_result packed_count(const packed_vector_header *const header, const long value, ptrdiff_t *const count)
+{
+    operation_result result = check(header, count);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    const search_kernels *kernels = get_search_kernels(get_simd_level());
+    long buffer[PACKED_BLOCK_SIZE];
+    ptrdiff_t matches = 0;
+
+    for (ptrdiff_t i = 0; i < header->block_count; ++i)
+    {
+        if (fits_block(&header->blocks[i], value))
+        {
+            decode_block(&header->blocks[i], buffer);
+            matches += kernels->count(buffer, PACKED_BLOCK_SIZE, value);
+        }
+    }
+
+    *count = matches + kernels->count(header->tail, get_tail_count(header), value);
+    return OK;
+}
+
+// Wraps around on overflow like vector_sum
+operation_result packed_sum(const packed_vector_header *const header, long *const sum)
+{
+    operation_result result = check(header, sum);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    const search_kernels *kernels = get_search_kernels(get_simd_level());
+    long buffer[PACKED_BLOCK_SIZE];
+    uint64_t total = (uint64_t)kernels->sum(header->tail, get_tail_count(header));
+
+    for (ptrdiff_t i = 0; i < header->block_count; ++i)
+    {
+        decode_block(&header->blocks[i], buffer);
+        total += (uint64_t)kernels->sum(buffer, PACKED_BLOCK_SIZE);
+    }
+
+    *sum = (long)total;
+    return OK;
+}
@@ -0,0 +1,511 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include "../include/search/header.h"
+#include "../include/search/operations.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define HAS_X86_KERNELS 1
+#endif
+
+static long scalar_find(const long *values, long count, long value)
+{
+    for (long i = 0; i < count; ++i)
+    {
+        if (values[i] == value)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static long scalar_count(const long *values, long count, long value)
+{
+    long matches = 0;
+
+    for (long i = 0; i < count; ++i)
+    {
+        matches += values[i] == value;
+    }
+
+    return matches;
+}
+
+static long scalar_sum(const long *values, long count)
+{
+    unsigned long sum = 0;
+
+    for (long i = 0; i < count; ++i)
+    {
+        sum += (unsigned long)values[i];
+    }
+
+    return (long)sum;
+}
+
+static long scalar_min(const long *values, long count)
+{
+    long min = values[0];
+
+    for (long i = 1; i < count; ++i)
+    {
+        min = values[i] < min ? values[i] : min;
+    }
+
+    return min;
+}
+
+static long scalar_max(const long *values, long count)
+{
+    long max = values[0];
+
+    for (long i = 1; i < count; ++i)
+    {
+        max = values[i] > max ? values[i] : max;
+    }
+
+    return max;
+}
+
+#ifdef HAS_X86_KERNELS
+
+// SSE2 has no 64-bit compares, so they are built from 32-bit ones
+static __m128i sse2_cmpeq_epi64(const __m128i a, const __m128i b)
+{
+    __m128i equal = _mm_cmpeq_epi32(a, b);
+
+    return _mm_and_si128(equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(2, 3, 0, 1)));
+}
+
+// High halves decide, unless they are equal and the borrow of b - a does
+static __m128i sse2_cmpgt_epi64(const __m128i a, const __m128i b)
+{
+    __m128i greater = _mm_or_si128(_mm_and_si128(_mm_cmpeq_epi32(a, b), _mm_sub_epi64(b, a)),
+                                   _mm_cmpgt_epi32(a, b));
+
+    return _mm_shuffle_epi32(greater, _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+static __m128i sse2_select(const __m128i mask, const __m128i a, const __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static long sse2_find(const long *values, long count, long value)
+{
+    __m128i key = _mm_set1_epi64x(value);
+    long i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i first = sse2_cmpeq_epi64(_mm_loadu_si128((const __m128i *)(values + i)), key);
+        __m128i second = sse2_cmpeq_epi64(_mm_loadu_si128((const __m128i *)(values + i + 2)), key);
+
+        if (_mm_movemask_epi8(_mm_or_si128(first, second)) != 0)
+        {
+            break;
+        }
+    }
+
+    long found = scalar_find(values + i, count - i, value);
+    return found < 0 ? -1 : i + found;
+}
+
+static long sse2_count(const long *values, long count, long value)
+{
+    __m128i key = _mm_set1_epi64x(value);
+    __m128i matches = _mm_setzero_si128();
+    long i = 0;
+
+    // every match adds -1 to its lane
+    for (; i + 2 <= count; i += 2)
+    {
+        matches = _mm_add_epi64(matches, sse2_cmpeq_epi64(_mm_loadu_si128((const __m128i *)(values + i)), key));
+    }
+
+    long lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, matches);
+
+    return -(lanes[0] + lanes[1]) + scalar_count(values + i, count - i, value);
+}
+
+static long sse2_sum(const long *values, long count)
+{
+    __m128i first = _mm_setzero_si128();
+    __m128i second = _mm_setzero_si128();
+    long i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        first = _mm_add_epi64(first, _mm_loadu_si128((const __m128i *)(values + i)));
+        second = _mm_add_epi64(second, _mm_loadu_si128((const __m128i *)(values + i + 2)));
+    }
+
+    unsigned long lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, _mm_add_epi64(first, second));
+
+    return (long)(lanes[0] + lanes[1] + (unsigned long)scalar_sum(values + i, count - i));
+}
+
+static long sse2_min(const long *values, long count)
+{
+    if (count < 2)
+    {
+        return scalar_min(values, count);
+    }
+
+    __m128i min = _mm_loadu_si128((const __m128i *)values);
+    long i = 2;
+
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128i next = _mm_loadu_si128((const __m128i *)(values + i));
+        min = sse2_select(sse2_cmpgt_epi64(min, next), next, min);
+    }
+
+    long lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, min);
+
+    long result = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+    for (; i < count; ++i)
+    {
+        result = values[i] < result ? values[i] : result;
+    }
+
+    return result;
+}
+
+static long sse2_max(const long *values, long count)
+{
+    if (count < 2)
+    {
+        return scalar_max(values, count);
+    }
+
+    __m128i max = _mm_loadu_si128((const __m128i *)values);
+    long i = 2;
+
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128i next = _mm_loadu_si128((const __m128i *)(values + i));
+        max = sse2_select(sse2_cmpgt_epi64(next, max), next, max);
+    }
+
+    long lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, max);
+
+    long result = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+    for (; i < count; ++i)
+    {
+        result = values[i] > result ? values[i] : result;
+    }
+
+    return result;
+}
+
+__attribute__((target("avx2"))) static long avx2_find(const long *values, long count, long value)
+{
+    __m256i key = _mm256_set1_epi64x(value);
+    long i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i first = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(values + i)), key);
+        __m256i second = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(values + i + 4)), key);
+
+        if (!_mm256_testz_si256(_mm256_or_si256(first, second), _mm256_or_si256(first, second)))
+        {
+            break;
+        }
+    }
+
+    long found = scalar_find(values + i, count - i, value);
+    return found < 0 ? -1 : i + found;
+}
+
+__attribute__((target("avx2"))) static long avx2_count(const long *values, long count, long value)
+{
+    __m256i key = _mm256_set1_epi64x(value);
+    __m256i matches = _mm256_setzero_si256();
+    long i = 0;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        matches = _mm256_add_epi64(matches, _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(values + i)), key));
+    }
+
+    long lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, matches);
+
+    return -(lanes[0] + lanes[1] + lanes[2] + lanes[3]) + scalar_count(values + i, count - i, value);
+}
+
+__attribute__((target("avx2"))) static long avx2_sum(const long *values, long count)
+{
+    __m256i first = _mm256_setzero_si256();
+    __m256i second = _mm256_setzero_si256();
+    long i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        first = _mm256_add_epi64(first, _mm256_loadu_si256((const __m256i *)(values + i)));
+        second = _mm256_add_epi64(second, _mm256_loadu_si256((const __m256i *)(values + i + 4)));
+    }
+
+    unsigned long lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, _mm256_add_epi64(first, second));
+
+    return (long)(lanes[0] + lanes[1] + lanes[2] + lanes[3] + (unsigned long)scalar_sum(values + i, count - i));
+}
+
+__attribute__((target("avx2"))) static long avx2_min(const long *values, long count)
+{
+    if (count < 4)
+    {
+        return scalar_min(values, count);
+    }
+
+    __m256i min = _mm256_loadu_si256((const __m256i *)values);
+    long i = 4;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i next = _mm256_loadu_si256((const __m256i *)(values + i));
+        min = _mm256_blendv_epi8(min, next, _mm256_cmpgt_epi64(min, next));
+    }
+
+    long lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, min);
+
+    long result = scalar_min(lanes, 4);
+    for (; i < count; ++i)
+    {
+        result = values[i] < result ? values[i] : result;
+    }
+
+    return result;
+}
+
+__attribute__((target("avx2"))) static long avx2_max(const long *values, long count)
+{
+    if (count < 4)
+    {
+        return scalar_max(values, count);
+    }
+
+    __m256i max = _mm256_loadu_si256((const __m256i *)values);
+    long i = 4;
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256i next = _mm256_loadu_si256((const __m256i *)(values + i));
+        max = _mm256_blendv_epi8(max, next, _mm256_cmpgt_epi64(next, max));
+    }
+
+    long lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, max);
+
+    long result = scalar_max(lanes, 4);
+    for (; i < count; ++i)
+    {
+        result = values[i] > result ? values[i] : result;
+    }
+
+    return result;
+}
+
+__attribute__((target("avx512f"))) static long avx512_find(const long *values, long count, long value)
+{
+    __m512i key = _mm512_set1_epi64(value);
+    long i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        __mmask8 matches = _mm512_cmpeq_epi64_mask(_mm512_loadu_si512(values + i), key);
+
+        if (matches != 0)
+        {
+            return i + __builtin_ctz(matches);
+        }
+    }
+
+    long found = scalar_find(values + i, count - i, value);
+    return found < 0 ? -1 : i + found;
+}
+
+__attribute__((target("avx512f"))) static long avx512_count(const long *values, long count, long value)
+{
+    __m512i key = _mm512_set1_epi64(value);
+    long matches = 0;
+    long i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        matches += __builtin_popcount(_mm512_cmpeq_epi64_mask(_mm512_loadu_si512(values + i), key));
+    }
+
+    return matches + scalar_count(values + i, count - i, value);
+}
+
+__attribute__((target("avx512f"))) static long avx512_sum(const long *values, long count)
+{
+    __m512i first = _mm512_setzero_si512();
+    __m512i second = _mm512_setzero_si512();
+    long i = 0;
+
+    for (; i + 16 <= count; i += 16)
+    {
+        first = _mm512_add_epi64(first, _mm512_loadu_si512(values + i));
+        second = _mm512_add_epi64(second, _mm512_loadu_si512(values + i + 8));
+    }
+
+    unsigned long lanes[8];
+    _mm512_storeu_si512(lanes, _mm512_add_epi64(first, second));
+
+    unsigned long sum = (unsigned long)scalar_sum(values + i, count - i);
+    for (int lane = 0; lane < 8; ++lane)
+    {
+        sum += lanes[lane];
+    }
+
+    return (long)sum;
+}
+
+__attribute__((target("avx512f"))) static long avx512_min(const long *values, long count)
+{
+    if (count < 8)
+    {
+        return scalar_min(values, count);
+    }
+
+    __m512i min = _mm512_loadu_si512(values);
+    long i = 8;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        min = _mm512_min_epi64(min, _mm512_loadu_si512(values + i));
+    }
+
+    long lanes[8];
+    _mm512_storeu_si512(lanes, min);
+
+    long result = scalar_min(lanes, 8);
+    for (; i < count; ++i)
+    {
+        result = values[i] < result ? values[i] : result;
+    }
+
+    return result;
+}
+
+__attribute__((target("avx512f"))) static long avx512_max(const long *values, long count)
+{
+    if (count < 8)
+    {
+        return scalar_max(values, count);
+    }
+
+    __m512i max = _mm512_loadu_si512(values);
+    long i = 8;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        max = _mm512_max_epi64(max, _mm512_loadu_si512(values + i));
+    }
+
+    long lanes[8];
+    _mm512_storeu_si512(lanes, max);
+
+    long result = scalar_max(lanes, 8);
+    for (; i < count; ++i)
+    {
+        result = values[i] > result ? values[i] : result;
+    }
+
+    return result;
+}
+
+#endif
+
+static const search_kernels kernels[] = {
+    {scalar_find, scalar_count, scalar_sum, scalar_min, scalar_max},
+#ifdef HAS_X86_KERNELS
+    {sse2_find, sse2_count, sse2_sum, sse2_min, sse2_max},
+    {avx2_find, avx2_count, avx2_sum, avx2_min, avx2_max},
+    {avx512_find, avx512_count, avx512_sum, avx512_min, avx512_max},
+#endif
+};
+
+static simd_level detect_level(void)
+{
+#ifdef HAS_X86_KERNELS
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return SIMD_AVX512;
+    }
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return SIMD_AVX2;
+    }
+
+    // part of the x86-64 baseline
+    return SIMD_SSE2;
+#else
+    return SIMD_SCALAR;
+#endif
+}
+
+static simd_level supported_level = SIMD_SCALAR;
+static pthread_once_t detected = PTHREAD_ONCE_INIT;
+// kernels run on many threads at once, and set_simd_level() may race with them
+static _Atomic simd_level active_level = SIMD_SCALAR;
+
+static void detect_once(void)
+{
+    supported_level = detect_level();
+    atomic_store_explicit(&active_level, supported_level, memory_order_relaxed);
+}
+
+// pthread_once orders supported_level before every caller that returns from it
+static void detect(void)
+{
+    pthread_once(&detected, detect_once);
+}
+
+simd_level get_simd_level(void)
+{
+    detect();
+    return atomic_load_explicit(&active_level, memory_order_relaxed);
+}
+
+operation_result set_simd_level(const simd_level level)
+{
+    detect();
+
+    if (level < SIMD_SCALAR || level > supported_level)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    atomic_store_explicit(&active_level, level, memory_order_relaxed);
+    return OK;
+}
+
+// NULL for levels the CPU doesn't support
+const search_kernels *get_search_kernels(const simd_level level)
+{
+    detect();
+
+    if (level < SIMD_SCALAR || level > supported_level)
+    {
+        return NULL;
+    }
+
+    return &kernels[level];
+}
@@ -0,0 +1,164 @@
+#include <stddef.h>
+#include "../include/search/header.h"
+#include "../include/search/operations.h"
+
+static const search_kernels *active_kernels(void)
+{
+    return get_search_kernels(get_simd_level());
+}
+
+static operation_result check(const vector_header *const header, const void *const result)
+{
+    if (header == NULL || result == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return header->is_allocated ? OK : ERR_INVALID_HEADER;
+}
+
+operation_result vector_find(const vector_header *const header, const long value, ptrdiff_t *const index)
+{
+    operation_result result = check(header, index);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    *index = active_kernels()->find(header->start_address, header->size, value);
+    return OK;
+}
+
+operation_result vector_count(const vector_header *const header, const long value, ptrdiff_t *const count)
+{
+    operation_result result = check(header, count);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    *count = active_kernels()->count(header->start_address, header->size, value);
+    return OK;
+}
+
+operation_result vector_contains(const vector_header *const header, const long value, int *const found)
+{
+    if (found == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    ptrdiff_t index;
+    operation_result result = vector_find(header, value, &index);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    *found = index >= 0;
+    return OK;
+}
+
+operation_result vector_sum(const vector_header *const header, long *const sum)
+{
+    operation_result result = check(header, sum);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    *sum = active_kernels()->sum(header->start_address, header->size);
+    return OK;
+}
+
+operation_result vector_min(const vector_header *const header, long *const min)
+{
+    operation_result result = check(header, min);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    if (header->size == 0)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    *min = active_kernels()->min(header->start_address, header->size);
+    return OK;
+}
+
+operation_result vector_max(const vector_header *const header, long *const max)
+{
+    operation_result result = check(header, max);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    if (header->size == 0)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    *max = active_kernels()->max(header->start_address, header->size);
+    return OK;
+}
+
+// Two passes, the minimum and then its first position, both at full vector width
+operation_result vector_argmin(const vector_header *const header, ptrdiff_t *const index)
+{
+    if (index == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    long min;
+    operation_result result = vector_min(header, &min);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    *index = active_kernels()->find(header->start_address, header->size, min);
+    return OK;
+}
+
+// current_vector holds every element whatever migration is doing, while
+// next_vector only holds a copy of a prefix, so scanning current_vector alone
+// covers both halves exactly once
+
+operation_result deamortized_find(const deamortized_vector_header *const header, const long value, ptrdiff_t *const index)
+{
+    return header == NULL ? ERR_NULL : vector_find(&header->current_vector, value, index);
+}
+
+operation_result deamortized_count(const deamortized_vector_header *const header, const long value, ptrdiff_t *const count)
+{
+    return header == NULL ? ERR_NULL : vector_count(&header->current_vector, value, count);
+}
+
+operation_result deamortized_contains(const deamortized_vector_header *const header, const long value, int *const found)
+{
+    return header == NULL ? ERR_NULL : vector_contains(&header->current_vector, value, found);
+}
+
+operation_result deamortized_sum(const deamortized_vector_header *const header, long *const sum)
+{
+    return header == NULL ? ERR_NULL : vector_sum(&header->current_vector, sum);
+}
+
+operation_result deamortized_min(const deamortized_vector_header *const header, long *const min)
+{
+    return header == NULL ? ERR_NULL : vector_min(&header->current_vector, min);
+}
+
+operation_result deamortized_max(const deamortized_vector_header *const header, long *const max)
+{
+    return header == NULL ? ERR_NULL : vector_max(&header->current_vector, max);
+}
+
+operation_result deamortized_argmin(const deamortized_vector_header *const header, ptrdiff_t *const index)
+{
+    return header == NULL ? ERR_NULL : vector_argmin(&header->current_vector, index);
+}
@@ -0,0 +1,238 @@
+#include <limits.h>
+#include <stdbool.h>
+#include "../include/segmented_vector/header.h"
+#include "../include/segmented_vector/operations.h"
+#include "../include/allocator/operations.h"
+
+static int is_invalid(const segmented_vector_header *const header)
+{
+    return !header->is_allocated;
+}
+
+static long get_block_length(const int block)
+{
+    return 1L << (FIRST_BLOCK_SHIFT + block);
+}
+
+// Elements held by the first block_count blocks
+static long get_capacity(const int block_count)
+{
+    return (1L << (FIRST_BLOCK_SHIFT + block_count)) - (1L << FIRST_BLOCK_SHIFT);
+}
+
+// One clz instead of a search through the directory
+static long *get_address(const segmented_vector_header *const header, const int index)
+{
+    unsigned long position = (unsigned long)index + (1UL << FIRST_BLOCK_SHIFT);
+    int msb = 63 - __builtin_clzl(position);
+
+    return header->blocks[msb - FIRST_BLOCK_SHIFT] + (position - (1UL << msb));
+}
+
+static operation_result add_block(segmented_vector_header *const header)
+{
+    if (header->block_count == SEGMENTED_BLOCKS)
+    {
+        return ERR_INVALID_CAPACITY;
+    }
+
+    long *block = allocator_allocate(header->allocator, get_block_length(header->block_count) * sizeof(long));
+
+    if (block == NULL)
+    {
+        return ERR_MALLOC_FAILED;
+    }
+
+    header->blocks[header->block_count++] = block;
+    return OK;
+}
+
+static void release_block(segmented_vector_header *const header)
+{
+    int block = --header->block_count;
+
+    allocator_release(header->allocator, header->blocks[block], get_block_length(block) * sizeof(long));
+    header->blocks[block] = NULL;
+}
+
+segmented_vector_header init_segmented_vector(const int capacity)
+{
+    return init_segmented_vector_with_allocator(capacity, NULL);
+}
+
+segmented_vector_header init_segmented_vector_with_allocator(const int capacity, const vector_allocator *const allocator)
+{
+    segmented_vector_header header = {0};
+    header.allocator = allocator;
+
+    // the first block even for capacity 0, so push_back on a new vector never allocates
+    do
+    {
+        if (add_block(&header) != OK)
+        {
+            while (header.block_count > 0)
+            {
+                release_block(&header);
+            }
+
+            return header;
+        }
+    } while (get_capacity(header.block_count) < capacity);
+
+    header.is_allocated = true;
+    return header;
+}
+
+operation_result free_segmented_vector(segmented_vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    while (header->block_count > 0)
+    {
+        release_block(header);
+    }
+
+    header->is_allocated = false;
+    header->size = 0;
+
+    return OK;
+}
+
+long segmented_get(const segmented_vector_header *const header, const int index)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (index < 0 || index >= header->size)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    return *get_address(header, index);
+}
+
+operation_result segmented_set(segmented_vector_header *const header, const int index, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (index < 0 || index >= header->size)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    *get_address(header, index) = value;
+    return OK;
+}
+
+operation_result segmented_push_back(segmented_vector_header *const header, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (header->size == INT_MAX)
+    {
+        return ERR_INVALID_CAPACITY;
+    }
+
+    if (header->size == get_capacity(header->block_count))
+    {
+        operation_result result = add_block(header);
+        if (result != OK)
+        {
+            return result;
+        }
+    }
+
+    *get_address(header, header->size++) = value;
+    return OK;
+}
+
+// The last block is only released once the one before it is empty too, so
+// pushing and popping around a block boundary never thrashes the allocator
+operation_result segmented_pop_back(segmented_vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (header->size == 0)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    --header->size;
+
+    if (header->block_count > 1 && header->size <= get_capacity(header->block_count - 2))
+    {
+        release_block(header);
+    }
+
+    return OK;
+}
+
+int segmented_get_size(const segmented_vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return header->size;
+}
+
+operation_result segmented_get_address(const segmented_vector_header *const header, const int index, long **const address)
+{
+    if (header == NULL || address == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (index < 0 || index >= header->size)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    *address = get_address(header, index);
+    return OK;
+}
@@ -0,0 +1,419 @@
+#include <stdbool.h>
+#include <string.h>
+#include "../include/small_vector/header.h"
+#include "../include/small_vector/operations.h"
+#include "../include/vector/operations.h"
+#include "../include/deamortized_vector/operations.h"
+
+static long inline_get(const long *const elements, const int size, const ptrdiff_t index)
+{
+    if (index < 0 || index >= size)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    return elements[index];
+}
+
+static operation_result inline_set(long *const elements, const int size, const ptrdiff_t index, const long value)
+{
+    if (index < 0 || index >= size)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    elements[index] = value;
+    return OK;
+}
+
+// index must be within [0, size] and there must be room for one more
+static void inline_insert(long *const elements, int *const size, const ptrdiff_t index, const long value)
+{
+    memmove(elements + index + 1, elements + index, (*size - index) * sizeof(long));
+    elements[index] = value;
+    ++*size;
+}
+
+static operation_result inline_erase(long *const elements, int *const size, const ptrdiff_t index)
+{
+    if (index < 0 || index >= *size)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    memmove(elements + index, elements + index + 1, (*size - index - 1) * sizeof(long));
+    --*size;
+
+    return OK;
+}
+
+// The heap vector starts with room for twice the inline elements, or rather
+// MIN_CAPACITY, and grows by itself from there
+static operation_result spill(small_vector_header *const header)
+{
+    vector_header heap = init_vector_with_allocator(2 * SMALL_VECTOR_CAPACITY, header->allocator);
+
+    if (!heap.is_allocated)
+    {
+        return ERR_MALLOC_FAILED;
+    }
+
+    // copied out before the union switches over to heap
+    memcpy(heap.start_address, header->storage.elements, header->size * sizeof(long));
+    heap.size = header->size;
+
+    header->storage.heap = heap;
+    header->is_spilled = true;
+    header->size = 0;
+
+    return OK;
+}
+
+small_vector_header init_small_vector(void)
+{
+    return init_small_vector_with_allocator(NULL);
+}
+
+small_vector_header init_small_vector_with_allocator(const vector_allocator *const allocator)
+{
+    small_vector_header header = {0};
+
+    header.is_allocated = true;
+    header.allocator = allocator;
+
+    return header;
+}
+
+operation_result free_small_vector(small_vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (!header->is_allocated)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    operation_result result = header->is_spilled ? free_vector(&header->storage.heap) : OK;
+
+    header->is_allocated = false;
+    header->is_spilled = false;
+    header->size = 0;
+
+    return result;
+}
+
+long small_get(const small_vector_header *const header, const ptrdiff_t index)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (!header->is_allocated)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (header->is_spilled)
+    {
+        return get(&header->storage.heap, index);
+    }
+
+    return inline_get(header->storage.elements, header->size, index);
+}
+
+operation_result small_set(small_vector_header *const header, const ptrdiff_t index, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (!header->is_allocated)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (header->is_spilled)
+    {
+        return set(&header->storage.heap, index, value);
+    }
+
+    return inline_set(header->storage.elements, header->size, index, value);
+}
+
+operation_result small_insert(small_vector_header *const header, const ptrdiff_t index, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (!header->is_allocated)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (!header->is_spilled && (index < 0 || index > header->size))
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    if (!header->is_spilled && header->size == SMALL_VECTOR_CAPACITY)
+    {
+        operation_result result = spill(header);
+        if (result != OK)
+        {
+            return result;
+        }
+    }
+
+    if (header->is_spilled)
+    {
+        return insert(&header->storage.heap, index, value);
+    }
+
+    inline_insert(header->storage.elements, &header->size, index, value);
+    return OK;
+}
+
+operation_result small_push_back(small_vector_header *const header, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return small_insert(header, small_get_size(header), value);
+}
+
+// A spilled vector stays on the heap, where auto_shrink takes care of it
+operation_result small_erase(small_vector_header *const header, const ptrdiff_t index)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (!header->is_allocated)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (header->is_spilled)
+    {
+        return erase(&header->storage.heap, index);
+    }
+
+    return inline_erase(header->storage.elements, &header->size, index);
+}
+
+operation_result small_pop_back(small_vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return small_erase(header, small_get_size(header) - 1);
+}
+
+ptrdiff_t small_get_size(const small_vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return header->is_spilled ? header->storage.heap.size : header->size;
+}
+
+// Spilling appends the inline elements into a fresh deamortized vector of
+// MIN_CAPACITY. That is under its growth threshold, so no next_vector is
+// allocated and migration only starts once the spilled vector fills up.
+static operation_result spill_deamortized(small_deamortized_vector_header *const header)
+{
+    deamortized_vector_header heap = init_deamortized_vector_with_allocator(2 * SMALL_VECTOR_CAPACITY, header->allocator);
+
+    if (!heap.current_vector.is_allocated)
+    {
+        return ERR_MALLOC_FAILED;
+    }
+
+    operation_result result = deamortized_append_array(&heap, header->storage.elements, header->size);
+    if (result != OK)
+    {
+        free_deamortized_vector(&heap);
+        return result;
+    }
+
+    header->storage.heap = heap;
+    header->is_spilled = true;
+    header->size = 0;
+
+    return OK;
+}
+
+small_deamortized_vector_header init_small_deamortized_vector(void)
+{
+    return init_small_deamortized_vector_with_allocator(NULL);
+}
+
+small_deamortized_vector_header init_small_deamortized_vector_with_allocator(const vector_allocator *const allocator)
+{
+    small_deamortized_vector_header header = {0};
+
+    header.is_allocated = true;
+    header.allocator = allocator;
+
+    return header;
+}
+
+operation_result free_small_deamortized_vector(small_deamortized_vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (!header->is_allocated)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    operation_result result = header->is_spilled ? free_deamortized_vector(&header->storage.heap) : OK;
+
+    header->is_allocated = false;
+    header->is_spilled = false;
+    header->size = 0;
+
+    return result;
+}
+
+long small_deamortized_get(const small_deamortized_vector_header *const header, const ptrdiff_t index)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (!header->is_allocated)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (header->is_spilled)
+    {
+        return deamortized_get(&header->storage.heap, index);
+    }
+
+    return inline_get(header->storage.elements, header->size, index);
+}
+
+operation_result small_deamortized_set(small_deamortized_vector_header *const header, const ptrdiff_t index, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (!header->is_allocated)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (header->is_spilled)
+    {
+        return deamortized_set(&header->storage.heap, index, value);
+    }
+
+    return inline_set(header->storage.elements, header->size, index, value);
+}
+
+operation_result small_deamortized_insert(small_deamortized_vector_header *const header, const ptrdiff_t index, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (!header->is_allocated)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (!header->is_spilled && (index < 0 || index > header->size))
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    if (!header->is_spilled && header->size == SMALL_VECTOR_CAPACITY)
+    {
+        operation_result result = spill_deamortized(header);
+        if (result != OK)
+        {
+            return result;
+        }
+    }
+
+    if (header->is_spilled)
+    {
+        return deamortized_insert(&header->storage.heap, index, value);
+    }
+
+    inline_insert(header->storage.elements, &header->size, index, value);
+    return OK;
+}
+
+operation_result small_deamortized_push_back(small_deamortized_vector_header *const header, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return small_deamortized_insert(header, small_deamortized_get_size(header), value);
+}
+
+operation_result small_deamortized_erase(small_deamortized_vector_header *const header, const ptrdiff_t index)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (!header->is_allocated)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (header->is_spilled)
+    {
+        return deamortized_erase(&header->storage.heap, index);
+    }
+
+    return inline_erase(header->storage.elements, &header->size, index);
+}
+
+operation_result small_deamortized_pop_back(small_deamortized_vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return small_deamortized_erase(header, small_deamortized_get_size(header) - 1);
+}
+
+ptrdiff_t small_deamortized_get_size(const small_deamortized_vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return header->is_spilled ? get_size(&header->storage.heap) : header->size;
+}
@@ -0,0 +1,565 @@
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "../include/snapshot/header.h"
+#include "../include/snapshot/operations.h"
+
+typedef struct snapshot_record
+{
+    vector_cow *cow;
+    cow_buffer *buffer;
+    char *address;
+    size_t length;
+    unsigned long generation;
+    // chunk slots mapped over this snapshot's view of the buffer
+    size_t *slots;
+    size_t slot_count;
+    size_t slot_capacity;
+    struct snapshot_record *next;
+} snapshot_record;
+
+static size_t round_to_chunks(const size_t size)
+{
+    size_t length = size == 0 ? 1 : size;
+
+    return (length + SNAPSHOT_CHUNK_SIZE - 1) & ~(SNAPSHOT_CHUNK_SIZE - 1);
+}
+
+// Released buffers are skipped: their old address may have been reused
+static cow_buffer *find_buffer(const vector_cow *const cow, const void *const address)
+{
+    for (cow_buffer *buffer = cow->buffers; buffer != NULL; buffer = buffer->next)
+    {
+        if (!buffer->is_released && buffer->address == address)
+        {
+            return buffer;
+        }
+    }
+
+    return NULL;
+}
+
+// Chunks the file gains can't be in any snapshot, so they count as already
+// copied out for the current generation
+static int grow_file(cow_buffer *const buffer, const size_t length)
+{
+    size_t old_chunks = buffer->file_length / SNAPSHOT_CHUNK_SIZE;
+    size_t new_chunks = length / SNAPSHOT_CHUNK_SIZE;
+
+    if (length <= buffer->file_length)
+    {
+        return 0;
+    }
+
+    if (new_chunks > buffer->chunk_count)
+    {
+        unsigned long *copied_at = realloc(buffer->copied_at, new_chunks * sizeof(unsigned long));
+        if (copied_at == NULL)
+        {
+            return -1;
+        }
+
+        buffer->copied_at = copied_at;
+        buffer->chunk_count = new_chunks;
+    }
+
+    if (ftruncate(buffer->fd, (off_t)length) != 0)
+    {
+        return -1;
+    }
+
+    for (size_t chunk = old_chunks; chunk < new_chunks; ++chunk)
+    {
+        buffer->copied_at[chunk] = buffer->generation;
+    }
+    buffer->file_length = length;
+
+    return 0;
+}
+
+// Gives back what the writer's mapping no longer covers, once no snapshot
+// maps it either
+static void trim_file(cow_buffer *const buffer)
+{
+    if (buffer->snapshots == NULL && buffer->file_length > buffer->length &&
+        ftruncate(buffer->fd, (off_t)buffer->length) == 0)
+    {
+        buffer->file_length = buffer->length;
+    }
+}
+
+static void destroy_buffer(vector_cow *const cow, cow_buffer *const buffer)
+{
+    cow_buffer **link = &cow->buffers;
+    while (*link != buffer)
+    {
+        link = &(*link)->next;
+    }
+    *link = buffer->next;
+
+    close(buffer->fd);
+    free(buffer->copied_at);
+    free(buffer);
+}
+
+static int take_slot(vector_cow *const cow, size_t *const slot)
+{
+    if (cow->free_count > 0)
+    {
+        *slot = cow->free_slots[--cow->free_count];
+        return 0;
+    }
+
+    if (cow->chunk_slots == cow->slot_capacity)
+    {
+        size_t capacity = cow->slot_capacity == 0 ? 16 : cow->slot_capacity * 2;
+        int *references = realloc(cow->chunk_references, capacity * sizeof(int));
+        if (references == NULL)
+        {
+            return -1;
+        }
+        cow->chunk_references = references;
+
+        size_t *free_slots = realloc(cow->free_slots, capacity * sizeof(size_t));
+        if (free_slots == NULL)
+        {
+            return -1;
+        }
+        cow->free_slots = free_slots;
+
+        if (ftruncate(cow->chunk_fd, (off_t)(capacity * SNAPSHOT_CHUNK_SIZE)) != 0)
+        {
+            return -1;
+        }
+        cow->slot_capacity = capacity;
+    }
+
+    *slot = cow->chunk_slots++;
+    cow->chunk_references[*slot] = 0;
+    return 0;
+}
+
+// The last snapshot mapping a slot hands its memory back to the system
+static void release_slot(vector_cow *const cow, const size_t slot)
+{
+    if (--cow->chunk_references[slot] > 0)
+    {
+        return;
+    }
+
+    fallocate(cow->chunk_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+              (off_t)(slot * SNAPSHOT_CHUNK_SIZE), (off_t)SNAPSHOT_CHUNK_SIZE);
+    cow->free_slots[cow->free_count++] = slot;
+}
+
+static int add_slot(snapshot_record *const record, const size_t slot)
+{
+    if (record->slot_count == record->slot_capacity)
+    {
+        size_t capacity = record->slot_capacity == 0 ? 4 : record->slot_capacity * 2;
+        size_t *slots = realloc(record->slots, capacity * sizeof(size_t));
+        if (slots == NULL)
+        {
+            return -1;
+        }
+
+        record->slots = slots;
+        record->slot_capacity = capacity;
+    }
+
+    record->slots[record->slot_count++] = slot;
+    return 0;
+}
+
+// A snapshot still sees the live chunk if it was taken after the chunk was
+// last copied out and its view reaches that far
+static int sees_live_chunk(const snapshot_record *const record, const unsigned long copied_at, const size_t offset)
+{
+    return record->generation > copied_at && offset < record->length;
+}
+
+// Copies the chunk once, then maps the copy over every snapshot that still
+// sees the live one. Their contents don't change, so readers never notice.
+static int copy_out(vector_cow *const cow, cow_buffer *const buffer, const size_t chunk)
+{
+    size_t offset = chunk * SNAPSHOT_CHUNK_SIZE;
+    unsigned long copied_at = buffer->copied_at[chunk];
+    int sharing = 0;
+
+    for (snapshot_record *record = buffer->snapshots; record != NULL; record = record->next)
+    {
+        sharing += sees_live_chunk(record, copied_at, offset);
+    }
+
+    if (sharing > 0)
+    {
+        size_t slot;
+        off_t slot_offset;
+
+        if (take_slot(cow, &slot) != 0)
+        {
+            return -1;
+        }
+
+        slot_offset = (off_t)(slot * SNAPSHOT_CHUNK_SIZE);
+        if (pwrite(cow->chunk_fd, buffer->address + offset, SNAPSHOT_CHUNK_SIZE, slot_offset) != (ssize_t)SNAPSHOT_CHUNK_SIZE)
+        {
+            cow->chunk_references[slot] = 1;
+            release_slot(cow, slot);
+            return -1;
+        }
+
+        // held until every mapping below is accounted for
+        cow->chunk_references[slot] = 1;
+
+        for (snapshot_record *record = buffer->snapshots; record != NULL; record = record->next)
+        {
+            if (!sees_live_chunk(record, copied_at, offset))
+            {
+                continue;
+            }
+
+            if (add_slot(record, slot) != 0)
+            {
+                release_slot(cow, slot);
+                return -1;
+            }
+
+            if (mmap(record->address + offset, SNAPSHOT_CHUNK_SIZE, PROT_READ, MAP_SHARED | MAP_FIXED,
+                     cow->chunk_fd, slot_offset) == MAP_FAILED)
+            {
+                --record->slot_count;
+                release_slot(cow, slot);
+                return -1;
+            }
+
+            ++cow->chunk_references[slot];
+        }
+
+        release_slot(cow, slot);
+        ++cow->chunks_copied;
+    }
+
+    buffer->copied_at[chunk] = buffer->generation;
+    return 0;
+}
+
+static void *cow_allocate(void *context, size_t size)
+{
+    vector_cow *cow = context;
+    size_t length = round_to_chunks(size);
+    cow_buffer *buffer = calloc(1, sizeof(cow_buffer));
+
+    if (buffer == NULL)
+    {
+        return NULL;
+    }
+
+    buffer->fd = memfd_create("vector_cow", MFD_CLOEXEC);
+    if (buffer->fd < 0 || grow_file(buffer, length) != 0)
+    {
+        if (buffer->fd >= 0)
+        {
+            close(buffer->fd);
+        }
+        free(buffer->copied_at);
+        free(buffer);
+        return NULL;
+    }
+
+    buffer->address = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, buffer->fd, 0);
+    if (buffer->address == MAP_FAILED)
+    {
+        close(buffer->fd);
+        free(buffer->copied_at);
+        free(buffer);
+        return NULL;
+    }
+    buffer->length = length;
+
+    pthread_mutex_lock(&cow->lock);
+    buffer->next = cow->buffers;
+    cow->buffers = buffer;
+    pthread_mutex_unlock(&cow->lock);
+
+    return buffer->address;
+}
+
+// The writer's mapping is a single range of one file, so it moves with mremap
+// without copying; snapshots keep their own mappings of the file
+static void *cow_reallocate(void *context, void *address, size_t old_size, size_t new_size)
+{
+    vector_cow *cow = context;
+    size_t length = round_to_chunks(new_size);
+    void *new_address = NULL;
+    (void)old_size;
+
+    pthread_mutex_lock(&cow->lock);
+    cow_buffer *buffer = find_buffer(cow, address);
+
+    if (buffer != NULL && grow_file(buffer, length) == 0)
+    {
+        new_address = mremap(buffer->address, buffer->length, length, MREMAP_MAYMOVE);
+
+        if (new_address == MAP_FAILED)
+        {
+            new_address = NULL;
+        }
+        else
+        {
+            buffer->address = new_address;
+            buffer->length = length;
+            trim_file(buffer);
+        }
+    }
+
+    pthread_mutex_unlock(&cow->lock);
+    return new_address;
+}
+
+static void cow_release(void *context, void *address, size_t size)
+{
+    vector_cow *cow = context;
+    (void)size;
+
+    pthread_mutex_lock(&cow->lock);
+    cow_buffer *buffer = find_buffer(cow, address);
+
+    if (buffer != NULL)
+    {
+        munmap(buffer->address, buffer->length);
+        buffer->is_released = true;
+
+        if (buffer->snapshots == NULL)
+        {
+            destroy_buffer(cow, buffer);
+        }
+    }
+
+    pthread_mutex_unlock(&cow->lock);
+}
+
+static int cow_prepare_write(void *context, void *address, size_t offset, size_t length)
+{
+    vector_cow *cow = context;
+    int result = 0;
+
+    if (length == 0 || atomic_load_explicit(&cow->snapshot_count, memory_order_acquire) == 0)
+    {
+        return 0;
+    }
+
+    pthread_mutex_lock(&cow->lock);
+    cow_buffer *buffer = find_buffer(cow, address);
+
+    if (buffer != NULL && buffer->snapshots != NULL)
+    {
+        size_t last = (offset + length - 1) / SNAPSHOT_CHUNK_SIZE;
+
+        for (size_t chunk = offset / SNAPSHOT_CHUNK_SIZE; chunk <= last && result == 0; ++chunk)
+        {
+            if (buffer->copied_at[chunk] != buffer->generation)
+            {
+                result = copy_out(cow, buffer, chunk);
+            }
+        }
+    }
+
+    pthread_mutex_unlock(&cow->lock);
+    return result;
+}
+
+vector_cow init_cow(void)
+{
+    vector_cow cow = {
+        PTHREAD_MUTEX_INITIALIZER,
+        NULL,
+        0,
+        memfd_create("vector_cow_chunks", MFD_CLOEXEC),
+        NULL,
+        0,
+        0,
+        NULL,
+        0,
+        0,
+        {cow_allocate, cow_reallocate, cow_release, cow_prepare_write, NULL}};
+
+    return cow;
+}
+
+operation_result free_cow(vector_cow *const cow)
+{
+    if (cow == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (cow->buffers != NULL)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (cow->chunk_fd >= 0)
+    {
+        close(cow->chunk_fd);
+    }
+
+    free(cow->chunk_references);
+    free(cow->free_slots);
+    pthread_mutex_destroy(&cow->lock);
+
+    cow->chunk_fd = -1;
+    cow->chunk_references = NULL;
+    cow->free_slots = NULL;
+    cow->chunk_slots = 0;
+    cow->slot_capacity = 0;
+    cow->free_count = 0;
+
+    return OK;
+}
+
+const vector_allocator *cow_allocator(vector_cow *const cow)
+{
+    cow->allocator.context = cow;
+    return &cow->allocator;
+}
+
+operation_result vector_snapshot(const vector_header *const header, snapshot_header *const snapshot)
+{
+    if (header == NULL || snapshot == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (!header->is_allocated || header->allocator == NULL || header->allocator->prepare_write != cow_prepare_write)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    vector_cow *cow = header->allocator->context;
+    snapshot_record *record = calloc(1, sizeof(snapshot_record));
+
+    if (record == NULL)
+    {
+        return ERR_MALLOC_FAILED;
+    }
+
+    pthread_mutex_lock(&cow->lock);
+    cow_buffer *buffer = find_buffer(cow, header->start_address);
+
+    if (buffer == NULL)
+    {
+        pthread_mutex_unlock(&cow->lock);
+        free(record);
+        return ERR_INVALID_HEADER;
+    }
+
+    // an empty vector has nothing to map
+    if (header->size > 0)
+    {
+        record->length = round_to_chunks(header->size * sizeof(long));
+        record->address = mmap(NULL, record->length, PROT_READ, MAP_SHARED, buffer->fd, 0);
+
+        if (record->address == MAP_FAILED)
+        {
+            pthread_mutex_unlock(&cow->lock);
+            free(record);
+            return ERR_MALLOC_FAILED;
+        }
+    }
+
+    record->cow = cow;
+    record->buffer = buffer;
+    record->generation = ++buffer->generation;
+    record->next = buffer->snapshots;
+    buffer->snapshots = record;
+    atomic_fetch_add_explicit(&cow->snapshot_count, 1, memory_order_release);
+
+    pthread_mutex_unlock(&cow->lock);
+
+    *snapshot = (snapshot_header){(const long *)record->address, header->size, record};
+    return OK;
+}
+
+operation_result deamortized_snapshot(const deamortized_vector_header *const header, snapshot_header *const snapshot)
+{
+    return header == NULL ? ERR_NULL : vector_snapshot(&header->current_vector, snapshot);
+}
+
+operation_result release_snapshot(snapshot_header *const snapshot)
+{
+    if (snapshot == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    snapshot_record *record = snapshot->record;
+    if (record == NULL)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    vector_cow *cow = record->cow;
+    cow_buffer *buffer = record->buffer;
+
+    pthread_mutex_lock(&cow->lock);
+
+    if (record->address != NULL)
+    {
+        munmap(record->address, record->length);
+    }
+
+    for (size_t i = 0; i < record->slot_count; ++i)
+    {
+        release_slot(cow, record->slots[i]);
+    }
+
+    snapshot_record **link = &buffer->snapshots;
+    while (*link != record)
+    {
+        link = &(*link)->next;
+    }
+    *link = record->next;
+    atomic_fetch_sub_explicit(&cow->snapshot_count, 1, memory_order_release);
+
+    if (buffer->snapshots == NULL && buffer->is_released)
+    {
+        destroy_buffer(cow, buffer);
+    }
+    else
+    {
+        trim_file(buffer);
+    }
+
+    pthread_mutex_unlock(&cow->lock);
+
+    free(record->slots);
+    free(record);
+    *snapshot = (snapshot_header){NULL, 0, NULL};
+
+    return OK;
+}
+
+long snapshot_get(const snapshot_header *const snapshot, const ptrdiff_t index)
+{
+    if (snapshot == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (snapshot->record == NULL)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (index < 0 || index >= snapshot->size)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    return snapshot->start_address[index];
+}
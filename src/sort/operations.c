@@ -0,0 +1,638 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/sort/header.h"
+#include "../include/sort/operations.h"
+#include "../include/vector/operations.h"
+
+#define INSERTION_SORT_SIZE 24
+#define NINTHER_SIZE 128
+#define PARTIAL_INSERTION_SORT_LIMIT 8
+#define MAX_DIGIT_BITS 11
+#define MAX_PASSES 8
+
+typedef struct
+{
+    char *base;
+    size_t size;
+    sort_compare compare;
+} sort_range;
+
+static char *element(const sort_range *const range, const ptrdiff_t index)
+{
+    return range->base + index * range->size;
+}
+
+static int less(const sort_range *const range, const ptrdiff_t left, const ptrdiff_t right)
+{
+    return range->compare(element(range, left), element(range, right)) < 0;
+}
+
+// A word at a time, which the usual 4- and 8-byte elements fit exactly
+static void swap_elements(const sort_range *const range, const ptrdiff_t left, const ptrdiff_t right)
+{
+    char *first = element(range, left);
+    char *second = element(range, right);
+    size_t done = 0;
+
+    for (; done + sizeof(uint64_t) <= range->size; done += sizeof(uint64_t))
+    {
+        uint64_t word;
+        memcpy(&word, first + done, sizeof(word));
+        memcpy(first + done, second + done, sizeof(word));
+        memcpy(second + done, &word, sizeof(word));
+    }
+
+    for (; done < range->size; ++done)
+    {
+        char byte = first[done];
+        first[done] = second[done];
+        second[done] = byte;
+    }
+}
+
+static void insertion_sort(const sort_range *const range, const ptrdiff_t begin, const ptrdiff_t end)
+{
+    for (ptrdiff_t i = begin + 1; i < end; ++i)
+    {
+        for (ptrdiff_t j = i; j > begin && less(range, j, j - 1); --j)
+        {
+            swap_elements(range, j, j - 1);
+        }
+    }
+}
+
+// Gives up once it has moved PARTIAL_INSERTION_SORT_LIMIT elements, which
+// means the range wasn't nearly sorted after all
+static int partial_insertion_sort(const sort_range *const range, const ptrdiff_t begin, const ptrdiff_t end)
+{
+    int moves = 0;
+
+    for (ptrdiff_t i = begin + 1; i < end; ++i)
+    {
+        for (ptrdiff_t j = i; j > begin && less(range, j, j - 1); --j)
+        {
+            if (++moves > PARTIAL_INSERTION_SORT_LIMIT)
+            {
+                return 0;
+            }
+
+            swap_elements(range, j, j - 1);
+        }
+    }
+
+    return 1;
+}
+
+static void sift_down(const sort_range *const range, const ptrdiff_t begin, ptrdiff_t root, const ptrdiff_t count)
+{
+    for (ptrdiff_t child = 2 * root + 1; child < count; child = 2 * root + 1)
+    {
+        if (child + 1 < count && less(range, begin + child, begin + child + 1))
+        {
+            ++child;
+        }
+
+        if (!less(range, begin + root, begin + child))
+        {
+            return;
+        }
+
+        swap_elements(range, begin + root, begin + child);
+        root = child;
+    }
+}
+
+// The fallback once partitioning has gone badly too often
+static void heap_sort(const sort_range *const range, const ptrdiff_t begin, const ptrdiff_t end)
+{
+    ptrdiff_t count = end - begin;
+
+    for (ptrdiff_t i = count / 2 - 1; i >= 0; --i)
+    {
+        sift_down(range, begin, i, count);
+    }
+
+    for (ptrdiff_t i = count - 1; i > 0; --i)
+    {
+        swap_elements(range, begin, begin + i);
+        sift_down(range, begin, 0, i);
+    }
+}
+
+static void sort3(const sort_range *const range, const ptrdiff_t a, const ptrdiff_t b, const ptrdiff_t c)
+{
+    if (less(range, b, a))
+    {
+        swap_elements(range, a, b);
+    }
+
+    if (less(range, c, b))
+    {
+        swap_elements(range, b, c);
+    }
+
+    if (less(range, b, a))
+    {
+        swap_elements(range, a, b);
+    }
+}
+
+// Leaves the median of three, or of three medians for larger ranges, at begin
+static void choose_pivot(const sort_range *const range, const ptrdiff_t begin, const ptrdiff_t end)
+{
+    ptrdiff_t middle = begin + (end - begin) / 2;
+
+    if (end - begin > NINTHER_SIZE)
+    {
+        sort3(range, begin, middle, end - 1);
+        sort3(range, begin + 1, middle - 1, end - 2);
+        sort3(range, begin + 2, middle + 1, end - 3);
+        sort3(range, middle - 1, middle, middle + 1);
+        swap_elements(range, begin, middle);
+    }
+    else
+    {
+        sort3(range, middle, begin, end - 1);
+    }
+}
+
+// Puts elements less than the pivot at begin before it and the rest after;
+// returns where the pivot ends up. Compares against the pivot in place.
+static ptrdiff_t partition_right(const sort_range *const range, const ptrdiff_t begin, const ptrdiff_t end,
+                                 int *const already_partitioned)
+{
+    ptrdiff_t first = begin + 1;
+    ptrdiff_t last = end - 1;
+
+    while (first <= last && less(range, first, begin))
+    {
+        ++first;
+    }
+
+    while (first <= last && !less(range, last, begin))
+    {
+        --last;
+    }
+
+    *already_partitioned = first > last;
+
+    while (first < last)
+    {
+        swap_elements(range, first++, last--);
+
+        while (first <= last && less(range, first, begin))
+        {
+            ++first;
+        }
+
+        while (first <= last && !less(range, last, begin))
+        {
+            --last;
+        }
+    }
+
+    swap_elements(range, begin, first - 1);
+    return first - 1;
+}
+
+// Puts elements equal to the pivot before it, for a pivot equal to the
+// element just left of the range: those are then already in place
+static ptrdiff_t partition_left(const sort_range *const range, const ptrdiff_t begin, const ptrdiff_t end)
+{
+    ptrdiff_t first = begin + 1;
+    ptrdiff_t last = end - 1;
+
+    while (first <= last && !less(range, begin, first))
+    {
+        ++first;
+    }
+
+    while (first <= last && less(range, begin, last))
+    {
+        --last;
+    }
+
+    while (first < last)
+    {
+        swap_elements(range, first++, last--);
+
+        while (first <= last && !less(range, begin, first))
+        {
+            ++first;
+        }
+
+        while (first <= last && less(range, begin, last))
+        {
+            --last;
+        }
+    }
+
+    swap_elements(range, begin, first - 1);
+    return first - 1;
+}
+
+// Swaps a few elements around after a lopsided partition, so inputs built to
+// defeat the pivot choice stop doing so
+static void break_patterns(const sort_range *const range, const ptrdiff_t begin, const ptrdiff_t end)
+{
+    ptrdiff_t count = end - begin;
+
+    if (count < INSERTION_SORT_SIZE)
+    {
+        return;
+    }
+
+    swap_elements(range, begin, begin + count / 4);
+    swap_elements(range, end - 1, end - count / 4);
+
+    if (count > NINTHER_SIZE)
+    {
+        swap_elements(range, begin + 1, begin + count / 4 + 1);
+        swap_elements(range, begin + 2, begin + count / 4 + 2);
+        swap_elements(range, end - 2, end - count / 4 - 1);
+        swap_elements(range, end - 3, end - count / 4 - 2);
+    }
+}
+
+static void pdq_sort(const sort_range *const range, ptrdiff_t begin, const ptrdiff_t end, int bad_allowed, int leftmost)
+{
+    while (end - begin >= INSERTION_SORT_SIZE)
+    {
+        ptrdiff_t count = end - begin;
+        choose_pivot(range, begin, end);
+
+        // everything here is at least the element before, so equal to the pivot means done
+        if (!leftmost && !less(range, begin - 1, begin))
+        {
+            begin = partition_left(range, begin, end) + 1;
+            continue;
+        }
+
+        int already_partitioned;
+        ptrdiff_t pivot = partition_right(range, begin, end, &already_partitioned);
+        ptrdiff_t left_count = pivot - begin;
+        ptrdiff_t right_count = end - pivot - 1;
+
+        if (left_count < count / 8 || right_count < count / 8)
+        {
+            if (--bad_allowed == 0)
+            {
+                heap_sort(range, begin, end);
+                return;
+            }
+
+            break_patterns(range, begin, pivot);
+            break_patterns(range, pivot + 1, end);
+        }
+        else if (already_partitioned &&
+                 partial_insertion_sort(range, begin, pivot) &&
+                 partial_insertion_sort(range, pivot + 1, end))
+        {
+            return;
+        }
+
+        pdq_sort(range, begin, pivot, bad_allowed, leftmost);
+        begin = pivot + 1;
+        leftmost = 0;
+    }
+
+    insertion_sort(range, begin, end);
+}
+
+void sort_elements(void *const base, const ptrdiff_t count, const size_t size, const sort_compare compare)
+{
+    if (base == NULL || compare == NULL || count < 2 || size == 0)
+    {
+        return;
+    }
+
+    sort_range range = {base, size, compare};
+    int bad_allowed = 1;
+
+    for (ptrdiff_t remaining = count; remaining > 1; remaining /= 2)
+    {
+        ++bad_allowed;
+    }
+
+    pdq_sort(&range, 0, count, bad_allowed, 1);
+}
+
+static int compare_longs(const void *left, const void *right)
+{
+    long first = *(const long *)left;
+    long second = *(const long *)right;
+
+    return (first > second) - (first < second);
+}
+
+// Flipping the sign bit orders signed keys as unsigned ones
+static unsigned get_digit(const long value, const int shift, const int bits)
+{
+    return (unsigned)((((uint64_t)value ^ (UINT64_C(1) << 63)) >> shift) & ((UINT64_C(1) << bits) - 1));
+}
+
+static int get_digit_bits(const ptrdiff_t count)
+{
+    return count >= RADIX_WIDE_DIGIT_SIZE ? MAX_DIGIT_BITS : 8;
+}
+
+// Counts every pass's digits in one read, then scatters back and forth
+// between values and scratch, skipping passes that would only copy
+static void radix_sort(long *const values, long *const scratch, const ptrdiff_t count, ptrdiff_t *const counts)
+{
+    int bits = get_digit_bits(count);
+    int passes = (64 + bits - 1) / bits;
+    ptrdiff_t radix = (ptrdiff_t)1 << bits;
+
+    for (ptrdiff_t i = 0; i < count; ++i)
+    {
+        for (int pass = 0; pass < passes; ++pass)
+        {
+            ++counts[pass * radix + get_digit(values[i], pass * bits, bits)];
+        }
+    }
+
+    long *source = values;
+    long *target = scratch;
+
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        ptrdiff_t *offsets = counts + pass * radix;
+
+        // one digit holding every element makes this pass a plain copy
+        if (offsets[get_digit(source[0], pass * bits, bits)] == count)
+        {
+            continue;
+        }
+
+        for (ptrdiff_t digit = 0, total = 0; digit < radix; ++digit)
+        {
+            ptrdiff_t digit_count = offsets[digit];
+            offsets[digit] = total;
+            total += digit_count;
+        }
+
+        for (ptrdiff_t i = 0; i < count; ++i)
+        {
+            target[offsets[get_digit(source[i], pass * bits, bits)]++] = source[i];
+        }
+
+        long *swap = source;
+        source = target;
+        target = swap;
+    }
+
+    if (source != values)
+    {
+        memcpy(values, source, count * sizeof(long));
+    }
+}
+
+// Room for count longs past the elements if capacity allows, else on the heap;
+// *owned tells the caller to free it
+static operation_result get_scratch(vector_header *const header, long **const scratch, int *const owned)
+{
+    if (header->capacity - header->size >= header->size)
+    {
+        *owned = 0;
+        *scratch = header->start_address + header->size;
+
+        return vector_prepare_write(header, header->size, header->size);
+    }
+
+    *owned = 1;
+    *scratch = malloc(header->size * sizeof(long));
+
+    return *scratch == NULL ? ERR_MALLOC_FAILED : OK;
+}
+
+static operation_result check(const vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return header->is_allocated ? OK : ERR_INVALID_HEADER;
+}
+
+operation_result vector_sort(vector_header *const header)
+{
+    operation_result result = check(header);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    if (header->size < RADIX_SORT_MIN_SIZE)
+    {
+        return vector_sort_by(header, compare_longs);
+    }
+
+    result = vector_prepare_write(header, 0, header->size);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    int bits = get_digit_bits(header->size);
+    ptrdiff_t *counts = calloc((size_t)MAX_PASSES << bits, sizeof(ptrdiff_t));
+    if (counts == NULL)
+    {
+        return ERR_MALLOC_FAILED;
+    }
+
+    long *scratch;
+    int owned;
+    result = get_scratch(header, &scratch, &owned);
+
+    if (result == OK)
+    {
+        radix_sort(header->start_address, scratch, header->size, counts);
+    }
+
+    if (owned)
+    {
+        free(scratch);
+    }
+    free(counts);
+
+    return result;
+}
+
+// One thread's share of a parallel radix pass: it counts the digits in its
+// slice, then scatters the slice to the offsets the counts were turned into
+typedef struct
+{
+    const long *source;
+    long *target;
+    ptrdiff_t begin;
+    ptrdiff_t end;
+    int shift;
+    int bits;
+    ptrdiff_t counts[1 << MAX_DIGIT_BITS];
+} radix_slice;
+
+static void *count_slice(void *argument)
+{
+    radix_slice *slice = argument;
+
+    memset(slice->counts, 0, sizeof(slice->counts));
+    for (ptrdiff_t i = slice->begin; i < slice->end; ++i)
+    {
+        ++slice->counts[get_digit(slice->source[i], slice->shift, slice->bits)];
+    }
+
+    return NULL;
+}
+
+static void *scatter_slice(void *argument)
+{
+    radix_slice *slice = argument;
+
+    for (ptrdiff_t i = slice->begin; i < slice->end; ++i)
+    {
+        slice->target[slice->counts[get_digit(slice->source[i], slice->shift, slice->bits)]++] = slice->source[i];
+    }
+
+    return NULL;
+}
+
+// Runs work on every slice, the first on the calling thread; a slice whose
+// thread can't be started runs there too
+static void run_slices(radix_slice *const slices, const int count, void *(*work)(void *))
+{
+    pthread_t threads[SORT_MAX_THREADS];
+    int started[SORT_MAX_THREADS] = {0};
+
+    for (int i = 1; i < count; ++i)
+    {
+        started[i] = pthread_create(&threads[i], NULL, work, &slices[i]) == 0;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (!started[i])
+        {
+            work(&slices[i]);
+        }
+    }
+
+    for (int i = 1; i < count; ++i)
+    {
+        if (started[i])
+        {
+            pthread_join(threads[i], NULL);
+        }
+    }
+}
+
+// Elements with the same digit go to the target in slice order, so each pass
+// stays stable and LSD order holds across passes
+static void parallel_radix_sort(long *const values, long *const scratch, const ptrdiff_t count,
+                                radix_slice *const slices, const int slice_count)
+{
+    int bits = get_digit_bits(count);
+    ptrdiff_t radix = (ptrdiff_t)1 << bits;
+    long *source = values;
+    long *target = scratch;
+
+    for (int shift = 0; shift < 64; shift += bits)
+    {
+        for (int i = 0; i < slice_count; ++i)
+        {
+            slices[i].source = source;
+            slices[i].target = target;
+            slices[i].begin = count * i / slice_count;
+            slices[i].end = count * (i + 1) / slice_count;
+            slices[i].shift = shift;
+            slices[i].bits = bits;
+        }
+
+        run_slices(slices, slice_count, count_slice);
+
+        // one digit holding every element makes this pass a plain copy
+        unsigned first_digit = get_digit(source[0], shift, bits);
+        ptrdiff_t same = 0;
+        for (int i = 0; i < slice_count; ++i)
+        {
+            same += slices[i].counts[first_digit];
+        }
+
+        if (same == count)
+        {
+            continue;
+        }
+
+        for (ptrdiff_t digit = 0, total = 0; digit < radix; ++digit)
+        {
+            for (int i = 0; i < slice_count; ++i)
+            {
+                ptrdiff_t digit_count = slices[i].counts[digit];
+                slices[i].counts[digit] = total;
+                total += digit_count;
+            }
+        }
+
+        run_slices(slices, slice_count, scatter_slice);
+
+        long *swap = source;
+        source = target;
+        target = swap;
+    }
+
+    if (source != values)
+    {
+        memcpy(values, source, count * sizeof(long));
+    }
+}
+
+operation_result vector_sort_parallel(vector_header *const header, const int threads)
+{
+    operation_result result = check(header);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    if (threads < 1 || threads > SORT_MAX_THREADS)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    if (threads == 1 || header->size < PARALLEL_SORT_MIN_SIZE)
+    {
+        return vector_sort(header);
+    }
+
+    result = vector_prepare_write(header, 0, header->size);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    radix_slice *slices = malloc(threads * sizeof(radix_slice));
+    if (slices == NULL)
+    {
+        return ERR_MALLOC_FAILED;
+    }
+
+    long *scratch;
+    int owned;
+    result = get_scratch(header, &scratch, &owned);
+
+    if (result == OK)
+    {
+        parallel_radix_sort(header->start_address, scratch, header->size, slices, threads);
+    }
+
+    if (owned)
+    {
+        free(scratch);
+    }
+    free(slices);
+
+    return result;
+}
@@ -0,0 +1,168 @@
+#include <stddef.h>
+#include "../include/sorted_vector/operations.h"
+#include "../include/vector/operations.h"
+
+static operation_result check(const vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return header->is_allocated ? OK : ERR_INVALID_HEADER;
+}
+
+// Branchless binary search: the loop runs log2(size) times whatever the keys,
+// and the comparison becomes a conditional move instead of a mispredicted jump.
+// With inclusive set, finds the first element greater than key instead of the
+// first one not less than it.
+static ptrdiff_t search(const vector_header *const header, const long key, const int inclusive)
+{
+    const long *base = header->start_address;
+    ptrdiff_t length = header->size;
+
+    if (length == 0)
+    {
+        return 0;
+    }
+
+    while (length > 1)
+    {
+        ptrdiff_t half = length / 2;
+        long probe = base[half];
+
+        base += (inclusive ? probe <= key : probe < key) ? half : 0;
+        length -= half;
+    }
+
+    return (base - header->start_address) + (inclusive ? *base <= key : *base < key);
+}
+
+operation_result sorted_lower_bound(const vector_header *const header, const long key, ptrdiff_t *const index)
+{
+    operation_result result = check(header);
+    if (result != OK || index == NULL)
+    {
+        return result != OK ? result : ERR_NULL;
+    }
+
+    *index = search(header, key, 0);
+    return OK;
+}
+
+operation_result sorted_upper_bound(const vector_header *const header, const long key, ptrdiff_t *const index)
+{
+    operation_result result = check(header);
+    if (result != OK || index == NULL)
+    {
+        return result != OK ? result : ERR_NULL;
+    }
+
+    *index = search(header, key, 1);
+    return OK;
+}
+
+operation_result sorted_contains(const vector_header *const header, const long key, int *const found)
+{
+    ptrdiff_t index;
+    operation_result result = sorted_lower_bound(header, key, &index);
+    if (result != OK || found == NULL)
+    {
+        return result != OK ? result : ERR_NULL;
+    }
+
+    *found = index < header->size && header->start_address[index] == key;
+    return OK;
+}
+
+operation_result sorted_insert(vector_header *const header, const long key)
+{
+    ptrdiff_t index;
+    operation_result result = sorted_upper_bound(header, key, &index);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    return insert(header, index, key);
+}
+
+operation_result sorted_erase(vector_header *const header, const long key, ptrdiff_t *const erased)
+{
+    ptrdiff_t first, last;
+    operation_result result = sorted_lower_bound(header, key, &first);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    sorted_upper_bound(header, key, &last);
+
+    if (erased != NULL)
+    {
+        *erased = last - first;
+    }
+
+    return first == last ? OK : erase_range(header, first, last - first);
+}
+
+operation_result sorted_merge_insert(vector_header *const header, const long *const keys, const ptrdiff_t count)
+{
+    operation_result result = check(header);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    if (keys == NULL && count > 0)
+    {
+        return ERR_NULL;
+    }
+
+    if (count < 0)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    if (count == 0)
+    {
+        return OK;
+    }
+
+    ptrdiff_t old_size = header->size;
+    // nothing before the first key's position moves
+    ptrdiff_t first_moved = search(header, keys[0], 1);
+
+    // one growth for the whole batch; the filler is overwritten below
+    result = push_back_n(header, count, 0);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    result = vector_prepare_write(header, first_moved, old_size - first_moved);
+    if (result != OK)
+    {
+        erase_range(header, old_size, count);
+        return result;
+    }
+
+    // fill from the back, so no existing element is overwritten before it moves
+    long *values = header->start_address;
+    ptrdiff_t i = old_size - 1;
+    ptrdiff_t j = count - 1;
+
+    for (ptrdiff_t k = old_size + count - 1; j >= 0; --k)
+    {
+        if (i >= 0 && values[i] > keys[j])
+        {
+            values[k] = values[i--];
+        }
+        else
+        {
+            values[k] = keys[j--];
+        }
+    }
+
+    return OK;
+}
@@ -0,0 +1,126 @@
+#include <stddef.h>
+#include "../include/span/header.h"
+#include "../include/span/operations.h"
+
+static void reset(vector_cursor *const cursor)
+{
+    cursor->span = 0;
+    cursor->offset = 0;
+}
+
+operation_result vector_get_spans(const vector_header *const header, vector_span spans[MAX_SPANS], int *const count)
+{
+    if (header == NULL || spans == NULL || count == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (!header->is_allocated)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    spans[0] = (vector_span){header->start_address, header->size};
+    *count = header->size > 0;
+
+    return OK;
+}
+
+// current_vector holds every element in one run even mid-migration; the
+// migrated prefix in next_vector is only a copy, so one span covers it all
+operation_result deamortized_get_spans(const deamortized_vector_header *const header, vector_span spans[MAX_SPANS], int *const count)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return vector_get_spans(&header->current_vector, spans, count);
+}
+
+// The current ring holds every element, as with the deamortized vector
+operation_result deque_get_spans(const deque_header *const header, vector_span spans[MAX_SPANS], int *const count)
+{
+    if (header == NULL || spans == NULL || count == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (!header->is_allocated)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    const deque_ring *ring = &header->current;
+    int first = ring->capacity - ring->head < header->size ? ring->capacity - ring->head : header->size;
+
+    spans[0] = (vector_span){ring->start_address + ring->head, first};
+    spans[1] = (vector_span){ring->start_address, header->size - first};
+    *count = header->size == 0 ? 0 : header->size == first ? 1 : 2;
+
+    return OK;
+}
+
+operation_result init_vector_cursor(vector_cursor *const cursor, const vector_header *const header)
+{
+    if (cursor == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    reset(cursor);
+    cursor->span_count = 0;
+
+    return vector_get_spans(header, cursor->spans, &cursor->span_count);
+}
+
+operation_result init_deamortized_cursor(vector_cursor *const cursor, const deamortized_vector_header *const header)
+{
+    if (cursor == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    reset(cursor);
+    cursor->span_count = 0;
+
+    return deamortized_get_spans(header, cursor->spans, &cursor->span_count);
+}
+
+operation_result init_deque_cursor(vector_cursor *const cursor, const deque_header *const header)
+{
+    if (cursor == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    reset(cursor);
+    cursor->span_count = 0;
+
+    return deque_get_spans(header, cursor->spans, &cursor->span_count);
+}
+
+int cursor_next_span(vector_cursor *const cursor, vector_span *const span)
+{
+    if (cursor == NULL || span == NULL)
+    {
+        return 0;
+    }
+
+    while (cursor->span < cursor->span_count)
+    {
+        const vector_span *current = &cursor->spans[cursor->span];
+        ptrdiff_t offset = cursor->offset;
+
+        cursor->span++;
+        cursor->offset = 0;
+
+        if (offset < current->length)
+        {
+            *span = (vector_span){current->start_address + offset, current->length - offset};
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,236 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <time.h>
+#include "../include/stats/header.h"
+#include "../include/stats/operations.h"
+
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static vector_stats *registry = NULL;
+
+static const char *get_name(const vector_stats *const stats)
+{
+    return stats->name == NULL ? "(unnamed)" : stats->name;
+}
+
+// Percent of the elements already in next_vector
+static double get_migration_ratio(const vector_stats *const stats)
+{
+    return stats->size == 0 ? 0.0 : 100.0 * (double)stats->migrated / (double)stats->size;
+}
+
+static void dump_text(FILE *const stream, const vector_stats *const stats)
+{
+    fprintf(stream,
+            "%s: grows=%llu shrinks=%llu swaps=%llu bytes_shifted=%llu bytes_migrated=%llu "
+            "peak_capacity=%llu allocator_calls=%llu allocator_ns=%llu migrated=%llu/%llu (%.1f%%)\n",
+            get_name(stats),
+            (unsigned long long)stats->grows,
+            (unsigned long long)stats->shrinks,
+            (unsigned long long)stats->swaps,
+            (unsigned long long)stats->bytes_shifted,
+            (unsigned long long)stats->bytes_migrated,
+            (unsigned long long)stats->peak_capacity,
+            (unsigned long long)stats->allocator_calls,
+            (unsigned long long)stats->allocator_ns,
+            (unsigned long long)stats->migrated,
+            (unsigned long long)stats->size,
+            get_migration_ratio(stats));
+}
+
+// Names are caller-chosen identifiers, so only quotes and backslashes are escaped
+static void dump_json(FILE *const stream, const vector_stats *const stats)
+{
+    fputs("{\"name\":\"", stream);
+    for (const char *c = get_name(stats); *c != '\0'; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            fputc('\\', stream);
+        }
+        fputc(*c, stream);
+    }
+
+    fprintf(stream,
+            "\",\"grows\":%llu,\"shrinks\":%llu,\"swaps\":%llu,\"bytes_shifted\":%llu,\"bytes_migrated\":%llu,"
+            "\"peak_capacity\":%llu,\"allocator_calls\":%llu,\"allocator_ns\":%llu,\"migrated\":%llu,\"size\":%llu,"
+            "\"migration_ratio\":%.4f}",
+            (unsigned long long)stats->grows,
+            (unsigned long long)stats->shrinks,
+            (unsigned long long)stats->swaps,
+            (unsigned long long)stats->bytes_shifted,
+            (unsigned long long)stats->bytes_migrated,
+            (unsigned long long)stats->peak_capacity,
+            (unsigned long long)stats->allocator_calls,
+            (unsigned long long)stats->allocator_ns,
+            (unsigned long long)stats->migrated,
+            (unsigned long long)stats->size,
+            get_migration_ratio(stats) / 100.0);
+}
+
+uint64_t stats_clock_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+operation_result vector_attach_stats(vector_header *const header, vector_stats *const stats)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (!header->is_allocated)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    header->stats = stats;
+    STATS_MAX(stats, peak_capacity, header->capacity);
+    STATS_SET(stats, size, header->size);
+
+    return OK;
+}
+
+operation_result deamortized_attach_stats(deamortized_vector_header *const header, vector_stats *const stats)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    operation_result result = vector_attach_stats(&header->current_vector, stats);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    // the unallocated next_vector keeps it too, for when migration allocates one
+    header->next_vector.stats = stats;
+    STATS_MAX(stats, peak_capacity, header->next_vector.capacity);
+    STATS_SET(stats, migrated, header->reallocated_amount);
+
+    return OK;
+}
+
+operation_result register_vector_stats(vector_stats *const stats, const char *const name)
+{
+    if (stats == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    pthread_mutex_lock(&registry_lock);
+
+    vector_stats **link = &registry;
+    while (*link != NULL && *link != stats)
+    {
+        link = &(*link)->next;
+    }
+
+    stats->name = name;
+    if (*link == NULL)
+    {
+        stats->next = NULL;
+        *link = stats;
+    }
+
+    pthread_mutex_unlock(&registry_lock);
+
+    return OK;
+}
+
+operation_result unregister_vector_stats(vector_stats *const stats)
+{
+    if (stats == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    pthread_mutex_lock(&registry_lock);
+
+    vector_stats **link = &registry;
+    while (*link != NULL && *link != stats)
+    {
+        link = &(*link)->next;
+    }
+
+    int found = *link != NULL;
+    if (found)
+    {
+        *link = stats->next;
+        stats->next = NULL;
+    }
+
+    pthread_mutex_unlock(&registry_lock);
+
+    return found ? OK : ERR_OUT_OF_BOUNDS;
+}
+
+operation_result reset_vector_stats(vector_stats *const stats)
+{
+    if (stats == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    // under the lock, as the registry may be walking through next
+    pthread_mutex_lock(&registry_lock);
+
+    const char *name = stats->name;
+    vector_stats *next = stats->next;
+
+    *stats = (vector_stats){0};
+    stats->name = name;
+    stats->next = next;
+    pthread_mutex_unlock(&registry_lock);
+
+    return OK;
+}
+
+// Counters are read without synchronizing with the containers, so dumping
+// while another thread is using one gives a slightly stale snapshot
+operation_result dump_vector_stats(FILE *const stream, const stats_format format)
+{
+    if (stream == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (format != STATS_TEXT && format != STATS_JSON)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    pthread_mutex_lock(&registry_lock);
+
+    if (format == STATS_JSON)
+    {
+        fputc('[', stream);
+    }
+
+    for (const vector_stats *stats = registry; stats != NULL; stats = stats->next)
+    {
+        if (format == STATS_JSON)
+        {
+            dump_json(stream, stats);
+            fputs(stats->next != NULL ? "," : "", stream);
+        }
+        else
+        {
+            dump_text(stream, stats);
+        }
+    }
+
+    if (format == STATS_JSON)
+    {
+        fputs("]\n", stream);
+    }
+
+    pthread_mutex_unlock(&registry_lock);
+
+    return ferror(stream) ? ERR_IO : OK;
+}
@@ -0,0 +1,385 @@
+#include <malloc.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "../include/tiered_vector/header.h"
+#include "../include/tiered_vector/operations.h"
+
+#define MIN_BLOCK_SLOTS 4
+
+static int is_invalid(const tiered_vector_header *const header)
+{
+    return !header->is_allocated;
+}
+
+static int get_mask(const tiered_vector_header *const header)
+{
+    return (1 << header->block_shift) - 1;
+}
+
+static long *get_address(const tiered_vector_header *const header, const int index)
+{
+    int mask = get_mask(header);
+    const tiered_block *block = &header->blocks[index >> header->block_shift];
+
+    return block->start_address + ((block->head + (index & mask)) & mask);
+}
+
+// Smallest block size whose square covers capacity
+static int get_block_shift(const long capacity)
+{
+    int shift = MIN_BLOCK_SHIFT;
+    while ((1L << (2 * shift)) < capacity)
+    {
+        shift++;
+    }
+
+    return shift;
+}
+
+static operation_result add_block(tiered_vector_header *const header)
+{
+    if (header->block_count == header->block_slots)
+    {
+        int new_slots = header->block_slots * 2;
+        tiered_block *new_blocks = realloc(header->blocks, new_slots * sizeof(tiered_block));
+
+        if (new_blocks == NULL)
+        {
+            return ERR_REALLOC_FAILED;
+        }
+
+        header->blocks = new_blocks;
+        header->block_slots = new_slots;
+    }
+
+    long *start_address = malloc((1L << header->block_shift) * sizeof(long));
+
+    if (start_address == NULL)
+    {
+        return ERR_MALLOC_FAILED;
+    }
+
+    header->blocks[header->block_count++] = (tiered_block){start_address, 0};
+    return OK;
+}
+
+static void free_blocks(tiered_vector_header *const header)
+{
+    for (int i = 0; i < header->block_count; ++i)
+    {
+        free(header->blocks[i].start_address);
+    }
+
+    free(header->blocks);
+}
+
+static tiered_vector_header create(const int block_shift, const int block_count)
+{
+    int block_slots = block_count < MIN_BLOCK_SLOTS ? MIN_BLOCK_SLOTS : block_count;
+    tiered_vector_header header = {
+        true,
+        malloc(block_slots * sizeof(tiered_block)),
+        0,
+        block_slots,
+        block_shift,
+        0};
+
+    if (header.blocks == NULL)
+    {
+        return (tiered_vector_header){false, NULL, 0, 0, 0, 0};
+    }
+
+    for (int i = 0; i < block_count; ++i)
+    {
+        if (add_block(&header) != OK)
+        {
+            free_blocks(&header);
+            return (tiered_vector_header){false, NULL, 0, 0, 0, 0};
+        }
+    }
+
+    return header;
+}
+
+// Moves every element into blocks of 2^block_shift. O(n), but only happens
+// when size has moved by a constant factor since the last rebuild.
+static operation_result rebuild(tiered_vector_header *const header, const int block_shift)
+{
+    int block_count = (header->size + (1 << block_shift) - 1) >> block_shift;
+    tiered_vector_header rebuilt = create(block_shift, block_count > 0 ? block_count : 1);
+
+    if (!rebuilt.is_allocated)
+    {
+        return ERR_MALLOC_FAILED;
+    }
+
+    for (int i = 0; i < header->size; ++i)
+    {
+        *get_address(&rebuilt, i) = *get_address(header, i);
+    }
+
+    rebuilt.size = header->size;
+
+    free_blocks(header);
+    *header = rebuilt;
+
+    return OK;
+}
+
+// Opens a slot at position in a block holding count elements, shifting
+// whichever side of it is shorter
+static void insert_into_block(tiered_block *const block, const int mask, const int count, const int position, const long value)
+{
+    long *data = block->start_address;
+
+    if (position < count / 2)
+    {
+        block->head = (block->head - 1) & mask;
+        for (int i = 0; i < position; ++i)
+        {
+            data[(block->head + i) & mask] = data[(block->head + i + 1) & mask];
+        }
+    }
+    else
+    {
+        for (int i = count; i > position; --i)
+        {
+            data[(block->head + i) & mask] = data[(block->head + i - 1) & mask];
+        }
+    }
+
+    data[(block->head + position) & mask] = value;
+}
+
+static void erase_from_block(tiered_block *const block, const int mask, const int count, const int position)
+{
+    long *data = block->start_address;
+
+    if (position < count / 2)
+    {
+        for (int i = position; i > 0; --i)
+        {
+            data[(block->head + i) & mask] = data[(block->head + i - 1) & mask];
+        }
+        block->head = (block->head + 1) & mask;
+    }
+    else
+    {
+        for (int i = position; i < count - 1; ++i)
+        {
+            data[(block->head + i) & mask] = data[(block->head + i + 1) & mask];
+        }
+    }
+}
+
+tiered_vector_header init_tiered_vector(const int capacity)
+{
+    if (capacity <= 0)
+    {
+        return (tiered_vector_header){false, NULL, 0, 0, 0, 0};
+    }
+
+    int block_shift = get_block_shift(capacity);
+
+    return create(block_shift, (capacity + (1 << block_shift) - 1) >> block_shift);
+}
+
+operation_result free_tiered_vector(tiered_vector_header *header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    free_blocks(header);
+    header->is_allocated = 0;
+
+    return OK;
+}
+
+long tiered_get(const tiered_vector_header *header, int index)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (index < 0 || index >= header->size)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    return *get_address(header, index);
+}
+
+operation_result tiered_set(tiered_vector_header *const header, const int index, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (index < 0 || index >= header->size)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    *get_address(header, index) = value;
+    return OK;
+}
+
+operation_result tiered_insert(tiered_vector_header *const header, const int index, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (index < 0 || index > header->size)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    operation_result result;
+
+    // keep the block count within twice the block size
+    if (header->size >= 2L << (2 * header->block_shift))
+    {
+        result = rebuild(header, header->block_shift + 1);
+        if (result != OK)
+        {
+            return result;
+        }
+    }
+
+    if (header->size == header->block_count << header->block_shift)
+    {
+        result = add_block(header);
+        if (result != OK)
+        {
+            return result;
+        }
+    }
+
+    int mask = get_mask(header);
+    int last = header->size >> header->block_shift;
+    int block_index = index >> header->block_shift;
+
+    // ripple one element forward through every later block, O(1) per block
+    for (int i = last; i > block_index; --i)
+    {
+        tiered_block *previous = &header->blocks[i - 1];
+        tiered_block *block = &header->blocks[i];
+
+        block->head = (block->head - 1) & mask;
+        block->start_address[block->head] = previous->start_address[(previous->head + mask) & mask];
+    }
+
+    int count = block_index == last ? header->size - (last << header->block_shift) : mask;
+    insert_into_block(&header->blocks[block_index], mask, count, index & mask, value);
+
+    header->size++;
+    return OK;
+}
+
+operation_result tiered_push_back(tiered_vector_header *const header, const long value)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return tiered_insert(header, header->size, value);
+}
+
+operation_result tiered_erase(tiered_vector_header *const header, const int index)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (is_invalid(header))
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (index < 0 || index >= header->size)
+    {
+        return ERR_OUT_OF_BOUNDS;
+    }
+
+    int mask = get_mask(header);
+    int last = (header->size - 1) >> header->block_shift;
+    int block_index = index >> header->block_shift;
+    int count = block_index == last ? header->size - (last << header->block_shift) : mask + 1;
+
+    erase_from_block(&header->blocks[block_index], mask, count, index & mask);
+
+    // ripple one element back through every later block
+    for (int i = block_index + 1; i <= last; ++i)
+    {
+        tiered_block *previous = &header->blocks[i - 1];
+        tiered_block *block = &header->blocks[i];
+
+        previous->start_address[(previous->head + mask) & mask] = block->start_address[block->head];
+        block->head = (block->head + 1) & mask;
+    }
+
+    header->size--;
+
+    // keep one spare block so push/pop at a block boundary doesn't thrash malloc
+    int used_blocks = (header->size + mask) >> header->block_shift;
+    if (header->block_count > used_blocks + 1)
+    {
+        free(header->blocks[--header->block_count].start_address);
+    }
+
+    // shrinking only saves memory, so a failed rebuild is not an error
+    if (header->block_shift > MIN_BLOCK_SHIFT && header->size < (1L << (2 * header->block_shift)) / 8)
+    {
+        rebuild(header, header->block_shift - 1);
+    }
+
+    return OK;
+}
+
+operation_result tiered_pop_back(tiered_vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return tiered_erase(header, header->size - 1);
+}
+
+int tiered_get_size(const tiered_vector_header *const header)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return header->size;
+}
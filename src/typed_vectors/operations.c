@@ -0,0 +1,8 @@
+#include "../include/typed_vectors.h"
+
+DEFINE_VECTOR(int32_vector, int32_t);
+DEFINE_VECTOR(float_vector, float);
+DEFINE_VECTOR(double_vector, double);
+
+DEFINE_DEAMORTIZED_VECTOR(int32_deamortized_vector, int32_t);
+DEFINE_DEAMORTIZED_VECTOR(double_deamortized_vector, double);
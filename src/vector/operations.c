@@ -1,219 +1,133 @@
-#include <malloc.h>
 #include <stddef.h>
-#include <stdbool.h>
 #include "../include/vector/header.h"
+#include "../include/vector/generic.h"
 #include "../include/vector/operations.h"
+#include "../include/batch/operations.h"
 
-static int get_capacity(const int capacity)
-{
-    return capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity;
-}
+DEFINE_VECTOR(vector, long);
 
-static long *get_address(const vector_header *const header, const int offset)
+vector_header init_vector(const ptrdiff_t capacity)
 {
-    return header->start_address + offset;
+    return vector_init(capacity);
 }
 
-static int is_invalid(const vector_header *const header)
+vector_header init_vector_with_allocator(const ptrdiff_t capacity, const vector_allocator *const allocator)
 {
-    return !header->is_allocated;
+    return vector_init_with_allocator(capacity, allocator);
 }
 
-static void invalidate(vector_header *const header)
+operation_result free_vector(vector_header *const header)
 {
-    header->is_allocated = 0;
+    return vector_free(header);
 }
 
-static operation_result grow_vector(vector_header *const header) {
-    if (header == NULL) {
-        return ERR_NULL;
-    }
-
-    if (is_invalid(header))
-    {
-        return ERR_INVALID_HEADER;
-    }
-
-    int new_capacity = header->capacity * 2;
-    long *new_start_address = realloc(header->start_address, new_capacity * sizeof(long));
-
-    if (new_start_address == NULL)
-    {
-        return ERR_REALLOC_FAILED;
-    }
-
-    header->start_address = new_start_address;
-    header->capacity = new_capacity;
+long get(const vector_header *const header, const ptrdiff_t index)
+{
+    long value;
+    operation_result result = vector_get(header, index, &value);
 
-    return OK;
+    return result == OK ? value : result;
 }
 
-operation_result free_vector(vector_header *const header)
+operation_result set(vector_header *const header, const ptrdiff_t index, const long value)
 {
-    if (header == NULL) {
-        return ERR_NULL;
-    }
-
-    if (is_invalid(header))
-    {
-        return ERR_INVALID_HEADER;
-    }
-
-    free(get_address(header, 0));
-    invalidate(header);
-
-    return OK;
+    return vector_set(header, index, value);
 }
 
-vector_header init_vector(const int capacity)
+operation_result insert(vector_header *const header, const ptrdiff_t index, const long value)
 {
-    if (capacity <= 0)
-    {
-        return (vector_header){
-            false,
-            NULL,
-            0,
-            0};
-    }
-
-    // FIXME: CHANGED 01.03
-    // Seems like it doesn't really affect the current impl, but I'm not sure...
-    int actual_capacity = get_capacity(capacity);
-
-    void *start_address = malloc(actual_capacity * sizeof(long));
-
-    if (start_address == NULL)
-    {
-        return (vector_header){
-            false,
-            NULL,
-            0,
-            0};
-    }
-
-    return (vector_header){
-        true,
-        start_address,
-        0,
-        actual_capacity};
+    return vector_insert(header, index, value);
 }
 
-long get(const vector_header *const header, const int index)
+operation_result push_back(vector_header *const header, const long value)
 {
-    if (header == NULL) {
-        return ERR_NULL;
-    }
-
-    if (is_invalid(header))
-    {
-        return ERR_INVALID_HEADER;
-    }
-
-    if (index < 0 || index >= header->size)
-    {
-        return ERR_OUT_OF_BOUNDS;
-    }
-
-    return *get_address(header, index);
+    return vector_push_back(header, value);
 }
 
-operation_result set(vector_header *const header, const int index, const long value)
+operation_result erase(vector_header *const header, const ptrdiff_t index)
 {
-    if (header == NULL) {
-        return ERR_NULL;
-    }
-
-    if (is_invalid(header))
-    {
-        return ERR_INVALID_HEADER;
-    }
-
-    if (index < 0 || index >= header->size)
-    {
-        return ERR_OUT_OF_BOUNDS;
-    }
-
-    *get_address(header, index) = value;
-    return OK;
+    return vector_erase(header, index);
 }
 
-operation_result insert(vector_header *const header, const int index, const long value)
+operation_result pop_back(vector_header *const header)
 {
-    if (header == NULL) {
-        return ERR_NULL;
-    }
+    return vector_pop_back(header);
+}
 
-    if (is_invalid(header))
-    {
-        return ERR_INVALID_HEADER;
-    }
+operation_result insert_range(vector_header *const header, const ptrdiff_t index, const long *values, const ptrdiff_t count)
+{
+    return vector_insert_range(header, index, values, count);
+}
 
-    // note: in this implementation, insert on vector size
-    // is considered as pushing the element back
-    if (index < 0 || index > header->size)
-    {
-        return ERR_OUT_OF_BOUNDS;
-    }
+operation_result erase_range(vector_header *const header, const ptrdiff_t index, const ptrdiff_t count)
+{
+    return vector_erase_range(header, index, count);
+}
 
-    if (header->capacity == header->size)
-    {
-        operation_result grow_result = grow_vector(header);
-        if (grow_result != OK)
-        {
-            return grow_result;
-        }
-    }
+operation_result push_back_n(vector_header *const header, const ptrdiff_t count, const long value)
+{
+    return vector_push_back_n(header, count, value);
+}
 
-    header->size++;
+operation_result append_array(vector_header *const header, const long *const values, const ptrdiff_t count)
+{
+    return vector_append_array(header, values, count);
+}
 
-    for (int i = header->size - 1; i > index; --i)
-    {
-        *get_address(header, i) = *get_address(header, i - 1);
-    }
+operation_result assign(vector_header *const header, const long *values, const ptrdiff_t count)
+{
+    return vector_assign(header, values, count);
+}
 
-    *get_address(header, index) = value;
-    return OK;
+operation_result reserve(vector_header *const header, const ptrdiff_t capacity)
+{
+    return vector_reserve(header, capacity);
 }
 
-operation_result push_back(vector_header *const header, const long value)
+operation_result resize(vector_header *const header, const ptrdiff_t size, const long value)
 {
-    if (header == NULL) {
-        return ERR_NULL;
-    }
+    return vector_resize(header, size, value);
+}
 
-    return insert(header, header->size, value);
+operation_result shrink_to_fit(vector_header *const header)
+{
+    return vector_shrink_to_fit(header);
 }
 
-operation_result erase(vector_header *const header, const int index)
+operation_result vector_apply_batch(vector_header *const header, const vector_edit *const edits, const ptrdiff_t count)
 {
     if (header == NULL) {
         return ERR_NULL;
     }
 
-    if (is_invalid(header))
+    if (vector_is_invalid(header))
     {
         return ERR_INVALID_HEADER;
     }
 
-    if (index < 0 || index >= header->size)
+    batch_plan plan;
+    operation_result result = plan_batch(edits, count, header->size, &plan);
+    if (result != OK)
     {
-        return ERR_OUT_OF_BOUNDS;
+        return result;
     }
 
-    for (int i = index; i < header->size - 1; ++i)
+    result = vector_reserve_for(header, plan.size);
+    if (result == OK)
     {
-        *get_address(header, i) = *get_address(header, i + 1);
+        result = vector_write_range(header, plan.first_changed, plan.size - plan.first_changed);
     }
 
-    --header->size;
-    return OK;
-}
+    if (result == OK)
+    {
+        ptrdiff_t moved = apply_batch_plan(vector_get_address(header, 0), &plan);
+        STATS_ADD(header->stats, bytes_shifted, moved * sizeof(long));
 
-operation_result pop_back(vector_header *const header)
-{
-    if (header == NULL) {
-        return ERR_NULL;
+        header->size = plan.size;
+        vector_shrink_if_sparse(header);
     }
 
-    return erase(header, header->size - 1);
+    free_batch_plan(&plan);
+
+    return result;
 }
@@ -0,0 +1,409 @@
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../include/vector_file/header.h"
+#include "../include/vector_file/operations.h"
+#include "../include/deamortized_vector/operations.h"
+
+#define HEADER_SIZE sizeof(vector_file_header)
+
+static uint64_t checksum(const long *const values, const size_t count)
+{
+    const unsigned char *bytes = (const unsigned char *)values;
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (size_t i = 0; i < count * sizeof(long); ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+static vector_file_header make_header(const long *const values, const ptrdiff_t size, const ptrdiff_t capacity)
+{
+    vector_file_header header = {
+        VECTOR_FILE_MAGIC,
+        VECTOR_FILE_VERSION,
+        VECTOR_FILE_LONG,
+        sizeof(long),
+        0,
+        (uint64_t)size,
+        (uint64_t)capacity,
+        checksum(values, size),
+        {0, 0}};
+
+    return header;
+}
+
+static vector_file_header *get_file_header(const vector_file *const file)
+{
+    return (vector_file_header *)file->mapping;
+}
+
+static long *get_elements(const vector_file *const file)
+{
+    return (long *)(file->mapping + HEADER_SIZE);
+}
+
+static int is_valid_header(const vector_file_header *const header, const size_t length)
+{
+    return memcmp(header->magic, VECTOR_FILE_MAGIC, sizeof(header->magic)) == 0 &&
+           header->version == VECTOR_FILE_VERSION &&
+           header->element_type == VECTOR_FILE_LONG &&
+           header->element_size == sizeof(long) &&
+           header->size <= header->capacity &&
+           header->capacity <= (uint64_t)MAX_CAPACITY &&
+           header->capacity <= (length - HEADER_SIZE) / sizeof(long);
+}
+
+// Makes a rename in path's directory durable
+static int sync_directory(const char *const path)
+{
+    char directory[4096];
+    if (snprintf(directory, sizeof(directory), "%s", path) >= (int)sizeof(directory))
+    {
+        return -1;
+    }
+
+    char *slash = strrchr(directory, '/');
+    if (slash == NULL)
+    {
+        strcpy(directory, ".");
+    }
+    else if (slash == directory)
+    {
+        directory[1] = '\0';
+    }
+    else
+    {
+        *slash = '\0';
+    }
+
+    int fd = open(directory, O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    int result = fsync(fd);
+    close(fd);
+
+    return result;
+}
+
+// Writes to a temporary file, syncs it and renames it over path, then syncs
+// the directory, so even a power loss never leaves a half-written vector behind
+static operation_result save_elements(const long *const values, const ptrdiff_t size, const char *const path)
+{
+    char temporary_path[4096];
+    if (snprintf(temporary_path, sizeof(temporary_path), "%s.tmp", path) >= (int)sizeof(temporary_path))
+    {
+        return ERR_IO;
+    }
+
+    FILE *stream = fopen(temporary_path, "wb");
+    if (stream == NULL)
+    {
+        return ERR_IO;
+    }
+
+    vector_file_header header = make_header(values, size, size);
+    int written = fwrite(&header, HEADER_SIZE, 1, stream) == 1 &&
+                  fwrite(values, sizeof(long), size, stream) == (size_t)size &&
+                  fflush(stream) == 0 &&
+                  fsync(fileno(stream)) == 0;
+
+    if (fclose(stream) != 0 || !written || rename(temporary_path, path) != 0)
+    {
+        remove(temporary_path);
+        return ERR_IO;
+    }
+
+    return sync_directory(path) == 0 ? OK : ERR_IO;
+}
+
+static void *file_allocate(void *context, size_t size)
+{
+    (void)context;
+    (void)size;
+
+    return NULL;
+}
+
+// Resizes the file and its mapping together; the elements stay right
+// behind the file header
+static void *file_reallocate(void *context, void *address, size_t old_size, size_t new_size)
+{
+    vector_file *file = context;
+    size_t length = HEADER_SIZE + new_size;
+    (void)address;
+    (void)old_size;
+
+    if (!file->writable)
+    {
+        return NULL;
+    }
+
+    if (length > file->length && ftruncate(file->fd, (off_t)length) != 0)
+    {
+        return NULL;
+    }
+
+    char *mapping = mremap(file->mapping, file->length, length, MREMAP_MAYMOVE);
+
+    if (mapping == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    // the old mapping is gone, so the new one has to be recorded whatever
+    // happens to the file below
+    size_t old_length = file->length;
+    file->mapping = mapping;
+    file->length = length;
+    get_file_header(file)->capacity = new_size / sizeof(long);
+
+    // a file that fails to shrink along only keeps unused bytes at its end
+    if (length < old_length)
+    {
+        int truncated = ftruncate(file->fd, (off_t)length);
+        (void)truncated;
+    }
+
+    return get_elements(file);
+}
+
+// The mapping belongs to the file and goes away in vector_close_file()
+static void file_release(void *context, void *address, size_t size)
+{
+    (void)context;
+    (void)address;
+    (void)size;
+}
+
+static operation_result map_file(vector_file *const file, vector_header *const header, const int fd, const int writable)
+{
+    struct stat status;
+    if (fstat(fd, &status) != 0)
+    {
+        close(fd);
+        return ERR_IO;
+    }
+
+    size_t length = (size_t)status.st_size;
+    if (length < HEADER_SIZE)
+    {
+        close(fd);
+        return ERR_INVALID_FILE;
+    }
+
+    // read-only files are mapped copy-on-write, so set() still works in memory
+    char *mapping = mmap(NULL, length, PROT_READ | PROT_WRITE, writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        close(fd);
+        return ERR_IO;
+    }
+
+    *file = (vector_file){
+        fd,
+        mapping,
+        length,
+        writable,
+        {file_allocate, file_reallocate, file_release, NULL, NULL}};
+    file->allocator.context = file;
+
+    if (!is_valid_header(get_file_header(file), length))
+    {
+        munmap(mapping, length);
+        close(fd);
+        file->mapping = NULL;
+        return ERR_INVALID_FILE;
+    }
+
+    *header = (vector_header){
+        true,
+        get_elements(file),
+        (ptrdiff_t)get_file_header(file)->size,
+        (ptrdiff_t)get_file_header(file)->capacity,
+        writable,
+        &file->allocator,
+        NULL};
+
+    return OK;
+}
+
+// A new file starts out as an empty vector of MIN_CAPACITY
+static int create_file(const char *const path)
+{
+    int fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0)
+    {
+        return fd;
+    }
+
+    vector_file_header header = make_header(NULL, 0, MIN_CAPACITY);
+
+    if (ftruncate(fd, (off_t)(HEADER_SIZE + MIN_CAPACITY * sizeof(long))) != 0 ||
+        pwrite(fd, &header, HEADER_SIZE, 0) != (ssize_t)HEADER_SIZE)
+    {
+        close(fd);
+        unlink(path);
+        return -1;
+    }
+
+    return fd;
+}
+
+operation_result vector_save(const vector_header *const header, const char *const path)
+{
+    if (header == NULL || path == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (!header->is_allocated)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    return save_elements(header->start_address, header->size, path);
+}
+
+operation_result vector_open_mmap(vector_file *const file, vector_header *const header, const char *const path)
+{
+    if (file == NULL || header == NULL || path == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return ERR_IO;
+    }
+
+    return map_file(file, header, fd, false);
+}
+
+operation_result vector_open_file(vector_file *const file, vector_header *const header, const char *const path)
+{
+    if (file == NULL || header == NULL || path == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    int fd = open(path, O_RDWR);
+    if (fd < 0)
+    {
+        fd = create_file(path);
+    }
+
+    if (fd < 0)
+    {
+        return ERR_IO;
+    }
+
+    return map_file(file, header, fd, true);
+}
+
+operation_result vector_sync_file(vector_file *const file, const vector_header *const header)
+{
+    if (file == NULL || header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (file->mapping == NULL || !header->is_allocated || header->allocator != &file->allocator)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    if (!file->writable)
+    {
+        return OK;
+    }
+
+    vector_file_header *file_header = get_file_header(file);
+    file_header->size = (uint64_t)header->size;
+    file_header->checksum = checksum(header->start_address, header->size);
+
+    return msync(file->mapping, file->length, MS_SYNC) == 0 ? OK : ERR_IO;
+}
+
+operation_result vector_close_file(vector_file *const file, vector_header *const header)
+{
+    operation_result result = vector_sync_file(file, header);
+    if (result == ERR_NULL || result == ERR_INVALID_HEADER)
+    {
+        return result;
+    }
+
+    munmap(file->mapping, file->length);
+    close(file->fd);
+
+    file->mapping = NULL;
+    file->length = 0;
+    *header = (vector_header){false, NULL, 0, 0, false, NULL, NULL};
+
+    return result;
+}
+
+// Reads every page, so it is kept out of the open path
+operation_result vector_verify_file(const vector_file *const file)
+{
+    if (file == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    if (file->mapping == NULL)
+    {
+        return ERR_INVALID_HEADER;
+    }
+
+    const vector_file_header *header = get_file_header(file);
+
+    return header->checksum == checksum(get_elements(file), header->size) ? OK : ERR_INVALID_FILE;
+}
+
+// current_vector always holds every element, whatever migration is doing
+operation_result deamortized_vector_save(const deamortized_vector_header *const header, const char *const path)
+{
+    if (header == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    return vector_save(&header->current_vector, path);
+}
+
+operation_result deamortized_vector_load(deamortized_vector_header *const header, const char *const path)
+{
+    if (header == NULL || path == NULL)
+    {
+        return ERR_NULL;
+    }
+
+    vector_file file;
+    vector_header contents;
+
+    operation_result result = vector_open_mmap(&file, &contents, path);
+    if (result != OK)
+    {
+        return result;
+    }
+
+    result = deamortized_assign(header, contents.start_address, contents.size);
+    vector_close_file(&file, &contents);
+
+    return result;
+}